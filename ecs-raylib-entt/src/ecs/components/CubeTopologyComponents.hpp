@@ -0,0 +1,115 @@
+#ifndef CUBE_TOPOLOGY_COMPONENTS_H
+#define CUBE_TOPOLOGY_COMPONENTS_H
+
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ECS {
+
+// One bit per cube face; face f has axis f / 2 (0=X, 1=Y, 2=Z) and points
+// towards -axis for even f and +axis for odd f
+enum Face : uint8_t {
+    FACE_NEG_X = 1 << 0,
+    FACE_POS_X = 1 << 1,
+    FACE_NEG_Y = 1 << 2,
+    FACE_POS_Y = 1 << 3,
+    FACE_NEG_Z = 1 << 4,
+    FACE_POS_Z = 1 << 5,
+};
+
+constexpr int FACE_COUNT = 6;
+constexpr uint8_t FACE_ALL = 0x3F;
+
+// Offset to the neighbour on the other side of each face
+constexpr int FACE_OFFSETS[FACE_COUNT][3] = {
+    { -1, 0, 0 }, { 1, 0, 0 },
+    { 0, -1, 0 }, { 0, 1, 0 },
+    { 0, 0, -1 }, { 0, 0, 1 },
+};
+
+// Number of faces set in a mask
+constexpr int CountFaces(uint8_t mask) {
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) ++count;
+    return count;
+}
+
+// Visible faces component - the faces of a block that touch air or the world
+// boundary. Only blocks with at least one such face carry it, so a view over
+// it is the shell of the world rather than every block.
+struct VisibleFaces {
+    uint8_t mask;
+    
+    VisibleFaces() : mask(0) {}
+    VisibleFaces(uint8_t m) : mask(m) {}
+    
+    int Count() const { return CountFaces(mask); }
+};
+
+// Block entity at every grid cell (entt::null for air), stored in the
+// registry context so systems can find a block's neighbours without a search
+struct BlockGrid {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    std::vector<entt::entity> cells;
+    
+    void Reset(int w, int h, int d) {
+        width = w;
+        height = h;
+        depth = d;
+        cells.assign(static_cast<size_t>(w) * h * d, entt::null);
+    }
+    
+    bool Contains(int x, int y, int z) const {
+        return x >= 0 && x < width && y >= 0 && y < height && z >= 0 && z < depth;
+    }
+    
+    size_t Index(int x, int y, int z) const {
+        return (static_cast<size_t>(y) * depth + z) * width + x;
+    }
+    
+    entt::entity At(int x, int y, int z) const {
+        return Contains(x, y, z) ? cells[Index(x, y, z)] : entt::entity{ entt::null };
+    }
+};
+
+// Shell blocks (those carrying VisibleFaces) bucketed by layer, stored in
+// the registry context next to the BlockGrid. Kept in step with
+// VisibleFaces by CubeTopologySystem so layer-restricted views only touch
+// the layers they show.
+struct ShellLayers {
+    std::vector<std::vector<entt::entity>> layers;
+    
+    void Reset(int height) {
+        layers.assign(static_cast<size_t>(height), {});
+    }
+    
+    void Add(int y, entt::entity entity) {
+        layers[y].push_back(entity);
+    }
+    
+    // Swap-remove; O(blocks in the layer)
+    void Remove(int y, entt::entity entity) {
+        std::vector<entt::entity>& layer = layers[y];
+        for (size_t i = 0; i < layer.size(); ++i) {
+            if (layer[i] == entity) {
+                layer[i] = layer.back();
+                layer.pop_back();
+                return;
+            }
+        }
+    }
+    
+    size_t Count() const {
+        size_t count = 0;
+        for (const auto& layer : layers) count += layer.size();
+        return count;
+    }
+};
+
+} // namespace ECS
+
+#endif // CUBE_TOPOLOGY_COMPONENTS_H
@@ -0,0 +1,63 @@
+#ifndef VOXEL_COMPONENTS_H
+#define VOXEL_COMPONENTS_H
+
+#include <cstdint>
+#include "CubeTopologyComponents.hpp"
+#include "../../world/World.hpp"
+
+namespace ECS {
+
+// Static terrain for the hybrid model: the World grid itself, stored in the
+// registry context in place of one entity per block. Systems read and write
+// blocks through it; only dynamic blocks (below) become entities.
+struct VoxelWorld {
+    World::World* world = nullptr;
+    
+    VoxelWorld() = default;
+    VoxelWorld(World::World* w) : world(w) {}
+    
+    bool Contains(int x, int y, int z) const {
+        return world->IsValidPosition(x, y, z);
+    }
+    
+    bool IsSolid(int x, int y, int z) const {
+        return Contains(x, y, z) && world->GetBlockType(x, y, z) != World::BlockType::Air;
+    }
+    
+    // Faces of the block at (x, y, z) that touch air or the world boundary
+    // (same rule as CubeTopologySystem uses for block entities)
+    uint8_t ExposedFaces(int x, int y, int z) const {
+        uint8_t mask = 0;
+        for (int f = 0; f < FACE_COUNT; ++f) {
+            if (!IsSolid(x + FACE_OFFSETS[f][0], y + FACE_OFFSETS[f][1], z + FACE_OFFSETS[f][2])) {
+                mask |= static_cast<uint8_t>(1 << f);
+            }
+        }
+        return mask;
+    }
+};
+
+// Tag for a block taken out of the VoxelWorld grid to be simulated as an
+// entity; its cell in the grid is air until it settles back
+struct DynamicBlock {};
+
+// Dynamic block falling under gravity; height is the centre of the block
+// in block units (Position.y is the cell it currently overlaps)
+struct Falling {
+    float height;
+    float velocity;
+    
+    Falling() : height(0.0f), velocity(0.0f) {}
+    Falling(float h) : height(h), velocity(0.0f) {}
+};
+
+// Dynamic block being mined; removed once progress reaches 1
+struct BeingMined {
+    float progress;
+    
+    BeingMined() : progress(0.0f) {}
+};
+
+} // namespace ECS
+
+#endif // VOXEL_COMPONENTS_H
@@ -10,7 +10,13 @@ namespace ECS {
 
 class CharacterSystem {
 public:
-    CharacterSystem() = default;
+    CharacterSystem() : worldMaxX(35.5f), worldMaxZ(35.5f) {}
+    
+    // Set the walkable area from the world size (blocks are 1.0 size)
+    void SetWorldBounds(int width, int depth) {
+        worldMaxX = width - 0.5f;
+        worldMaxZ = depth - 0.5f;
+    }
     
     entt::entity CreateCharacter(entt::registry& registry, const char* modelPath, Vector3 startPos) {
         std::cout << "Loading character model from: " << modelPath << std::endl;
@@ -142,14 +148,13 @@ public:
             transform.position.x += movement.velocity.x * deltaTime;
             transform.position.z += movement.velocity.z * deltaTime;
             
-            // Keep character within world bounds (36x36 world, blocks are 1.0 size)
+            // Keep character within world bounds (blocks are 1.0 size)
             const float worldMin = 0.5f;
-            const float worldMax = 35.5f;
             
             if (transform.position.x < worldMin) transform.position.x = worldMin;
-            if (transform.position.x > worldMax) transform.position.x = worldMax;
+            if (transform.position.x > worldMaxX) transform.position.x = worldMaxX;
             if (transform.position.z < worldMin) transform.position.z = worldMin;
-            if (transform.position.z > worldMax) transform.position.z = worldMax;
+            if (transform.position.z > worldMaxZ) transform.position.z = worldMaxZ;
         }
     }
     
@@ -223,6 +228,11 @@ public:
             std::cout << "Character unloaded." << std::endl;
         }
     }
+
+private:
+    // Largest walkable x/z coordinate
+    float worldMaxX;
+    float worldMaxZ;
 };
 
 } // namespace ECS
@@ -0,0 +1,145 @@
+#ifndef CHUNK_STREAMING_SYSTEM_H
+#define CHUNK_STREAMING_SYSTEM_H
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "../components/CharacterComponents.hpp"
+#include "../../world/World.hpp"
+#include "../../world/ChunkPipeline.hpp"
+
+namespace ECS {
+
+// Counters from one ChunkStreamingSystem update
+struct StreamingStats {
+    int loaded = 0;     // chunks generated this update
+    int requested = 0;  // chunks handed to the pipeline this update
+    int unloaded = 0;   // chunks dropped back to the generator
+    int pinned = 0;     // out-of-range chunks kept because they were edited
+    int pending = 0;    // in-range chunks left for later updates (budget, or in the pipeline)
+    int resident = 0;   // chunks resident after the update
+};
+
+// Keeps the chunks of a lazy world (World::GenerateLazily) resident around
+// the character: chunks within the load radius of the CharacterTag
+// entity's Transform are generated nearest first, at most loadBudget per
+// update so crossing into new terrain never stalls a frame, and resident
+// chunks beyond the unload radius are dropped back to the generator unless
+// they were edited. Radii are in chunks, per axis; the gap between them
+// keeps chunks on the border from being reloaded every step. With a
+// ChunkPipeline attached, missing chunks are requested from its workers
+// instead (the caller drains it). Eager worlds are left alone.
+class ChunkStreamingSystem {
+public:
+    ChunkStreamingSystem(int loadRadius = 2, int unloadRadius = 3, int loadBudget = 8)
+        : loadRadius(loadRadius), unloadRadius(std::max(unloadRadius, loadRadius)),
+          loadBudget(loadBudget) {}
+    
+    void SetRadius(int load, int unload) {
+        loadRadius = load;
+        unloadRadius = std::max(unload, load);
+    }
+    int GetLoadRadius() const { return loadRadius; }
+    int GetUnloadRadius() const { return unloadRadius; }
+    
+    // Chunks generated per update at most (<= 0: no limit)
+    void SetLoadBudget(int chunks) { loadBudget = chunks; }
+    
+    // Build chunks on the pipeline's workers rather than in Update
+    // (nullptr: generate synchronously)
+    void SetPipeline(World::ChunkPipeline* chunkPipeline) { pipeline = chunkPipeline; }
+    
+    // Stream around the character; false if there is none
+    bool Update(entt::registry& registry, World::World& world) {
+        auto view = registry.view<Transform, CharacterTag>();
+        for (auto entity : view) {
+            const Vector3& position = view.get<Transform>(entity).position;
+            StreamAround(world, static_cast<int>(std::floor(position.x + 0.5f)),
+                         static_cast<int>(std::floor(position.y + 0.5f)),
+                         static_cast<int>(std::floor(position.z + 0.5f)));
+            return true;
+        }
+        return false;
+    }
+    
+    // Stream around an explicit block position (e.g. a free camera)
+    void StreamAround(World::World& world, int x, int y, int z) {
+        stats = StreamingStats{};
+        if (!world.IsLazy()) {
+            stats.resident = static_cast<int>(world.GetChunkCount());
+            return;
+        }
+        World::ChunkCoord center = World::ChunkCoordOf(x, y, z);
+        
+        // Drop what is out of range
+        world.GetLoadedChunks(resident);
+        for (const World::ChunkCoord& coord : resident) {
+            if (Distance(coord, center) <= unloadRadius) continue;
+            if (world.UnloadChunk(coord)) {
+                ++stats.unloaded;
+            } else {
+                ++stats.pinned;
+            }
+        }
+        
+        // Missing chunks in range, nearest first
+        missing.clear();
+        for (int dy = -loadRadius; dy <= loadRadius; ++dy)
+            for (int dz = -loadRadius; dz <= loadRadius; ++dz)
+                for (int dx = -loadRadius; dx <= loadRadius; ++dx) {
+                    World::ChunkCoord coord = { center.x + dx, center.y + dy, center.z + dz };
+                    if (world.IsValidChunk(coord) && !world.GetChunk(coord) &&
+                        !(pipeline && pipeline->IsPending(coord))) {
+                        missing.push_back(coord);
+                    }
+                }
+        std::sort(missing.begin(), missing.end(), [&](const World::ChunkCoord& a, const World::ChunkCoord& b) {
+            return SquaredDistance(a, center) < SquaredDistance(b, center);
+        });
+        
+        if (pipeline) {
+            for (const World::ChunkCoord& coord : missing) {
+                stats.requested += pipeline->Request(coord) ? 1 : 0;
+            }
+            stats.pending = static_cast<int>(pipeline->GetStats().inFlight);
+            stats.resident = static_cast<int>(world.GetChunkCount());
+            return;
+        }
+        
+        size_t count = loadBudget > 0 ? std::min(missing.size(), static_cast<size_t>(loadBudget)) : missing.size();
+        for (size_t i = 0; i < count; ++i) {
+            world.LoadChunk(missing[i]);
+        }
+        stats.loaded = static_cast<int>(count);
+        stats.pending = static_cast<int>(missing.size() - count);
+        stats.resident = static_cast<int>(world.GetChunkCount());
+    }
+    
+    // Counters from the last update
+    const StreamingStats& GetStats() const { return stats; }
+
+private:
+    int loadRadius;
+    int unloadRadius;
+    int loadBudget;
+    World::ChunkPipeline* pipeline = nullptr;
+    StreamingStats stats;
+    std::vector<World::ChunkCoord> resident;
+    std::vector<World::ChunkCoord> missing;
+    
+    // Chebyshev distance in chunks
+    static int Distance(const World::ChunkCoord& a, const World::ChunkCoord& b) {
+        return std::max({ std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z) });
+    }
+    
+    static int SquaredDistance(const World::ChunkCoord& a, const World::ChunkCoord& b) {
+        int dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+};
+
+} // namespace ECS
+
+#endif // CHUNK_STREAMING_SYSTEM_H
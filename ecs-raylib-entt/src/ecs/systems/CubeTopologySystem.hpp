@@ -0,0 +1,152 @@
+#ifndef CUBE_TOPOLOGY_SYSTEM_H
+#define CUBE_TOPOLOGY_SYSTEM_H
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include "../components/CubeTopologyComponents.hpp"
+
+namespace ECS {
+
+// Works out which block faces can be seen. A face is visible when the cell
+// behind it is air or outside the world; occupancy comes from the BlockGrid
+// in the registry context (kept by WorldSystem). Blocks with any visible
+// face get a VisibleFaces component, buried blocks get none, and the
+// ShellLayers index in the context lists the former per layer.
+class CubeTopologySystem {
+public:
+    CubeTopologySystem() = default;
+    
+    // Faces of the block at (x, y, z) that touch air or the world boundary
+    static uint8_t ComputeVisibleFaces(const BlockGrid& grid, int x, int y, int z) {
+        uint8_t mask = 0;
+        for (int f = 0; f < FACE_COUNT; ++f) {
+            int nx = x + FACE_OFFSETS[f][0];
+            int ny = y + FACE_OFFSETS[f][1];
+            int nz = z + FACE_OFFSETS[f][2];
+            if (grid.At(nx, ny, nz) == entt::null) {
+                mask |= static_cast<uint8_t>(1 << f);
+            }
+        }
+        return mask;
+    }
+    
+    // Full pass over the grid: tag every block that has a visible face
+    void Build(entt::registry& registry) {
+        registry.clear<VisibleFaces>();
+        
+        const BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        if (!grid) return;
+        
+        ShellLayers shell;
+        shell.Reset(grid->height);
+        shellEntities.clear();
+        shellMasks.clear();
+        
+        for (int y = 0; y < grid->height; ++y) {
+            for (int z = 0; z < grid->depth; ++z) {
+                for (int x = 0; x < grid->width; ++x) {
+                    entt::entity entity = grid->cells[grid->Index(x, y, z)];
+                    if (entity == entt::null) continue;
+                    
+                    uint8_t mask = ComputeVisibleFaces(*grid, x, y, z);
+                    if (mask != 0) {
+                        shellEntities.push_back(entity);
+                        shellMasks.emplace_back(mask);
+                        shell.Add(y, entity);
+                    }
+                }
+            }
+        }
+        
+        // One range insert for the whole shell
+        registry.insert<VisibleFaces>(shellEntities.begin(), shellEntities.end(), shellMasks.begin());
+        registry.ctx().insert_or_assign(std::move(shell));
+    }
+    
+    // Incremental update after the cell at (x, y, z) changed: only that
+    // block and its six neighbours can gain or lose visible faces
+    void UpdateAround(entt::registry& registry, int x, int y, int z) {
+        const BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        ShellLayers* shell = registry.ctx().find<ShellLayers>();
+        if (!grid || !shell) return;
+        
+        Refresh(registry, *grid, *shell, x, y, z);
+        for (int f = 0; f < FACE_COUNT; ++f) {
+            Refresh(registry, *grid, *shell, x + FACE_OFFSETS[f][0], y + FACE_OFFSETS[f][1],
+                    z + FACE_OFFSETS[f][2]);
+        }
+    }
+    
+    // Incremental update after the cells of a box [x0, x1) x [y0, y1) x
+    // [z0, z1) changed (e.g. a chunk was populated): the blocks in the box
+    // and the ones bordering it
+    void UpdateBox(entt::registry& registry, int x0, int y0, int z0, int x1, int y1, int z1) {
+        const BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        ShellLayers* shell = registry.ctx().find<ShellLayers>();
+        if (!grid || !shell) return;
+        
+        x0 = std::max(x0 - 1, 0);
+        y0 = std::max(y0 - 1, 0);
+        z0 = std::max(z0 - 1, 0);
+        x1 = std::min(x1 + 1, grid->width);
+        y1 = std::min(y1 + 1, grid->height);
+        z1 = std::min(z1 + 1, grid->depth);
+        for (int y = y0; y < y1; ++y) {
+            for (int z = z0; z < z1; ++z) {
+                for (int x = x0; x < x1; ++x) {
+                    Refresh(registry, *grid, *shell, x, y, z);
+                }
+            }
+        }
+    }
+    
+    // Drop a block that is about to be destroyed from the shell index
+    // (call before destroying the entity at layer y)
+    void RemoveBlock(entt::registry& registry, entt::entity entity, int y) {
+        ShellLayers* shell = registry.ctx().find<ShellLayers>();
+        if (shell && registry.all_of<VisibleFaces>(entity)) {
+            shell->Remove(y, entity);
+        }
+    }
+    
+    // Blocks with at least one visible face
+    size_t GetVisibleBlockCount(entt::registry& registry) {
+        return registry.view<VisibleFaces>().size();
+    }
+    
+    // Total visible faces over all blocks
+    size_t GetVisibleFaceCount(entt::registry& registry) {
+        size_t faces = 0;
+        registry.view<VisibleFaces>().each([&faces](auto& visible) {
+            faces += visible.Count();
+        });
+        return faces;
+    }
+
+private:
+    // Shell gathered by Build before the range insert (capacity reused)
+    std::vector<entt::entity> shellEntities;
+    std::vector<VisibleFaces> shellMasks;
+    
+    // Recompute one block's VisibleFaces, adding or removing the component
+    // and its ShellLayers entry
+    static void Refresh(entt::registry& registry, const BlockGrid& grid, ShellLayers& shell,
+                        int x, int y, int z) {
+        entt::entity entity = grid.At(x, y, z);
+        if (entity == entt::null) return;
+        
+        uint8_t mask = ComputeVisibleFaces(grid, x, y, z);
+        bool wasShell = registry.all_of<VisibleFaces>(entity);
+        if (mask != 0) {
+            registry.emplace_or_replace<VisibleFaces>(entity, mask);
+            if (!wasShell) shell.Add(y, entity);
+        } else if (wasShell) {
+            registry.remove<VisibleFaces>(entity);
+            shell.Remove(y, entity);
+        }
+    }
+};
+
+} // namespace ECS
+
+#endif // CUBE_TOPOLOGY_SYSTEM_H
@@ -0,0 +1,143 @@
+#ifndef INSTANCE_BUFFER_SYSTEM_H
+#define INSTANCE_BUFFER_SYSTEM_H
+
+#include <entt/entt.hpp>
+#include <raylib.h>
+#include <raymath.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include "../components/Components.hpp"
+#include "../components/CubeTopologyComponents.hpp"
+#include "../../world/Chunk.hpp"
+
+namespace ECS {
+
+// Instances [first, first + count) all belong to one chunk
+struct InstanceChunkRange {
+    World::ChunkCoord coord;
+    uint32_t first;
+    uint32_t count;
+};
+
+// Per-instance data for drawing every block with one cube mesh: a model
+// transform and a color per instance, in the same order. Instances are
+// grouped by chunk so culling can pick whole runs.
+struct BlockInstanceBuffer {
+    std::vector<Matrix> transforms;
+    std::vector<Color> colors;
+    std::vector<InstanceChunkRange> chunks;
+    
+    size_t Size() const { return transforms.size(); }
+    bool IsEmpty() const { return transforms.empty(); }
+    
+    void Clear() {
+        transforms.clear();
+        colors.clear();
+        chunks.clear();
+    }
+};
+
+// Keeps the CPU-side instance buffers for instanced block rendering. It
+// listens to the registry and rebuilds only after Position, BlockData,
+// Renderable or VisibleFaces were constructed, updated (patch/replace) or
+// destroyed. Pure CPU; needs no GPU context.
+class InstanceBufferSystem {
+public:
+    InstanceBufferSystem() : dirty(true), rebuildCount(0) {}
+    
+    // Listeners point at this object, so it must not be copied or moved
+    InstanceBufferSystem(const InstanceBufferSystem&) = delete;
+    InstanceBufferSystem& operator=(const InstanceBufferSystem&) = delete;
+    
+    // Start watching a registry (drops any previous one)
+    void Connect(entt::registry& registry) {
+        Disconnect();
+        Watch<Position>(registry);
+        Watch<BlockData>(registry);
+        Watch<Renderable>(registry);
+        Watch<VisibleFaces>(registry);
+        watched = &registry;
+        dirty = true;
+    }
+    
+    void Disconnect() {
+        connections.clear();
+        watched = nullptr;
+    }
+    
+    bool IsConnected(const entt::registry& registry) const { return watched == &registry; }
+    
+    bool IsDirty() const { return dirty; }
+    void MarkDirty() { dirty = true; }
+    
+    // Rebuild the buffers if something changed since the last build.
+    // Returns true if they were rebuilt.
+    bool Update(entt::registry& registry, float blockSize) {
+        if (!dirty) return false;
+        Build(registry, blockSize, buffer);
+        dirty = false;
+        ++rebuildCount;
+        return true;
+    }
+    
+    const BlockInstanceBuffer& GetBuffer() const { return buffer; }
+    
+    // Number of rebuilds so far (to check that unchanged frames cost nothing)
+    size_t GetRebuildCount() const { return rebuildCount; }
+    
+    // Fill out with one instance per visible block that has a visible face,
+    // grouped by chunk; buried blocks can never be seen and are left out
+    static void Build(entt::registry& registry, float blockSize, BlockInstanceBuffer& out) {
+        out.Clear();
+        
+        auto view = registry.view<Position, BlockData, Renderable, VisibleFaces>();
+        
+        // Order by chunk (y, z, x) so each chunk is one contiguous run
+        std::vector<std::pair<World::ChunkCoord, entt::entity>> order;
+        order.reserve(view.size_hint());
+        for (auto entity : view) {
+            if (!view.get<Renderable>(entity).visible) continue;
+            const Position& pos = view.get<Position>(entity);
+            order.emplace_back(World::ChunkCoordOf(pos.x, pos.y, pos.z), entity);
+        }
+        std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+            return std::tie(a.first.y, a.first.z, a.first.x) < std::tie(b.first.y, b.first.z, b.first.x);
+        });
+        
+        out.transforms.reserve(order.size());
+        out.colors.reserve(order.size());
+        for (const auto& [coord, entity] : order) {
+            if (out.chunks.empty() || out.chunks.back().coord != coord) {
+                out.chunks.push_back({ coord, static_cast<uint32_t>(out.transforms.size()), 0 });
+            }
+            out.chunks.back().count++;
+            
+            const Position& pos = view.get<Position>(entity);
+            out.transforms.push_back(MatrixTranslate(pos.x * blockSize, pos.y * blockSize, pos.z * blockSize));
+            out.colors.push_back(view.get<BlockData>(entity).color);
+        }
+    }
+
+private:
+    BlockInstanceBuffer buffer;
+    bool dirty;
+    size_t rebuildCount;
+    entt::registry* watched = nullptr;
+    std::vector<entt::scoped_connection> connections;
+    
+    void OnChange(entt::registry&, entt::entity) {
+        dirty = true;
+    }
+    
+    template <typename Component>
+    void Watch(entt::registry& registry) {
+        connections.emplace_back(registry.on_construct<Component>().template connect<&InstanceBufferSystem::OnChange>(*this));
+        connections.emplace_back(registry.on_update<Component>().template connect<&InstanceBufferSystem::OnChange>(*this));
+        connections.emplace_back(registry.on_destroy<Component>().template connect<&InstanceBufferSystem::OnChange>(*this));
+    }
+};
+
+} // namespace ECS
+
+#endif // INSTANCE_BUFFER_SYSTEM_H
@@ -3,152 +3,201 @@
 
 #include <entt/entt.hpp>
 #include <raylib.h>
+#include <raymath.h>
+#include <rlgl.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 #include "../components/Components.hpp"
+#include "../components/CubeTopologyComponents.hpp"
+#include "../components/VoxelComponents.hpp"
+#include "../../world/ChunkMesher.hpp"
+#include "../../world/ChunkBVH.hpp"
+#include "../../world/Frustum.hpp"
+#include "InstanceBufferSystem.hpp"
 
 namespace ECS {
 
 class RenderSystem {
 public:
-    RenderSystem() : blockSize(1.0f) {}
+    RenderSystem()
+        : blockSize(1.0f), instancingLoaded(false), instanceColorVbo(0), instanceColorCapacity(0),
+          instanceColorLoc(-1), frustumCulling(true), drawnFaceCount(0), chunkMaterialLoaded(false) {}
     
     void SetBlockSize(float size) {
         blockSize = size;
     }
     
-    // Render all visible blocks
-    void Render(entt::registry& registry, int startY = 0, int endY = 36) {
-        // Get all entities with Position, BlockData, and Renderable components
-        auto view = registry.view<Position, BlockData, Renderable>();
-        
-        for (auto entity : view) {
-            auto& pos = view.get<Position>(entity);
-            auto& blockData = view.get<BlockData>(entity);
-            auto& renderable = view.get<Renderable>(entity);
-            
-            // Skip if not visible or outside Y range
-            if (!renderable.visible || pos.y < startY || pos.y >= endY) {
-                continue;
-            }
-            
-            // Calculate 3D position
-            Vector3 position = {
-                pos.x * blockSize,
-                pos.y * blockSize,
-                pos.z * blockSize
-            };
-            
-            Vector3 size = { blockSize, blockSize, blockSize };
-            
-            // Draw the block
-            if (renderable.wireframe) {
-                DrawCubeWiresV(position, size, blockData.color);
-            } else {
-                DrawCubeV(position, size, blockData.color);
-                DrawCubeWiresV(position, size, ColorBrightness(blockData.color, -0.3f));
-            }
-        }
+    // Render the visible faces of blocks in layers [startY, endY). Only blocks
+    // carrying VisibleFaces (the shell) are drawn, one quad per open face.
+    void Render(entt::registry& registry, int startY = 0, int endY = INT_MAX) {
+        DrawSlab(registry, startY, endY);
     }
     
-    // Render only blocks matching a specific layer
+    // Render only blocks matching a specific layer; the layers above and below
+    // are hidden, so every block in the layer shows its top and bottom
     void RenderLayer(entt::registry& registry, int layer) {
-        auto view = registry.view<Position, BlockData, Renderable>();
+        DrawSlab(registry, layer, layer + 1);
+    }
+    
+    // Render only surface blocks (for surface-only view). Every block in the
+    // top 3 layers is part of the surface shell.
+    void RenderSurfaces(entt::registry& registry) {
+        DrawSlab(registry, 0, 3);
+    }
+    
+    // Render only underground blocks (below layer 3)
+    void RenderUnderground(entt::registry& registry) {
+        DrawSlab(registry, 3, INT_MAX);
+    }
+    
+    // Decide which chunks the camera can see this frame. Every render path
+    // then skips blocks, instances and meshes of the other chunks. Call once
+    // per frame before drawing; without it nothing is culled.
+    void CullChunks(const World::World& world, const Camera3D& camera, float aspect) {
+        if (!chunkBvh.IsBuiltFor(world)) {
+            chunkBvh.Build(world);
+        }
         
-        for (auto entity : view) {
-            auto& pos = view.get<Position>(entity);
-            
-            if (pos.y != layer) continue;
-            
-            auto& blockData = view.get<BlockData>(entity);
-            auto& renderable = view.get<Renderable>(entity);
-            
-            if (!renderable.visible) continue;
-            
-            Vector3 position = {
-                pos.x * blockSize,
-                pos.y * blockSize,
-                pos.z * blockSize
-            };
-            
-            Vector3 size = { blockSize, blockSize, blockSize };
-            
-            if (renderable.wireframe) {
-                DrawCubeWiresV(position, size, blockData.color);
-            } else {
-                DrawCubeV(position, size, blockData.color);
-                DrawCubeWiresV(position, size, ColorBrightness(blockData.color, -0.3f));
-            }
+        visibleChunks.clear();
+        if (frustumCulling) {
+            Matrix viewProjection = World::CameraViewProjection(camera, aspect);
+            chunkBvh.Query(World::ExtractFrustum(viewProjection), visibleChunks, &cullStats);
+        } else {
+            world.GetLoadedChunks(visibleChunks);
+            cullStats = World::ChunkCullStats{};
+            cullStats.chunksTotal = cullStats.chunksSubmitted = (int)visibleChunks.size();
+        }
+        
+        // Dense per-chunk flags for the per-block checks
+        chunksX = world.GetChunksX();
+        chunksY = world.GetChunksY();
+        chunksZ = world.GetChunksZ();
+        chunkVisible.assign((size_t)chunksX * chunksY * chunksZ, 0);
+        for (const World::ChunkCoord& coord : visibleChunks) {
+            chunkVisible[ChunkSlot(coord)] = 1;
         }
     }
     
-    // Render only surface blocks (for surface-only view)
-    void RenderSurfaces(entt::registry& registry) {
-        auto view = registry.view<Position, BlockData, Renderable, Surface>();
+    void SetFrustumCulling(bool enabled) { frustumCulling = enabled; }
+    bool IsFrustumCulling() const { return frustumCulling; }
+    
+    // Counters from the last CullChunks
+    const World::ChunkCullStats& GetCullStats() const { return cullStats; }
+    
+    // Faces drawn by the last Render/RenderLayer/RenderSurfaces/RenderUnderground
+    size_t GetDrawnFaceCount() const {
+        return drawnFaceCount;
+    }
+    
+    // Gather the faces seen in layers [startY, endY) without drawing them;
+    // returns the face count. Faces open to air come from the shell blocks
+    // of each layer (ShellLayers); when the slab cuts through the world, the
+    // blocks on the cut also show the face towards the removed layers even
+    // though they are buried, and those are read from the cut layer of the
+    // BlockGrid. Only the layers in the slab are touched. In hybrid mode the
+    // faces come straight from the VoxelWorld grid instead.
+    size_t CollectSlabFaces(entt::registry& registry, int startY, int endY) {
+        faceScratch.clear();
+        visitedBlockCount = 0;
         
-        for (auto entity : view) {
-            auto& pos = view.get<Position>(entity);
-            auto& blockData = view.get<BlockData>(entity);
-            auto& renderable = view.get<Renderable>(entity);
-            auto& surface = view.get<Surface>(entity);
-            
-            // Only render exposed surfaces in top 3 layers
-            if (!renderable.visible || !surface.isExposed || pos.y >= 3) {
-                continue;
+        const BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        const ShellLayers* shell = registry.ctx().find<ShellLayers>();
+        if (!grid || !shell) {
+            const VoxelWorld* voxels = registry.ctx().find<VoxelWorld>();
+            return voxels ? CollectVoxelSlabFaces(*voxels, startY, endY) : 0;
+        }
+        
+        int firstLayer = std::max(startY, 0);
+        int lastLayer = std::min(endY, grid->height);  // exclusive
+        bool cutBelow = startY > 0;
+        bool cutAbove = endY < grid->height;
+        
+        auto cutFaces = [&](int y) {
+            uint8_t mask = 0;
+            if (cutBelow && y == startY) mask |= FACE_NEG_Y;
+            if (cutAbove && y == endY - 1) mask |= FACE_POS_Y;
+            return mask;
+        };
+        
+        // Shell blocks, layer by layer
+        for (int y = firstLayer; y < lastLayer; ++y) {
+            for (entt::entity entity : shell->layers[y]) {
+                ++visitedBlockCount;
+                auto [pos, blockData, renderable, visible] =
+                    registry.get<Position, BlockData, Renderable, VisibleFaces>(entity);
+                if (!renderable.visible) continue;
+                if (!IsChunkVisible(World::ChunkCoordOf(pos.x, pos.y, pos.z))) continue;
+                
+                AddFaces(pos, blockData.color, visible.mask | cutFaces(y), renderable.wireframe);
             }
-            
-            Vector3 position = {
-                pos.x * blockSize,
-                pos.y * blockSize,
-                pos.z * blockSize
-            };
-            
-            Vector3 size = { blockSize, blockSize, blockSize };
-            
-            if (renderable.wireframe) {
-                DrawCubeWiresV(position, size, blockData.color);
-            } else {
-                DrawCubeV(position, size, blockData.color);
-                DrawCubeWiresV(position, size, ColorBrightness(blockData.color, -0.3f));
+        }
+        
+        // Buried blocks exposed by the cut planes
+        auto addCutLayer = [&](int y) {
+            for (int z = 0; z < grid->depth; ++z) {
+                for (int x = 0; x < grid->width; ++x) {
+                    entt::entity entity = grid->cells[grid->Index(x, y, z)];
+                    if (entity == entt::null || registry.all_of<VisibleFaces>(entity)) continue;
+                    ++visitedBlockCount;
+                    
+                    auto [pos, blockData, renderable] = registry.get<Position, BlockData, Renderable>(entity);
+                    if (!renderable.visible) continue;
+                    if (!IsChunkVisible(World::ChunkCoordOf(x, y, z))) continue;
+                    
+                    AddFaces(pos, blockData.color, cutFaces(y), renderable.wireframe);
+                }
             }
+        };
+        if (firstLayer < lastLayer) {
+            if (cutBelow) addCutLayer(firstLayer);
+            if (cutAbove && !(cutBelow && lastLayer - 1 == firstLayer)) addCutLayer(lastLayer - 1);
         }
+        
+        size_t faces = 0;
+        for (const FaceDraw& draw : faceScratch) faces += CountFaces(draw.mask);
+        return faces;
     }
     
-    // Render only underground blocks (below layer 3)
-    void RenderUnderground(entt::registry& registry) {
-        auto view = registry.view<Position, BlockData, Renderable>();
-        
+    // Blocks looked at by the last CollectSlabFaces (shows it is O(layers))
+    size_t GetVisitedBlockCount() const {
+        return visitedBlockCount;
+    }
+    
+    // Draw the dynamic blocks of the hybrid model (falling ones at their
+    // current height, ones being mined shrinking as they go)
+    void RenderDynamicBlocks(entt::registry& registry) {
+        auto view = registry.view<DynamicBlock, Position, BlockData, Renderable>();
         for (auto entity : view) {
-            auto& pos = view.get<Position>(entity);
-            
-            if (pos.y < 3) continue; // Skip surface layers
-            
-            auto& blockData = view.get<BlockData>(entity);
-            auto& renderable = view.get<Renderable>(entity);
-            
+            auto [pos, blockData, renderable] = view.get<Position, BlockData, Renderable>(entity);
             if (!renderable.visible) continue;
             
-            Vector3 position = {
-                pos.x * blockSize,
-                pos.y * blockSize,
-                pos.z * blockSize
-            };
-            
-            Vector3 size = { blockSize, blockSize, blockSize };
-            
-            if (renderable.wireframe) {
-                DrawCubeWiresV(position, size, blockData.color);
-            } else {
-                DrawCubeV(position, size, blockData.color);
-                DrawCubeWiresV(position, size, ColorBrightness(blockData.color, -0.3f));
+            float y = pos.y;
+            if (const Falling* falling = registry.try_get<Falling>(entity)) y = falling->height;
+            float size = blockSize;
+            if (const BeingMined* mined = registry.try_get<BeingMined>(entity)) {
+                size *= 1.0f - 0.5f * std::min(mined->progress, 1.0f);
             }
+            
+            Vector3 center = { pos.x * blockSize, y * blockSize, pos.z * blockSize };
+            if (!renderable.wireframe) DrawCube(center, size, size, size, blockData.color);
+            DrawCubeWires(center, size, size, size,
+                          renderable.wireframe ? blockData.color : ColorBrightness(blockData.color, -0.3f));
         }
     }
     
-    // Toggle wireframe mode for all renderable entities
+    // Toggle wireframe mode for all renderable entities (and for terrain
+    // drawn from a VoxelWorld, which has no Renderable to carry the flag)
     void ToggleWireframe(entt::registry& registry, bool wireframe) {
+        voxelWireframe = wireframe;
         auto view = registry.view<Renderable>();
         for (auto entity : view) {
-            auto& renderable = view.get<Renderable>(entity);
-            renderable.wireframe = wireframe;
+            // patch (not a plain write) so on_update listeners see the change
+            registry.patch<Renderable>(entity, [wireframe](auto& renderable) {
+                renderable.wireframe = wireframe;
+            });
         }
     }
     
@@ -156,9 +205,623 @@ public:
     size_t GetRenderableCount(entt::registry& registry) {
         return registry.view<Renderable>().size();
     }
+    
+    // Render the world from one greedy-meshed Mesh per chunk. Chunk meshes are
+    // rebuilt only when the chunk's revision changed (World::SetBlock/Generate).
+    void RenderChunkMeshes(const World::World& world, bool wireframe) {
+        SyncChunkMeshes(world);
+        
+        Matrix transform = MatrixScale(blockSize, blockSize, blockSize);
+        if (wireframe) rlEnableWireMode();
+        for (auto& [coord, entry] : chunkMeshes) {
+            if (entry.mesh.vertexCount > 0 && IsChunkVisible(coord)) {
+                DrawMesh(entry.mesh, chunkMaterial, transform);
+            }
+        }
+        if (wireframe) rlDisableWireMode();
+    }
+    
+    // Upload a chunk mesh built elsewhere (e.g. by World::ChunkPipeline) for a
+    // resident chunk's current revision, so RenderChunkMeshes does not
+    // rebuild it until the chunk changes
+    void AdoptChunkMesh(const World::World& world, const World::ChunkCoord& coord,
+                        const World::ChunkMeshData& data) {
+        uint64_t revision = world.GetChunkRevision(coord);
+        if (revision == 0) return;
+        
+        auto it = chunkMeshes.find(coord);
+        if (it != chunkMeshes.end() && it->second.mesh.vertexCount > 0) {
+            UnloadMesh(it->second.mesh);
+        }
+        ChunkMeshEntry& entry = chunkMeshes[coord];
+        entry.mesh = UploadChunkMesh(data);
+        entry.revision = revision;
+    }
+    
+    // Triangles currently uploaded for chunk meshes
+    size_t GetChunkMeshTriangleCount() const {
+        size_t triangles = 0;
+        for (const auto& [coord, entry] : chunkMeshes) {
+            triangles += entry.mesh.triangleCount;
+        }
+        return triangles;
+    }
+    
+    // Release GPU resources (call before CloseWindow)
+    void UnloadChunkMeshes() {
+        for (auto& [coord, entry] : chunkMeshes) {
+            if (entry.mesh.vertexCount > 0) UnloadMesh(entry.mesh);
+        }
+        chunkMeshes.clear();
+        if (chunkMaterialLoaded) {
+            UnloadMaterial(chunkMaterial);
+            chunkMaterialLoaded = false;
+        }
+    }
+    
+    // Render the shell blocks as instances of one cube mesh with a single
+    // DrawMeshInstanced call. The instance buffers are rebuilt only after
+    // the block components changed (see InstanceBufferSystem). In hybrid
+    // mode the instances come from the VoxelWorld grid instead (see
+    // CollectVoxelInstances).
+    void RenderInstanced(entt::registry& registry, bool wireframe) {
+        if (!instancingLoaded) LoadInstancing();
+        
+        const VoxelWorld* voxels = registry.ctx().find<VoxelWorld>();
+        if (voxels && !registry.ctx().contains<BlockGrid>()) {
+            if (CollectVoxelInstances(*voxels) || !voxelColorsUploaded) {
+                UploadInstanceColors(voxelInstances.colors);
+                voxelColorsUploaded = true;
+            }
+            DrawInstances(voxelInstances.transforms, wireframe);
+            return;
+        }
+        
+        if (!instanceBuffers.IsConnected(registry)) instanceBuffers.Connect(registry);
+        
+        bool rebuilt = instanceBuffers.Update(registry, blockSize);
+        const BlockInstanceBuffer& buffer = instanceBuffers.GetBuffer();
+        
+        // Keep only the runs of chunks in view; colors are re-uploaded only
+        // when the buffers were rebuilt or the set of visible runs changed
+        const std::vector<Matrix>* transforms = &buffer.transforms;
+        const std::vector<Color>* colors = &buffer.colors;
+        std::vector<uint32_t> runs;
+        for (uint32_t i = 0; i < buffer.chunks.size(); ++i) {
+            if (IsChunkVisible(buffer.chunks[i].coord)) runs.push_back(i);
+        }
+        if (runs.size() != buffer.chunks.size()) {
+            instanceScratch.transforms.clear();
+            instanceScratch.colors.clear();
+            for (uint32_t i : runs) {
+                const InstanceChunkRange& range = buffer.chunks[i];
+                instanceScratch.transforms.insert(instanceScratch.transforms.end(),
+                    buffer.transforms.begin() + range.first, buffer.transforms.begin() + range.first + range.count);
+                instanceScratch.colors.insert(instanceScratch.colors.end(),
+                    buffer.colors.begin() + range.first, buffer.colors.begin() + range.first + range.count);
+            }
+            transforms = &instanceScratch.transforms;
+            colors = &instanceScratch.colors;
+        }
+        if (rebuilt || runs != uploadedRuns || voxelColorsUploaded) {
+            UploadInstanceColors(*colors);
+            uploadedRuns.swap(runs);
+            voxelColorsUploaded = false;
+        }
+        
+        DrawInstances(*transforms, wireframe);
+    }
+    
+    // Gather hybrid-mode instances without drawing them: one per cached
+    // shell block (see SyncVoxelShell) of the resident chunks in view. The
+    // buffer is rebuilt only when a chunk in view changed revision or the
+    // set of chunks in view changed; returns true if it was.
+    bool CollectVoxelInstances(const VoxelWorld& voxels) {
+        const World::World& world = *voxels.world;
+        SyncVoxelShellWorld(world);
+        
+        // Chunk revisions are unique across a world, so the list of them
+        // identifies both the chunks in view and their contents
+        revisionScratch.clear();
+        ForEachVisibleVoxelChunk(world, [&](const World::ChunkCoord& coord, const World::Chunk&) {
+            revisionScratch.push_back(world.GetChunkRevision(coord));
+        });
+        if (revisionScratch == voxelInstanceRevisions) return false;
+        voxelInstanceRevisions.swap(revisionScratch);
+        
+        voxelInstances.transforms.clear();
+        voxelInstances.colors.clear();
+        voxelInstances.chunks.clear();
+        ForEachVisibleVoxelChunk(world, [&](const World::ChunkCoord& coord, const World::Chunk& chunk) {
+            const VoxelShellEntry& shell = SyncVoxelShell(voxels, coord, chunk);
+            InstanceChunkRange range = { coord, (uint32_t)voxelInstances.Size(), (uint32_t)shell.blocks.size() };
+            int baseX = coord.x << World::CHUNK_SHIFT;
+            int baseY = coord.y << World::CHUNK_SHIFT;
+            int baseZ = coord.z << World::CHUNK_SHIFT;
+            for (const VoxelShellBlock& block : shell.blocks) {
+                voxelInstances.transforms.push_back(MatrixTranslate((baseX + block.lx) * blockSize,
+                    (baseY + block.ly) * blockSize, (baseZ + block.lz) * blockSize));
+                voxelInstances.colors.push_back(World::Block::GetColorFromType(block.type));
+            }
+            if (range.count > 0) voxelInstances.chunks.push_back(range);
+        });
+        return true;
+    }
+    
+    // Instances gathered by the last CollectVoxelInstances
+    const BlockInstanceBuffer& GetVoxelInstances() const {
+        return voxelInstances;
+    }
+    
+    // Instances submitted by the last RenderInstanced
+    size_t GetInstanceCount() const {
+        return submittedInstances;
+    }
+    
+    // Release instancing GPU resources (call before CloseWindow)
+    void UnloadInstancing() {
+        instanceBuffers.Disconnect();
+        if (!instancingLoaded) return;
+        if (instanceColorVbo != 0) rlUnloadVertexBuffer(instanceColorVbo);
+        UnloadMesh(instanceCube);
+        UnloadMaterial(instanceMaterial);  // also unloads the instancing shader
+        instanceColorVbo = 0;
+        instanceColorCapacity = 0;
+        instancingLoaded = false;
+    }
 
 private:
     float blockSize;
+    
+    // Instanced path: one cube mesh, a shader reading per-instance transform
+    // and color attributes, and a color VBO attached to the cube's VAO
+    InstanceBufferSystem instanceBuffers;
+    BlockInstanceBuffer instanceScratch;     // visible runs when culling removes some
+    std::vector<uint32_t> uploadedRuns;      // chunk runs whose colors are on the GPU
+    size_t submittedInstances = 0;
+    
+    // Hybrid-mode instances, the chunk revisions they were built from, and
+    // whether the GPU holds their colors rather than the entity path's
+    BlockInstanceBuffer voxelInstances;
+    std::vector<uint64_t> voxelInstanceRevisions;
+    std::vector<uint64_t> revisionScratch;
+    bool voxelColorsUploaded = false;
+    Mesh instanceCube;
+    Material instanceMaterial;
+    bool instancingLoaded;
+    unsigned int instanceColorVbo;
+    int instanceColorCapacity;
+    int instanceColorLoc;
+    
+    void LoadInstancing() {
+        // Same per-direction shading as the chunk meshes
+        static const char* vertexShader =
+            "#version 330\n"
+            "in vec3 vertexPosition;\n"
+            "in vec3 vertexNormal;\n"
+            "in mat4 instanceTransform;\n"
+            "in vec4 instanceColor;\n"
+            "uniform mat4 mvp;\n"
+            "out vec4 fragColor;\n"
+            "void main() {\n"
+            "    float shade = abs(vertexNormal.y) > 0.5 ? (vertexNormal.y > 0.0 ? 1.0 : 0.55)\n"
+            "                : (abs(vertexNormal.x) > 0.5 ? 0.8 : 0.9);\n"
+            "    fragColor = vec4(instanceColor.rgb * shade, instanceColor.a);\n"
+            "    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);\n"
+            "}\n";
+        static const char* fragmentShader =
+            "#version 330\n"
+            "in vec4 fragColor;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    finalColor = fragColor;\n"
+            "}\n";
+        
+        Shader shader = LoadShaderFromMemory(vertexShader, fragmentShader);
+        shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+        shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+        instanceColorLoc = GetShaderLocationAttrib(shader, "instanceColor");
+        
+        instanceMaterial = LoadMaterialDefault();
+        instanceMaterial.shader = shader;
+        instanceCube = GenMeshCube(blockSize, blockSize, blockSize);
+        instancingLoaded = true;
+    }
+    
+    void DrawInstances(const std::vector<Matrix>& transforms, bool wireframe) {
+        submittedInstances = transforms.size();
+        if (transforms.empty()) return;
+        
+        if (wireframe) rlEnableWireMode();
+        DrawMeshInstanced(instanceCube, instanceMaterial, transforms.data(), (int)transforms.size());
+        if (wireframe) rlDisableWireMode();
+    }
+    
+    // Copy instance colors to the GPU, growing the VBO when needed
+    void UploadInstanceColors(const std::vector<Color>& colors) {
+        int count = (int)colors.size();
+        if (count == 0 || instanceColorLoc < 0) return;
+        
+        if (count <= instanceColorCapacity) {
+            rlUpdateVertexBuffer(instanceColorVbo, colors.data(), count * (int)sizeof(Color), 0);
+            return;
+        }
+        
+        rlEnableVertexArray(instanceCube.vaoId);
+        if (instanceColorVbo != 0) rlUnloadVertexBuffer(instanceColorVbo);
+        instanceColorVbo = rlLoadVertexBuffer(colors.data(), count * (int)sizeof(Color), true);
+        rlSetVertexAttribute(instanceColorLoc, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+        rlEnableVertexAttribute(instanceColorLoc);
+        rlSetVertexAttributeDivisor(instanceColorLoc, 1);
+        rlDisableVertexArray();
+        instanceColorCapacity = count;
+    }
+    
+    // Frustum culling state: the chunk hierarchy, the chunks that passed
+    // the last CullChunks and a dense flag per chunk for block lookups
+    World::ChunkBVH chunkBvh;
+    bool frustumCulling;
+    World::ChunkCullStats cullStats;
+    std::vector<World::ChunkCoord> visibleChunks;
+    std::vector<uint8_t> chunkVisible;
+    int chunksX = 0;
+    int chunksY = 0;
+    int chunksZ = 0;
+    
+    size_t ChunkSlot(const World::ChunkCoord& coord) const {
+        return ((size_t)coord.y * chunksZ + coord.z) * chunksX + coord.x;
+    }
+    
+    bool IsChunkVisible(const World::ChunkCoord& coord) const {
+        if (chunkVisible.empty()) return true;  // CullChunks not called
+        if (coord.x < 0 || coord.x >= chunksX || coord.y < 0 || coord.y >= chunksY ||
+            coord.z < 0 || coord.z >= chunksZ) return false;
+        return chunkVisible[ChunkSlot(coord)] != 0;
+    }
+    
+    // One block to draw: its centre, the faces to draw and how
+    struct FaceDraw {
+        Vector3 center;
+        Color color;
+        uint8_t mask;
+        bool wireframe;
+    };
+    
+    std::vector<FaceDraw> faceScratch;
+    size_t drawnFaceCount;
+    size_t visitedBlockCount = 0;
+    bool voxelWireframe = false;
+    
+    // Collect the faces of layers [startY, endY) and draw them
+    void DrawSlab(entt::registry& registry, int startY, int endY) {
+        CollectSlabFaces(registry, startY, endY);
+        DrawFaces();
+    }
+    
+    // Shell of one chunk of a VoxelWorld, cached by chunk revision: the
+    // exposed faces of every voxel, and the solid voxels with any (by layer)
+    struct VoxelShellBlock {
+        uint8_t lx, ly, lz;
+        uint8_t mask;
+        World::BlockType type;
+    };
+    
+    struct VoxelShellEntry {
+        uint64_t revision = 0;
+        std::vector<uint8_t> masks;             // LocalIndex order
+        std::vector<VoxelShellBlock> blocks;    // sorted by ly
+    };
+    
+    const World::World* voxelShellWorld = nullptr;
+    uint64_t voxelShellLayout = 0;
+    std::unordered_map<World::ChunkCoord, VoxelShellEntry, World::ChunkCoordHash> voxelShells;
+    std::vector<World::BlockType> chunkScratch = std::vector<World::BlockType>(World::CHUNK_VOLUME);
+    
+    // Rebuild a chunk's cached shell if its revision moved on. The chunk is
+    // decoded once; only neighbours across its border use world lookups.
+    const VoxelShellEntry& SyncVoxelShell(const VoxelWorld& voxels, const World::ChunkCoord& coord,
+                                          const World::Chunk& chunk) {
+        uint64_t revision = voxels.world->GetChunkRevision(coord);
+        VoxelShellEntry& entry = voxelShells[coord];
+        if (entry.revision == revision) return entry;
+        
+        entry.revision = revision;
+        entry.masks.assign(World::CHUNK_VOLUME, 0);
+        entry.blocks.clear();
+        chunk.Decode(chunkScratch.data());
+        
+        int baseX = coord.x << World::CHUNK_SHIFT;
+        int baseY = coord.y << World::CHUNK_SHIFT;
+        int baseZ = coord.z << World::CHUNK_SHIFT;
+        auto solid = [&](int x, int y, int z) {
+            int lx = x - baseX, ly = y - baseY, lz = z - baseZ;
+            if ((unsigned)lx < (unsigned)World::CHUNK_SIZE && (unsigned)ly < (unsigned)World::CHUNK_SIZE &&
+                (unsigned)lz < (unsigned)World::CHUNK_SIZE) {
+                return voxels.Contains(x, y, z) &&
+                       chunkScratch[World::LocalIndex(lx, ly, lz)] != World::BlockType::Air;
+            }
+            return voxels.IsSolid(x, y, z);
+        };
+        
+        const World::World& world = *voxels.world;
+        int x1 = std::min(baseX + World::CHUNK_SIZE, world.GetWidth());
+        int y1 = std::min(baseY + World::CHUNK_SIZE, world.GetHeight());
+        int z1 = std::min(baseZ + World::CHUNK_SIZE, world.GetDepth());
+        for (int y = baseY; y < y1; ++y) {
+            for (int z = baseZ; z < z1; ++z) {
+                for (int x = baseX; x < x1; ++x) {
+                    size_t index = World::LocalIndex(x - baseX, y - baseY, z - baseZ);
+                    World::BlockType type = chunkScratch[index];
+                    if (type == World::BlockType::Air) continue;
+                    
+                    uint8_t mask = 0;
+                    for (int f = 0; f < FACE_COUNT; ++f) {
+                        if (!solid(x + FACE_OFFSETS[f][0], y + FACE_OFFSETS[f][1], z + FACE_OFFSETS[f][2])) {
+                            mask |= static_cast<uint8_t>(1 << f);
+                        }
+                    }
+                    entry.masks[index] = mask;
+                    if (mask != 0) {
+                        entry.blocks.push_back({ static_cast<uint8_t>(x - baseX), static_cast<uint8_t>(y - baseY),
+                                                 static_cast<uint8_t>(z - baseZ), mask, type });
+                    }
+                }
+            }
+        }
+        return entry;
+    }
+    
+    // Point the shell cache at a world, forgetting the shells of another
+    // world or of chunks that were dropped (streamed out)
+    void SyncVoxelShellWorld(const World::World& world) {
+        if (voxelShellWorld != &world) {
+            voxelShells.clear();
+            voxelInstanceRevisions.clear();
+            voxelShellWorld = &world;
+        }
+        if (voxelShellLayout != world.GetChunkLayoutRevision()) {
+            voxelShellLayout = world.GetChunkLayoutRevision();
+            for (auto it = voxelShells.begin(); it != voxelShells.end(); ) {
+                it = world.GetChunk(it->first) ? std::next(it) : voxelShells.erase(it);
+            }
+        }
+    }
+    
+    // Call fn(coord, chunk) for each resident chunk in view, in a fixed order
+    template <typename Fn>
+    void ForEachVisibleVoxelChunk(const World::World& world, Fn&& fn) const {
+        for (int cy = 0; cy < world.GetChunksY(); ++cy) {
+            for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+                for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                    World::ChunkCoord coord = { cx, cy, cz };
+                    const World::Chunk* chunk = world.GetChunk(coord);
+                    if (chunk && IsChunkVisible(coord)) fn(coord, *chunk);
+                }
+            }
+        }
+    }
+    
+    // CollectSlabFaces for hybrid mode, with the same cost profile as the
+    // entity path: per visible chunk in the slab, the cached shell blocks of
+    // the slab's layers, plus a scan of the cut layers for buried blocks
+    size_t CollectVoxelSlabFaces(const VoxelWorld& voxels, int startY, int endY) {
+        const World::World& world = *voxels.world;
+        SyncVoxelShellWorld(world);
+        
+        int firstLayer = std::max(startY, 0);
+        int lastLayer = std::min(endY, world.GetHeight());  // exclusive
+        if (firstLayer >= lastLayer) return 0;
+        bool cutBelow = startY > 0;
+        bool cutAbove = endY < world.GetHeight();
+        auto cutFaces = [&](int y) {
+            uint8_t mask = 0;
+            if (cutBelow && y == startY) mask |= FACE_NEG_Y;
+            if (cutAbove && y == endY - 1) mask |= FACE_POS_Y;
+            return mask;
+        };
+        
+        for (int cy = firstLayer >> World::CHUNK_SHIFT; cy <= (lastLayer - 1) >> World::CHUNK_SHIFT; ++cy) {
+            int baseY = cy << World::CHUNK_SHIFT;
+            int y0 = std::max(baseY, firstLayer);
+            int y1 = std::min(baseY + World::CHUNK_SIZE, lastLayer);
+            for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+                for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                    World::ChunkCoord coord = { cx, cy, cz };
+                    const World::Chunk* chunk = world.GetChunk(coord);
+                    if (!chunk || !IsChunkVisible(coord)) continue;
+                    const VoxelShellEntry& shell = SyncVoxelShell(voxels, coord, *chunk);
+                    int baseX = cx << World::CHUNK_SHIFT;
+                    int baseZ = cz << World::CHUNK_SHIFT;
+                    
+                    // Shell blocks of the slab's layers (cut layers below)
+                    for (const VoxelShellBlock& block : shell.blocks) {
+                        int y = baseY + block.ly;
+                        if (y < y0) continue;
+                        if (y >= y1) break;
+                        if (cutFaces(y) != 0) continue;
+                        ++visitedBlockCount;
+                        AddFaces(Position(baseX + block.lx, y, baseZ + block.lz),
+                                 World::Block::GetColorFromType(block.type), block.mask, voxelWireframe);
+                    }
+                    
+                    // Every solid block on a cut layer shows the cut face
+                    int x1 = std::min(baseX + World::CHUNK_SIZE, world.GetWidth());
+                    int z1 = std::min(baseZ + World::CHUNK_SIZE, world.GetDepth());
+                    for (int y = y0; y < y1; ++y) {
+                        uint8_t cut = cutFaces(y);
+                        if (cut == 0) continue;
+                        for (int z = baseZ; z < z1; ++z) {
+                            for (int x = baseX; x < x1; ++x) {
+                                World::BlockType type = chunk->Get(x - baseX, y - baseY, z - baseZ);
+                                if (type == World::BlockType::Air) continue;
+                                ++visitedBlockCount;
+                                
+                                uint8_t mask = shell.masks[World::LocalIndex(x - baseX, y - baseY, z - baseZ)] | cut;
+                                AddFaces(Position(x, y, z), World::Block::GetColorFromType(type), mask, voxelWireframe);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        size_t faces = 0;
+        for (const FaceDraw& draw : faceScratch) faces += CountFaces(draw.mask);
+        return faces;
+    }
+    
+    void AddFaces(const Position& pos, Color color, uint8_t mask, bool wireframe) {
+        Vector3 center = { pos.x * blockSize, pos.y * blockSize, pos.z * blockSize };
+        faceScratch.push_back({ center, color, mask, wireframe });
+    }
+    
+    // Corners of one face of the cube around center, counter-clockwise seen
+    // from outside (same winding as DrawCubeV and the chunk mesher)
+    void FaceCorners(const Vector3& center, int face, Vector3 out[4]) const {
+        static const float positive[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+        static const float negative[4][2] = { { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 } };
+        
+        int axis = face >> 1;
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        bool outward = (face & 1) != 0;
+        const float (*order)[2] = outward ? positive : negative;
+        float half = blockSize * 0.5f;
+        float c[3] = { center.x, center.y, center.z };
+        
+        for (int k = 0; k < 4; ++k) {
+            float p[3];
+            p[axis] = c[axis] + (outward ? half : -half);
+            p[u] = c[u] + order[k][0] * half;
+            p[v] = c[v] + order[k][1] * half;
+            out[k] = { p[0], p[1], p[2] };
+        }
+    }
+    
+    // Draw the collected faces: filled quads in one batch, then outlines
+    void DrawFaces() {
+        drawnFaceCount = 0;
+        Vector3 corners[4];
+        
+        rlBegin(RL_QUADS);
+        for (const FaceDraw& draw : faceScratch) {
+            if (draw.wireframe) continue;
+            rlColor4ub(draw.color.r, draw.color.g, draw.color.b, draw.color.a);
+            for (int face = 0; face < FACE_COUNT; ++face) {
+                if (!(draw.mask & (1 << face))) continue;
+                FaceCorners(draw.center, face, corners);
+                for (const Vector3& corner : corners) {
+                    rlVertex3f(corner.x, corner.y, corner.z);
+                }
+            }
+        }
+        rlEnd();
+        
+        rlBegin(RL_LINES);
+        for (const FaceDraw& draw : faceScratch) {
+            Color color = draw.wireframe ? draw.color : ColorBrightness(draw.color, -0.3f);
+            rlColor4ub(color.r, color.g, color.b, color.a);
+            for (int face = 0; face < FACE_COUNT; ++face) {
+                if (!(draw.mask & (1 << face))) continue;
+                FaceCorners(draw.center, face, corners);
+                for (int k = 0; k < 4; ++k) {
+                    const Vector3& a = corners[k];
+                    const Vector3& b = corners[(k + 1) % 4];
+                    rlVertex3f(a.x, a.y, a.z);
+                    rlVertex3f(b.x, b.y, b.z);
+                }
+                ++drawnFaceCount;
+            }
+        }
+        rlEnd();
+    }
+    
+    // Uploaded mesh of one chunk and the chunk revision it was built from
+    struct ChunkMeshEntry {
+        Mesh mesh;
+        uint64_t revision;
+    };
+    
+    std::unordered_map<World::ChunkCoord, ChunkMeshEntry, World::ChunkCoordHash> chunkMeshes;
+    Material chunkMaterial;
+    bool chunkMaterialLoaded;
+    World::ChunkMeshData meshScratch;
+    std::vector<World::ChunkCoord> loadedChunks;
+    
+    // Rebuild meshes of chunks whose revision changed since the last frame
+    void SyncChunkMeshes(const World::World& world) {
+        if (!chunkMaterialLoaded) {
+            chunkMaterial = LoadMaterialDefault();
+            chunkMaterialLoaded = true;
+        }
+        
+        // Drop meshes for chunks that no longer exist
+        for (auto it = chunkMeshes.begin(); it != chunkMeshes.end(); ) {
+            if (world.GetChunkRevision(it->first) == 0) {
+                if (it->second.mesh.vertexCount > 0) UnloadMesh(it->second.mesh);
+                it = chunkMeshes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        world.GetLoadedChunks(loadedChunks);
+        for (const World::ChunkCoord& coord : loadedChunks) {
+            uint64_t revision = world.GetChunkRevision(coord);
+            auto it = chunkMeshes.find(coord);
+            bool cached = it != chunkMeshes.end();
+            if (cached && it->second.revision == revision) continue;
+            
+            World::BuildChunkMesh(world, coord, meshScratch);
+            ChunkMeshEntry& entry = chunkMeshes[coord];
+            if (cached && entry.mesh.vertexCount > 0) {
+                UnloadMesh(entry.mesh);
+            }
+            entry.mesh = UploadChunkMesh(meshScratch);
+            entry.revision = revision;
+        }
+    }
+    
+    // Copy CPU mesh data into a raylib Mesh and upload it to the GPU
+    static Mesh UploadChunkMesh(const World::ChunkMeshData& data) {
+        Mesh mesh = {};
+        if (data.IsEmpty()) return mesh;
+        
+        if (data.GetVertexCount() <= 65535) {
+            mesh.vertexCount = data.GetVertexCount();
+            mesh.triangleCount = data.GetTriangleCount();
+            mesh.vertices = (float*)MemAlloc(data.vertices.size() * sizeof(float));
+            mesh.normals = (float*)MemAlloc(data.normals.size() * sizeof(float));
+            mesh.colors = (unsigned char*)MemAlloc(data.colors.size());
+            mesh.indices = (unsigned short*)MemAlloc(data.indices.size() * sizeof(unsigned short));
+            memcpy(mesh.vertices, data.vertices.data(), data.vertices.size() * sizeof(float));
+            memcpy(mesh.normals, data.normals.data(), data.normals.size() * sizeof(float));
+            memcpy(mesh.colors, data.colors.data(), data.colors.size());
+            memcpy(mesh.indices, data.indices.data(), data.indices.size() * sizeof(unsigned short));
+        } else {
+            // Too many vertices for 16-bit indices: expand to plain triangles
+            // (index values wrapped, so rebuild them from the quad order)
+            int quads = data.GetQuadCount();
+            mesh.vertexCount = quads * 6;
+            mesh.triangleCount = quads * 2;
+            mesh.vertices = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+            mesh.normals = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+            mesh.colors = (unsigned char*)MemAlloc(mesh.vertexCount * 4);
+            const int corner[6] = { 0, 1, 2, 0, 2, 3 };
+            for (int q = 0; q < quads; ++q) {
+                for (int k = 0; k < 6; ++k) {
+                    int src = q * 4 + corner[k];
+                    int dst = q * 6 + k;
+                    memcpy(&mesh.vertices[dst * 3], &data.vertices[src * 3], 3 * sizeof(float));
+                    memcpy(&mesh.normals[dst * 3], &data.normals[src * 3], 3 * sizeof(float));
+                    memcpy(&mesh.colors[dst * 4], &data.colors[src * 4], 4);
+                }
+            }
+        }
+        
+        UploadMesh(&mesh, false);
+        return mesh;
+    }
 };
 
 } // namespace ECS
@@ -2,9 +2,17 @@
 #define WORLD_SYSTEM_H
 
 #include <entt/entt.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <vector>
 #include "../components/Components.hpp"
+#include "../components/CubeTopologyComponents.hpp"
+#include "../components/VoxelComponents.hpp"
 #include "../../world/World.hpp"
+#include "CubeTopologySystem.hpp"
 
 namespace ECS {
 
@@ -12,55 +20,217 @@ class WorldSystem {
 public:
     WorldSystem() = default;
     
+    // Hybrid model: leave the terrain in the World grid and expose it to
+    // systems through the VoxelWorld context. No entity is created per
+    // block; only dynamic blocks (SpawnDynamicBlock) become entities. Any
+    // block entities from either mode are dropped, other entities stay.
+    void AttachWorld(entt::registry& registry, World::World& world) {
+        DestroyBlockEntities(registry);
+        registry.ctx().erase<BlockGrid>();
+        registry.ctx().erase<ShellLayers>();
+        registry.ctx().insert_or_assign(VoxelWorld{ &world });
+    }
+    
+    // True when the terrain is held by a VoxelWorld rather than block entities
+    static bool IsHybrid(entt::registry& registry) {
+        return registry.ctx().contains<VoxelWorld>();
+    }
+    
     // Populate the ECS registry with entities for each block in the world
+    // (entity-per-block model, kept for comparison with AttachWorld). Works
+    // in bulk: the solid blocks are gathered chunk by chunk, every pool is
+    // reserved up front, entities come from one range create and each
+    // component from one range insert. Repopulating releases the previous
+    // block entities, so handles to old blocks become invalid, and the
+    // range create recycles their ids (with new versions) along with the
+    // capacity of every pool and scratch buffer, so a world of the same
+    // size allocates nothing.
     void PopulateFromWorld(entt::registry& registry, const World::World& world) {
-        // Clear existing entities
-        registry.clear();
-        
-        // Create an entity for each block
-        for (int y = 0; y < world.GetHeight(); ++y) {
-            for (int z = 0; z < world.GetDepth(); ++z) {
-                for (int x = 0; x < world.GetWidth(); ++x) {
-                    const World::Block& block = world.GetBlock(x, y, z);
-                    
-                    // Create entity
-                    auto entity = registry.create();
-                    
-                    // Add position component
-                    registry.emplace<Position>(entity, x, y, z);
-                    
-                    // Add block data component
-                    registry.emplace<BlockData>(entity, block.type, block.color);
-                    
-                    // Add surface component
-                    bool isExposed = world.IsExposedSurface(x, y, z);
-                    registry.emplace<Surface>(entity, isExposed);
-                    
-                    // All blocks are renderable now (no air)
-                    registry.emplace<Renderable>(entity, true);
-                    
-                    // Add mineable component based on block type
-                    switch (block.type) {
-                        case World::BlockType::Soil:
-                            registry.emplace<Mineable>(entity, true, 1, 0.5f);
-                            registry.emplace<SoilTag>(entity);
-                            break;
-                        case World::BlockType::Stone:
-                            registry.emplace<Mineable>(entity, true, 5, 1.5f);
-                            registry.emplace<StoneTag>(entity);
-                            break;
-                        case World::BlockType::Gold:
-                            registry.emplace<Mineable>(entity, true, 100, 2.0f);
-                            registry.emplace<GoldTag>(entity);
-                            break;
-                        case World::BlockType::Silver:
-                            registry.emplace<Mineable>(entity, true, 50, 1.8f);
-                            registry.emplace<SilverTag>(entity);
-                            break;
-                    }
-                }
+        auto start = std::chrono::steady_clock::now();
+        
+        // Release the existing block entities; their slots are recycled below
+        DestroyBlockEntities(registry);
+        registry.ctx().erase<VoxelWorld>();
+        
+        // Position -> entity lookup used for neighbour queries
+        BlockGrid& grid = registry.ctx().emplace<BlockGrid>();
+        grid.Reset(world.GetWidth(), world.GetHeight(), world.GetDepth());
+        
+        GatherBlocks(world);
+        ReservePools(registry, scratch.positions.size());
+        CreateGatheredBlocks(registry, grid, false);
+        
+        // Tag the blocks that have faces open to air or the world boundary
+        topology.Build(registry);
+        
+        lastPopulateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    // Wall-clock time of the last PopulateFromWorld
+    double GetLastPopulateMs() const {
+        return lastPopulateMs;
+    }
+    
+    // Entity-per-block model with no blocks yet: release the block
+    // entities and start an empty grid (and shell index) for the world's
+    // bounds, for a world whose chunks arrive through PopulateChunk as
+    // they stream in (e.g. one just regenerated or loaded lazily)
+    void ResetBlockEntities(entt::registry& registry, const World::World& world) {
+        DestroyBlockEntities(registry);
+        registry.ctx().erase<VoxelWorld>();
+        registry.ctx().emplace<BlockGrid>().Reset(world.GetWidth(), world.GetHeight(), world.GetDepth());
+        ShellLayers shell;
+        shell.Reset(world.GetHeight());
+        registry.ctx().insert_or_assign(std::move(shell));
+    }
+    
+    // Give one chunk's solid blocks their entities, the way PopulateFromWorld
+    // does for the whole world (range create, range inserts), then refresh
+    // the visible faces of the chunk and of the blocks bordering it. Meant
+    // for chunks as they are installed (ChunkPipeline::Drain), so the cost
+    // is one chunk's blocks, not the world's. Cells that already have an
+    // entity are left alone; does nothing in hybrid mode. New blocks are
+    // drawn as wireframes if wireframe is set (see RenderSystem::ToggleWireframe).
+    void PopulateChunk(entt::registry& registry, const World::World& world, const World::ChunkCoord& coord,
+                       bool wireframe = false) {
+        BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        if (!grid || !world.GetChunk(coord)) {
+            return;
+        }
+        
+        ClearGathered();
+        GatherChunk(world, coord, grid);
+        if (scratch.positions.empty()) {
+            return;
+        }
+        CreateGatheredBlocks(registry, *grid, wireframe);
+        
+        int x0 = coord.x << World::CHUNK_SHIFT;
+        int y0 = coord.y << World::CHUNK_SHIFT;
+        int z0 = coord.z << World::CHUNK_SHIFT;
+        topology.UpdateBox(registry, x0, y0, z0, x0 + World::CHUNK_SIZE, y0 + World::CHUNK_SIZE,
+                           z0 + World::CHUNK_SIZE);
+    }
+    
+    // Change one block in both the world and the registry, then refresh the
+    // visible faces of that block and its neighbours. In hybrid mode only the
+    // world changes (chunk revisions tell the renderer).
+    void SetBlock(entt::registry& registry, World::World& world, int x, int y, int z, World::BlockType type) {
+        if (!world.IsValidPosition(x, y, z) || world.GetBlockType(x, y, z) == type) {
+            return;
+        }
+        world.SetBlock(x, y, z, World::Block(type));
+        
+        BlockGrid* grid = registry.ctx().find<BlockGrid>();
+        if (!grid || !grid->Contains(x, y, z)) {
+            return;
+        }
+        
+        entt::entity& cell = grid->cells[grid->Index(x, y, z)];
+        if (type == World::BlockType::Air) {
+            // Mined out: the block entity goes away
+            if (cell != entt::null) {
+                topology.RemoveBlock(registry, cell, y);
+                registry.destroy(cell);
+                cell = entt::null;
+            }
+        } else if (cell == entt::null) {
+            // Filled in: a new block entity
+            cell = CreateBlockEntity(registry, world, x, y, z, type);
+        } else {
+            // Changed type: update the existing entity in place
+            const World::BlockProperties& props = World::GetBlockProperties(type);
+            registry.replace<BlockData>(cell, type, props.color);
+            registry.replace<Mineable>(cell, true, props.value, props.hardness);
+            registry.remove<SoilTag, StoneTag, GoldTag, SilverTag>(cell);
+            AddTypeTag(registry, cell, type);
+        }
+        
+        topology.UpdateAround(registry, x, y, z);
+    }
+    
+    // Take the block at (x, y, z) out of the VoxelWorld grid and give it an
+    // entity (DynamicBlock plus the usual block components); the cell
+    // becomes air. Returns entt::null outside hybrid mode or for air.
+    entt::entity SpawnDynamicBlock(entt::registry& registry, int x, int y, int z) {
+        VoxelWorld* voxels = registry.ctx().find<VoxelWorld>();
+        if (!voxels || !voxels->IsSolid(x, y, z)) {
+            return entt::null;
+        }
+        
+        World::BlockType type = voxels->world->GetBlockType(x, y, z);
+        entt::entity entity = CreateBlockEntity(registry, *voxels->world, x, y, z, type);
+        registry.emplace<DynamicBlock>(entity);
+        voxels->world->SetBlock(x, y, z, World::Block(World::BlockType::Air));
+        return entity;
+    }
+    
+    // Start mining the block at (x, y, z); it disappears once mined
+    entt::entity StartMining(entt::registry& registry, int x, int y, int z) {
+        entt::entity entity = SpawnDynamicBlock(registry, x, y, z);
+        if (entity != entt::null) {
+            registry.emplace<BeingMined>(entity);
+        }
+        return entity;
+    }
+    
+    // Let the block at (x, y, z) fall until it lands on something
+    entt::entity DropBlock(entt::registry& registry, int x, int y, int z) {
+        entt::entity entity = SpawnDynamicBlock(registry, x, y, z);
+        if (entity != entt::null) {
+            registry.emplace<Falling>(entity, static_cast<float>(y));
+        }
+        return entity;
+    }
+    
+    // Write a dynamic block back into the grid at its position and destroy
+    // its entity
+    void SettleDynamicBlock(entt::registry& registry, entt::entity entity) {
+        VoxelWorld* voxels = registry.ctx().find<VoxelWorld>();
+        if (voxels) {
+            const Position& pos = registry.get<Position>(entity);
+            const BlockData& blockData = registry.get<BlockData>(entity);
+            voxels->world->SetBlock(pos.x, pos.y, pos.z, World::Block(blockData.type));
+        }
+        registry.destroy(entity);
+    }
+    
+    // Advance mining and falling blocks. Mined blocks are removed for good;
+    // falling blocks land on the first solid cell (or the bottom of the
+    // world) below them and go back into the grid.
+    void UpdateDynamicBlocks(entt::registry& registry, float deltaTime) {
+        VoxelWorld* voxels = registry.ctx().find<VoxelWorld>();
+        if (!voxels) return;
+        
+        std::vector<entt::entity> finished;
+        
+        auto mining = registry.view<BeingMined, Mineable>();
+        for (auto entity : mining) {
+            auto [mined, mineable] = mining.get<BeingMined, Mineable>(entity);
+            mined.progress += deltaTime / std::max(mineable.hardness, 0.01f);
+            if (mined.progress >= 1.0f) finished.push_back(entity);
+        }
+        registry.destroy(finished.begin(), finished.end());
+        finished.clear();
+        
+        auto falling = registry.view<Falling, Position>();
+        for (auto entity : falling) {
+            auto [fall, pos] = falling.get<Falling, Position>(entity);
+            fall.velocity += GRAVITY * deltaTime;
+            fall.height -= fall.velocity * deltaTime;
+            
+            int landing = pos.y;
+            while (landing > 0 && !voxels->IsSolid(pos.x, landing - 1, pos.z)) --landing;
+            if (fall.height <= landing) {
+                pos.y = landing;
+                finished.push_back(entity);
+            } else {
+                pos.y = static_cast<int>(std::ceil(fall.height));
             }
         }
+        for (entt::entity entity : finished) {
+            SettleDynamicBlock(registry, entity);
+        }
     }
     
     // Get statistics from registry
@@ -79,9 +249,19 @@ public:
         });
         
         std::cout << "\n===== ECS STATISTICS (SOLID WORLD) =====" << std::endl;
-        std::cout << "Total Entities: " << registry.storage<entt::entity>().size() << std::endl;
+        std::cout << "Total Entities: " << registry.storage<entt::entity>().free_list() << std::endl;
+        if (IsHybrid(registry)) {
+            std::cout << "Terrain: VoxelWorld grid (" << registry.view<DynamicBlock>().size()
+                      << " dynamic block entities)" << std::endl;
+        }
         std::cout << "All Renderable: " << renderableCount << " (100%)" << std::endl;
+        if (!IsHybrid(registry)) {
+            std::cout << "Populate Time: " << lastPopulateMs << " ms" << std::endl;
+        }
         std::cout << "Exposed Surfaces: " << totalExposed << std::endl;
+        std::cout << "Visible Faces: " << topology.GetVisibleFaceCount(registry) << " of "
+                  << renderableCount * FACE_COUNT << " (" << topology.GetVisibleBlockCount(registry)
+                  << " shell blocks)" << std::endl;
         std::cout << "\n----- Block Types -----" << std::endl;
         std::cout << "  Soil: " << soilCount << std::endl;
         std::cout << "  Stone: " << stoneCount << std::endl;
@@ -89,6 +269,201 @@ public:
         std::cout << "  Silver: " << silverCount << std::endl;
         std::cout << "==========================" << std::endl;
     }
+
+private:
+    // Downward acceleration of falling blocks, in blocks per second squared
+    static constexpr float GRAVITY = 20.0f;
+    
+    CubeTopologySystem topology;
+    double lastPopulateMs = 0.0;
+    
+    // Block entities and component values handled in bulk by
+    // PopulateFromWorld; kept between calls so their capacity is reused
+    struct PopulateScratch {
+        std::vector<World::BlockType> chunkTypes;
+        std::vector<entt::entity> entities;
+        std::vector<Position> positions;
+        std::vector<BlockData> blockData;
+        std::vector<Surface> surfaces;
+        std::vector<Mineable> mineables;
+        std::array<std::vector<entt::entity>, World::BLOCK_TYPE_COUNT> byType;
+    } scratch;
+    
+    // Fill the scratch arrays with the world's solid blocks, decoding each
+    // chunk once
+    void GatherBlocks(const World::World& world) {
+        ClearGathered();
+        for (int cy = 0; cy < world.GetChunksY(); ++cy) {
+            for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+                for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                    GatherChunk(world, { cx, cy, cz }, nullptr);
+                }
+            }
+        }
+    }
+    
+    void ClearGathered() {
+        scratch.positions.clear();
+        scratch.blockData.clear();
+        scratch.surfaces.clear();
+        scratch.mineables.clear();
+    }
+    
+    // Append a resident chunk's solid blocks to the scratch arrays,
+    // skipping cells that already have an entity in grid (if given)
+    void GatherChunk(const World::World& world, const World::ChunkCoord& coord, const BlockGrid* grid) {
+        const World::Chunk* chunk = world.GetChunk(coord);
+        if (!chunk) return;
+        scratch.chunkTypes.resize(World::CHUNK_VOLUME);
+        chunk->Decode(scratch.chunkTypes.data());
+        
+        int baseX = coord.x << World::CHUNK_SHIFT;
+        int baseY = coord.y << World::CHUNK_SHIFT;
+        int baseZ = coord.z << World::CHUNK_SHIFT;
+        int x1 = std::min(baseX + World::CHUNK_SIZE, world.GetWidth());
+        int y1 = std::min(baseY + World::CHUNK_SIZE, world.GetHeight());
+        int z1 = std::min(baseZ + World::CHUNK_SIZE, world.GetDepth());
+        for (int y = baseY; y < y1; ++y) {
+            for (int z = baseZ; z < z1; ++z) {
+                // Shell/interior split of the row, decided once
+                World::RowSpan interior = world.GetInteriorSpan(y, z);
+                for (int x = baseX; x < x1; ++x) {
+                    World::BlockType type = scratch.chunkTypes[World::LocalIndex(x - baseX, y - baseY, z - baseZ)];
+                    
+                    // Air is empty space, not an entity
+                    if (type == World::BlockType::Air) continue;
+                    if (grid && grid->At(x, y, z) != entt::null) continue;
+                    
+                    const World::BlockProperties& props = World::GetBlockProperties(type);
+                    scratch.positions.emplace_back(x, y, z);
+                    scratch.blockData.emplace_back(type, props.color);
+                    scratch.surfaces.emplace_back(!interior.Contains(x));
+                    scratch.mineables.emplace_back(true, props.value, props.hardness);
+                }
+            }
+        }
+    }
+    
+    // Create an entity for every gathered block: one range create, one
+    // range insert per component and per type tag, and the grid cells
+    void CreateGatheredBlocks(entt::registry& registry, BlockGrid& grid, bool wireframe) {
+        size_t count = scratch.positions.size();
+        scratch.entities.resize(count);
+        registry.create(scratch.entities.begin(), scratch.entities.end());
+        
+        Renderable renderable(true);
+        renderable.wireframe = wireframe;
+        registry.insert<Position>(scratch.entities.begin(), scratch.entities.end(), scratch.positions.begin());
+        registry.insert<BlockData>(scratch.entities.begin(), scratch.entities.end(), scratch.blockData.begin());
+        registry.insert<Surface>(scratch.entities.begin(), scratch.entities.end(), scratch.surfaces.begin());
+        registry.insert<Renderable>(scratch.entities.begin(), scratch.entities.end(), renderable);
+        registry.insert<Mineable>(scratch.entities.begin(), scratch.entities.end(), scratch.mineables.begin());
+        
+        // Type tags, one range per type
+        for (auto& tagged : scratch.byType) tagged.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const Position& pos = scratch.positions[i];
+            grid.cells[grid.Index(pos.x, pos.y, pos.z)] = scratch.entities[i];
+            scratch.byType[static_cast<size_t>(scratch.blockData[i].type)].push_back(scratch.entities[i]);
+        }
+        InsertTag<SoilTag>(registry, World::BlockType::Soil);
+        InsertTag<StoneTag>(registry, World::BlockType::Stone);
+        InsertTag<GoldTag>(registry, World::BlockType::Gold);
+        InsertTag<SilverTag>(registry, World::BlockType::Silver);
+    }
+    
+    // Reserve room for this many block entities in every block pool
+    static void ReservePools(entt::registry& registry, size_t count) {
+        registry.storage<entt::entity>().reserve(count);
+        registry.storage<Position>().reserve(count);
+        registry.storage<BlockData>().reserve(count);
+        registry.storage<Surface>().reserve(count);
+        registry.storage<Renderable>().reserve(count);
+        registry.storage<Mineable>().reserve(count);
+        registry.storage<VisibleFaces>().reserve(count);
+    }
+    
+    // Insert a type tag on every gathered block of that type
+    template <typename Tag>
+    void InsertTag(entt::registry& registry, World::BlockType type) {
+        const std::vector<entt::entity>& tagged = scratch.byType[static_cast<size_t>(type)];
+        registry.insert<Tag>(tagged.begin(), tagged.end());
+    }
+    
+    // Destroy every block entity (anything with BlockData)
+    void DestroyBlockEntities(entt::registry& registry) {
+        StripBlockEntities(registry, scratch.entities);
+        registry.storage<entt::entity>().erase(scratch.entities.begin(), scratch.entities.end());
+        scratch.entities.clear();
+    }
+    
+    // Remove every component from the block entities without releasing
+    // them, and list them in out. Pools holding nothing but block entities
+    // are cleared outright rather than entity by entity.
+    static void StripBlockEntities(entt::registry& registry, std::vector<entt::entity>& out) {
+        entt::sparse_set& blocks = registry.storage<BlockData>();
+        out.assign(blocks.begin(), blocks.end());
+        if (out.empty()) return;
+        
+        for (auto [id, pool] : registry.storage()) {
+            if (&pool == &blocks || pool.empty()) continue;
+            bool onlyBlocks = pool.size() <= blocks.size() &&
+                std::all_of(pool.begin(), pool.end(), [&](entt::entity e) { return blocks.contains(e); });
+            if (onlyBlocks) {
+                pool.clear();
+            } else {
+                pool.remove(out.begin(), out.end());
+            }
+        }
+        blocks.clear();
+    }
+    
+    // Create the entity for one solid block with all of its components
+    entt::entity CreateBlockEntity(entt::registry& registry, const World::World& world,
+                                   int x, int y, int z, World::BlockType type) {
+        auto entity = registry.create();
+        
+        // Add position component
+        registry.emplace<Position>(entity, x, y, z);
+        
+        // Add block data component
+        registry.emplace<BlockData>(entity, type, World::Block::GetColorFromType(type));
+        
+        // Add surface component
+        bool isExposed = world.IsExposedSurface(x, y, z);
+        registry.emplace<Surface>(entity, isExposed);
+        
+        // Every non-air block is renderable
+        registry.emplace<Renderable>(entity, true);
+        
+        // Add mineable component from the block properties table
+        const World::BlockProperties& props = World::GetBlockProperties(type);
+        registry.emplace<Mineable>(entity, true, props.value, props.hardness);
+        
+        // Add the type tag
+        AddTypeTag(registry, entity, type);
+        return entity;
+    }
+    
+    // Add the tag component matching a block type
+    static void AddTypeTag(entt::registry& registry, entt::entity entity, World::BlockType type) {
+        switch (type) {
+            case World::BlockType::Soil:
+                registry.emplace<SoilTag>(entity);
+                break;
+            case World::BlockType::Stone:
+                registry.emplace<StoneTag>(entity);
+                break;
+            case World::BlockType::Gold:
+                registry.emplace<GoldTag>(entity);
+                break;
+            case World::BlockType::Silver:
+                registry.emplace<SilverTag>(entity);
+                break;
+            case World::BlockType::Air:
+                break;
+        }
+    }
 };
 
 } // namespace ECS
@@ -3,17 +3,24 @@
 #include <rcamera.h>
 #include <entt/entt.hpp>
 #include "world/World.hpp"
+#include "world/ChunkPipeline.hpp"
+#include "world/AutoSaver.hpp"
 #include "ecs/components/Components.hpp"
 #include "ecs/components/CharacterComponents.hpp"
 #include "ecs/systems/WorldSystem.hpp"
 #include "ecs/systems/RenderSystem.hpp"
 #include "ecs/systems/CharacterSystem.hpp"
+#include "ecs/systems/ChunkStreamingSystem.hpp"
+#include <cmath>
 #include <iostream>
 
 // Constants for rendering
 constexpr int SCREEN_WIDTH = 1920;
 constexpr int SCREEN_HEIGHT = 1080;
 constexpr float BLOCK_SIZE = 1.0f;  // Size of each block in 3D space
+constexpr double PIPELINE_BUDGET_MS = 4.0;  // Main-thread time per frame for installing streamed chunks
+constexpr const char* SAVE_PATH = "world.vxw";  // F5 saves the world here, F9 loads it
+constexpr double AUTOSAVE_INTERVAL = 30.0;  // Seconds between background saves of unsaved edits
 
 // Camera settings
 Camera3D camera = { 0 };
@@ -23,27 +30,55 @@ bool showSurfaceOnly = false;
 bool showUndergroundOnly = false;
 int currentLayer = -1;  // -1 means show all layers
 bool wireframeMode = false;
+bool useChunkMeshes = true;  // Greedy-meshed chunks instead of one cube per entity
+bool useInstancing = false;  // One instanced cube draw for all shell blocks
+bool useBlockEntities = false;  // One entity per block instead of the VoxelWorld grid
 
 // ECS
 entt::registry registry;
 ECS::WorldSystem worldSystem;
 ECS::RenderSystem renderSystem;
 ECS::CharacterSystem characterSystem;
+ECS::ChunkStreamingSystem streamingSystem;
 
 // Character entity
 entt::entity playerCharacter = entt::null;
 bool useCharacterCamera = true;  // Toggle between free camera and character follow
 
-void InitializeCamera() {
-    camera.position = (Vector3){ 50.0f, 40.0f, 50.0f };
-    camera.target = (Vector3){ 18.0f, 18.0f, 18.0f };
+void InitializeCamera(const World::World& world) {
+    // Look at the world centre from outside its +X/+Z corner
+    Vector3 center = { world.GetWidth() * 0.5f, world.GetHeight() * 0.5f, world.GetDepth() * 0.5f };
+    camera.position = (Vector3){ center.x + 32.0f, center.y + 22.0f, center.z + 32.0f };
+    camera.target = center;
     camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
     camera.fovy = 45.0f;
     camera.projection = CAMERA_PERSPECTIVE;
 }
 
+// Hand the world to the ECS: terrain stays in the grid (hybrid) or becomes
+// one entity per block
+void LoadWorldIntoRegistry(World::World& world) {
+    if (useBlockEntities) {
+        worldSystem.PopulateFromWorld(registry, world);
+        renderSystem.ToggleWireframe(registry, wireframeMode);
+    } else {
+        worldSystem.AttachWorld(registry, world);
+    }
+}
+
+// Same for a world that was just regenerated or loaded: nothing is
+// resident yet, so entity mode starts without blocks and each chunk gets
+// its entities as the pipeline installs it (see the Drain in the loop)
+void ResetWorldInRegistry(World::World& world) {
+    if (useBlockEntities) {
+        worldSystem.ResetBlockEntities(registry, world);
+    } else {
+        worldSystem.AttachWorld(registry, world);
+    }
+}
+
 // Draw world using ECS
-void DrawWorld() {
+void DrawWorld(const World::World& world) {
     if (currentLayer >= 0) {
         // Render single layer
         renderSystem.RenderLayer(registry, currentLayer);
@@ -53,27 +88,36 @@ void DrawWorld() {
     } else if (showUndergroundOnly) {
         // Render underground only (layers 3+)
         renderSystem.RenderUnderground(registry);
+    } else if (useInstancing) {
+        // Render all shell blocks (entities or grid) with one instanced draw
+        renderSystem.RenderInstanced(registry, wireframeMode);
+    } else if (useChunkMeshes || !useBlockEntities) {
+        // Render all blocks from per-chunk meshes
+        renderSystem.RenderChunkMeshes(world, wireframeMode);
     } else {
         // Render all visible blocks
         renderSystem.Render(registry);
     }
+    
+    // Blocks being mined or falling (hybrid mode)
+    renderSystem.RenderDynamicBlocks(registry);
 }
 
 // Draw UI overlay
-void DrawUI() {
+void DrawUI(const World::World& world, const World::PipelineStats& pipeline, const World::AutoSaver& saver) {
     int uiX = 10;
     int uiY = 10;
     int lineHeight = 25;
     
     // Background panel
-    DrawRectangle(5, 5, 450, 550, ColorAlpha(BLACK, 0.7f));
+    DrawRectangle(5, 5, 450, 825, ColorAlpha(BLACK, 0.7f));
     
     // Title
     DrawText("3D VOXEL WORLD (ECS)", uiX, uiY, 24, RAYWHITE);
     uiY += lineHeight + 10;
     
     // ECS info
-    DrawText(TextFormat("Total Entities: %d", (int)registry.storage<entt::entity>().size()), 
+    DrawText(TextFormat("Total Entities: %d", (int)registry.storage<entt::entity>().free_list()), 
              uiX, uiY, 18, LIGHTGRAY);
     uiY += lineHeight;
     
@@ -88,11 +132,59 @@ void DrawUI() {
     } else if (showSurfaceOnly) {
         viewMode = "Surface Only (0-2)";
     } else if (showUndergroundOnly) {
-        viewMode = "Underground (3-35)";
+        viewMode = TextFormat("Underground (3-%d)", world.GetHeight() - 1);
     }
     DrawText(TextFormat("View: %s", viewMode), uiX, uiY, 18, YELLOW);
     uiY += lineHeight;
     
+    // Chunk meshes only back the all-layers view; the cut views draw faces
+    bool allLayers = currentLayer < 0 && !showSurfaceOnly && !showUndergroundOnly;
+    DrawText(useBlockEntities ? "Terrain: Entity per Block" : "Terrain: Voxel Grid (Hybrid)",
+             uiX, uiY, 18, LIGHTGRAY);
+    uiY += lineHeight;
+    
+    if (useInstancing && allLayers) {
+        DrawText(TextFormat("Instanced Cubes: %d", (int)renderSystem.GetInstanceCount()),
+                 uiX, uiY, 18, LIGHTGRAY);
+    } else if ((useChunkMeshes || !useBlockEntities) && allLayers) {
+        DrawText(TextFormat("Chunk Meshes: %d triangles", (int)renderSystem.GetChunkMeshTriangleCount()),
+                 uiX, uiY, 18, LIGHTGRAY);
+    } else {
+        DrawText(TextFormat("Visible Faces: %d", (int)renderSystem.GetDrawnFaceCount()),
+                 uiX, uiY, 18, LIGHTGRAY);
+    }
+    uiY += lineHeight;
+    
+    const World::ChunkCullStats& cull = renderSystem.GetCullStats();
+    DrawText(TextFormat("Chunks in View: %d / %d%s", cull.chunksSubmitted, cull.chunksTotal,
+                        renderSystem.IsFrustumCulling() ? "" : " (culling off)"),
+             uiX, uiY, 18, LIGHTGRAY);
+    uiY += lineHeight;
+    
+    const ECS::StreamingStats& streaming = streamingSystem.GetStats();
+    DrawText(TextFormat("Resident Chunks: %d (+%d, -%d, %d pending)", streaming.resident,
+                        streaming.loaded, streaming.unloaded, streaming.pending),
+             uiX, uiY, 18, LIGHTGRAY);
+    uiY += lineHeight;
+    
+    DrawText(TextFormat("Pipeline: %d queued, %d ready | gen %.2f cull %.2f mesh %.2f ms",
+                        (int)pipeline.queued, (int)pipeline.ready, pipeline.generate.averageMs,
+                        pipeline.cull.averageMs, pipeline.mesh.averageMs),
+             uiX, uiY, 18, LIGHTGRAY);
+    uiY += lineHeight;
+    
+    const World::SaveStats& save = saver.GetLastStats();
+    if (saver.GetSaveCount() > 0) {
+        DrawText(TextFormat("Last Save: %d chunks, %d KiB, %.1f ms (%.2f ms in frame)%s",
+                            (int)save.chunksWritten, (int)(save.bytesWritten / 1024), save.wallMs, save.captureMs,
+                            save.status == World::FileStatus::Ok ? "" : " FAILED"),
+                 uiX, uiY, 18, LIGHTGRAY);
+    } else {
+        DrawText(TextFormat("Last Save: none (%d chunks unsaved)", (int)world.GetUnsavedChunkCount()),
+                 uiX, uiY, 18, LIGHTGRAY);
+    }
+    uiY += lineHeight;
+    
     DrawText(TextFormat("ECS Architecture: EnTT + Raylib"), uiX, uiY, 16, GREEN);
     uiY += lineHeight + 10;
     
@@ -135,6 +227,11 @@ void DrawUI() {
     uiY += lineHeight - 5;
     DrawText("P - Print Statistics", uiX, uiY, 16, GREEN);
     uiY += lineHeight - 5;
+    DrawText(world.HasColumnRunIndex() ? "L - Column Run Index Toggle (on)" : "L - Column Run Index Toggle (off)",
+             uiX, uiY, 16, GREEN);
+    uiY += lineHeight - 5;
+    DrawText("F5/F9 - Save/Load World", uiX, uiY, 16, GREEN);
+    uiY += lineHeight - 5;
     DrawText("1 - Show All Layers", uiX, uiY, 16, SKYBLUE);
     uiY += lineHeight - 5;
     DrawText("2 - Surface Only", uiX, uiY, 16, SKYBLUE);
@@ -145,6 +242,16 @@ void DrawUI() {
     uiY += lineHeight - 5;
     DrawText("T - Wireframe Toggle", uiX, uiY, 16, SKYBLUE);
     uiY += lineHeight - 5;
+    DrawText("I - Instanced Toggle", uiX, uiY, 16, SKYBLUE);
+    uiY += lineHeight - 5;
+    DrawText("M - Chunk Meshes Toggle", uiX, uiY, 16, SKYBLUE);
+    uiY += lineHeight - 5;
+    DrawText("F - Frustum Culling Toggle", uiX, uiY, 16, SKYBLUE);
+    uiY += lineHeight - 5;
+    DrawText("E - Entity per Block Toggle", uiX, uiY, 16, SKYBLUE);
+    uiY += lineHeight - 5;
+    DrawText("X - Mine Block Below", uiX, uiY, 16, YELLOW);
+    uiY += lineHeight - 5;
     DrawText("C - Toggle Camera Mode", uiX, uiY, 16, YELLOW);
     uiY += lineHeight - 5;
     DrawText("ESC - Exit", uiX, uiY, 16, RED);
@@ -158,41 +265,55 @@ int main() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "ECS Raylib EnTT - 3D Voxel World (ECS Architecture)");
     SetTargetFPS(60);
     
-    // Initialize camera
-    InitializeCamera();
-    
     // Initialize render system
     renderSystem.SetBlockSize(BLOCK_SIZE);
     
-    // Create and generate world
+    // Create the world (noise terrain with caves and ore veins); chunks are
+    // generated as the character gets near them, so startup does not
+    // depend on the world size
     World::World world;
-    world.Generate();
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.GenerateLazily();
+    
+    // Chunks are generated and meshed on worker threads; the main thread
+    // only installs finished ones, a few milliseconds' worth per frame
+    World::ChunkPipeline chunkPipeline;
+    chunkPipeline.Reset(world);
+    streamingSystem.SetPipeline(&chunkPipeline);
+    
+    // Edits are saved in the background every AUTOSAVE_INTERVAL seconds
+    // (and on F5); the frame only pays for capturing the changed chunks
+    World::AutoSaver autoSaver(SAVE_PATH);
+    double lastSaveTime = GetTime();
+    
+    // Initialize camera and character bounds from the world size
+    InitializeCamera(world);
+    characterSystem.SetWorldBounds(world.GetWidth(), world.GetDepth());
     
     // Populate ECS registry from world
     std::cout << "Populating ECS registry..." << std::endl;
-    worldSystem.PopulateFromWorld(registry, world);
+    ResetWorldInRegistry(world);
     
-    // Print initial statistics
-    std::cout << "\n3D World generated successfully!" << std::endl;
-    world.PrintStatistics();
+    // Print initial statistics (P prints the world's, which visits every block)
+    std::cout << "\n3D World created (seed " << world.GetSeed() << ")" << std::endl;
     worldSystem.PrintStatistics(registry);
     
     // Load character
     const char* characterPath = "../src/assets/Ultimate Platformer Pack - Dec 2021/Character/glTF/Character.gltf";
-
+    
     // Pick a valid spawn column (for example, center of the world)
-    int spawnX = World::WORLD_WIDTH / 2;
-    int spawnZ = World::WORLD_DEPTH / 2;
-
+    int spawnX = world.GetWidth() / 2;
+    int spawnZ = world.GetDepth() / 2;
+    
     int surfaceY = world.GetSurfaceLevel(spawnX, spawnZ);
-
+    
     // Spawn so feet stand on top of that block
     Vector3 startPos = {
         spawnX + 0.5f,
         static_cast<float>(surfaceY) + 1.0f,   // +1.0f: top of the block
         spawnZ + 0.5f
     };
-
+    
     playerCharacter = characterSystem.CreateCharacter(registry, characterPath, startPos);
     
     if (playerCharacter == entt::null) {
@@ -216,6 +337,30 @@ int main() {
             }
         }
         
+        // Stream chunks around the character (or the free camera without one)
+        if (!streamingSystem.Update(registry, world)) {
+            streamingSystem.StreamAround(world, (int)camera.target.x, (int)camera.target.y, (int)camera.target.z);
+        }
+        // Entity mode gives each installed chunk its block entities within
+        // the same budget
+        chunkPipeline.Drain(world, PIPELINE_BUDGET_MS,
+            [&](const World::ChunkCoord& coord) {
+                if (useBlockEntities) worldSystem.PopulateChunk(registry, world, coord, wireframeMode);
+            },
+            [&](const World::ChunkCoord& coord, const World::ChunkMeshData& mesh) {
+                renderSystem.AdoptChunkMesh(world, coord, mesh);
+            });
+        World::SaveStats saveStats;
+        if (autoSaver.Poll(world, saveStats)) {
+            std::cout << "Saved " << saveStats.chunksWritten << " chunks (" << saveStats.chunksCarried
+                      << " carried over, " << saveStats.bytesWritten / 1024 << " KiB) to " << SAVE_PATH << " in "
+                      << saveStats.wallMs << " ms, " << saveStats.captureMs << " ms in frame: "
+                      << World::GetFileStatusName(saveStats.status) << std::endl;
+        }
+        if (GetTime() - lastSaveTime >= AUTOSAVE_INTERVAL && world.GetUnsavedChunkCount() > 0 && autoSaver.Save(world)) {
+            lastSaveTime = GetTime();
+        }
+        
         // Camera controls (only if not using character camera)
         if (!useCharacterCamera) {
             UpdateCamera(&camera, CAMERA_THIRD_PERSON);
@@ -226,27 +371,55 @@ int main() {
             useCharacterCamera = !useCharacterCamera;
             if (!useCharacterCamera) {
                 // Reset to free camera
-                InitializeCamera();
+                InitializeCamera(world);
             }
         }
         
         // Handle input
         if (IsKeyPressed(KEY_R)) {
             std::cout << "\nRegenerating world..." << std::endl;
-            world.Generate();
-            world.PrintStatistics();
+            world.GenerateLazily(World::World::RandomSeed());
+            chunkPipeline.Reset(world);
             
-            // Repopulate ECS registry
-            std::cout << "Repopulating ECS registry..." << std::endl;
-            worldSystem.PopulateFromWorld(registry, world);
+            // Start the ECS registry over (block entities arrive with the
+            // chunks the pipeline rebuilds around the character)
+            std::cout << "Resetting ECS registry..." << std::endl;
+            ResetWorldInRegistry(world);
             worldSystem.PrintStatistics(registry);
         }
         
+        // Save the world, or replace it with the last save (chunks are read
+        // from the file as they stream in)
+        if (IsKeyPressed(KEY_F5)) {
+            bool started = autoSaver.Save(world);
+            std::cout << "\nSaving world to " << SAVE_PATH << (started ? " in the background" : ": a save is still running")
+                      << std::endl;
+            lastSaveTime = GetTime();
+        }
+        
+        if (IsKeyPressed(KEY_F9)) {
+            autoSaver.Finish(world, saveStats);  // the save being written is what gets loaded
+            World::FileStatus status = world.Load(SAVE_PATH);
+            std::cout << "\nLoading world from " << SAVE_PATH << ": " << World::GetFileStatusName(status) << std::endl;
+            if (status == World::FileStatus::Ok) {
+                chunkPipeline.Reset(world);
+                characterSystem.SetWorldBounds(world.GetWidth(), world.GetDepth());
+                ResetWorldInRegistry(world);
+                worldSystem.PrintStatistics(registry);
+            }
+        }
+        
         if (IsKeyPressed(KEY_P)) {
             world.PrintStatistics();
             worldSystem.PrintStatistics(registry);
         }
         
+        // Column run index toggle (statistics and face counts from runs)
+        if (IsKeyPressed(KEY_L)) {
+            world.SetColumnRunIndex(!world.HasColumnRunIndex());
+            world.PrintStatistics();
+        }
+        
         // View mode controls
         if (IsKeyPressed(KEY_ONE)) {
             showSurfaceOnly = false;
@@ -293,6 +466,40 @@ int main() {
             renderSystem.ToggleWireframe(registry, wireframeMode);
         }
         
+        // Instanced rendering toggle (A/B against chunk meshes and faces)
+        if (IsKeyPressed(KEY_I)) {
+            useInstancing = !useInstancing;
+        }
+        
+        // Frustum culling toggle
+        if (IsKeyPressed(KEY_F)) {
+            renderSystem.SetFrustumCulling(!renderSystem.IsFrustumCulling());
+        }
+        
+        // Terrain model toggle (A/B of the hybrid grid against entity per block)
+        if (IsKeyPressed(KEY_E)) {
+            useBlockEntities = !useBlockEntities;
+            LoadWorldIntoRegistry(world);
+            worldSystem.PrintStatistics(registry);
+        }
+        
+        // Mine the block under the character (hybrid mode only)
+        if (IsKeyPressed(KEY_X) && playerCharacter != entt::null) {
+            const Vector3& feet = registry.get<ECS::Transform>(playerCharacter).position;
+            int x = (int)std::floor(feet.x + 0.5f);
+            int z = (int)std::floor(feet.z + 0.5f);
+            worldSystem.StartMining(registry, x, world.GetSurfaceLevel(x, z), z);
+        }
+        worldSystem.UpdateDynamicBlocks(registry, deltaTime);
+        
+        // Chunk mesh toggle
+        if (IsKeyPressed(KEY_M)) {
+            useChunkMeshes = !useChunkMeshes;
+        }
+        
+        // Pick the chunks inside the camera frustum for this frame
+        renderSystem.CullChunks(world, camera, (float)GetScreenWidth() / (float)GetScreenHeight());
+        
         // ===== DRAW =====
         
         BeginDrawing();
@@ -304,7 +511,7 @@ int main() {
         DrawGrid(40, 1.0f);
         
         // Draw the world using ECS
-        DrawWorld();
+        DrawWorld(world);
         
         // Draw character
         if (playerCharacter != entt::null) {
@@ -314,7 +521,7 @@ int main() {
         EndMode3D();
         
         // Draw UI
-        DrawUI();
+        DrawUI(world, chunkPipeline.GetStats(), autoSaver);
         
         EndDrawing();
     }
@@ -323,6 +530,8 @@ int main() {
     if (playerCharacter != entt::null) {
         characterSystem.UnloadCharacter(registry, playerCharacter);
     }
+    renderSystem.UnloadChunkMeshes();
+    renderSystem.UnloadInstancing();
     
     CloseWindow();
     
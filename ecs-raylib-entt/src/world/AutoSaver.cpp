@@ -0,0 +1,98 @@
+#include "AutoSaver.hpp"
+#include <utility>
+
+namespace World {
+
+AutoSaver::AutoSaver(std::string path, SaveMode mode)
+    : path(std::move(path)), mode(mode) {
+    writer = std::thread(&AutoSaver::WriterLoop, this);
+}
+
+AutoSaver::~AutoSaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+}
+
+bool AutoSaver::Save(World& world) {
+    if (snapshot) {
+        return false;
+    }
+    started = Clock::now();
+    snapshot = world.CaptureSave(mode);
+    captureMs = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued = snapshot;
+        written = false;
+    }
+    changed.notify_all();
+    return true;
+}
+
+bool AutoSaver::Poll(World& world, SaveStats& stats) {
+    if (!snapshot) {
+        return false;
+    }
+    std::shared_ptr<const WorldFile> file;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!written) {
+            return false;
+        }
+        stats = result;
+        file = std::move(writtenFile);
+    }
+    world.CompleteSave(*snapshot, std::move(file));
+    snapshot.reset();
+    stats.captureMs = captureMs;
+    stats.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+    last = stats;
+    ++saves;
+    return true;
+}
+
+bool AutoSaver::Finish(World& world, SaveStats& stats) {
+    if (!snapshot) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return written; });
+    }
+    return Poll(world, stats);
+}
+
+void AutoSaver::WriterLoop() {
+    for (;;) {
+        std::shared_ptr<const SaveSnapshot> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return stopping || queued; });
+            if (!queued) return;  // stopping with nothing left to write
+            job = std::move(queued);
+        }
+
+        // Encode and write, then map the file for the world to read from
+        SaveStats stats;
+        FileStatus status = World::WriteSnapshot(*job, path, &stats);
+        std::shared_ptr<const WorldFile> file;
+        if (status == FileStatus::Ok) {
+            file = WorldFile::Open(path, status);
+            stats.status = status;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = stats;
+            writtenFile = std::move(file);
+            written = true;
+        }
+        changed.notify_all();
+    }
+}
+
+} // namespace World
@@ -0,0 +1,77 @@
+#ifndef AUTO_SAVER_H
+#define AUTO_SAVER_H
+
+#include "World.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace World {
+
+// Saves a world to one path without stalling its thread. Save captures a
+// snapshot (World::CaptureSave: copy-on-write copies of the chunks changed
+// since the previous save) and hands it to a background thread, which
+// encodes and writes the file while the world keeps changing. Poll, on the
+// world's thread, completes a finished save on the world (it adopts the
+// file, so the next save again only captures what changed after it) and
+// reports its stats. One save is written at a time.
+class AutoSaver {
+public:
+    explicit AutoSaver(std::string path, SaveMode mode = SaveMode::Delta);
+    ~AutoSaver();  // finishes writing a save in progress
+
+    AutoSaver(const AutoSaver&) = delete;
+    AutoSaver& operator=(const AutoSaver&) = delete;
+
+    const std::string& GetPath() const { return path; }
+
+    // Capture the world and start writing it; false (nothing captured)
+    // while the previous save has not been polled yet
+    bool Save(World& world);
+
+    // True from Save until Poll reports that save
+    bool IsBusy() const { return snapshot != nullptr; }
+
+    // If the save in progress has finished: complete it on the world, put
+    // its stats in stats and return true
+    bool Poll(World& world, SaveStats& stats);
+
+    // Wait for the save in progress (if any), then Poll
+    bool Finish(World& world, SaveStats& stats);
+
+    // Saves completed so far and the stats of the last one
+    size_t GetSaveCount() const { return saves; }
+    const SaveStats& GetLastStats() const { return last; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string path;
+    SaveMode mode;
+
+    // Writer thread and the save handed to it
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::shared_ptr<const SaveSnapshot> queued;  // waiting for the writer
+    bool written = false;                        // the writer is done with the current save
+    bool stopping = false;
+    SaveStats result;
+    std::shared_ptr<const WorldFile> writtenFile;
+
+    // Owning-thread state
+    std::shared_ptr<const SaveSnapshot> snapshot;  // save in progress
+    Clock::time_point started;
+    double captureMs = 0.0;
+    size_t saves = 0;
+    SaveStats last;
+
+    void WriterLoop();
+};
+
+} // namespace World
+
+#endif // AUTO_SAVER_H
@@ -2,66 +2,73 @@
 #define BLOCK_H
 
 #include <raylib.h>
-#include <string>
+#include <cstdint>
 
 namespace World {
 
-// Enum representing the different block types
-enum class BlockType {
+// Enum representing the different block types (one byte per voxel in the grid)
+enum class BlockType : uint8_t {
     Soil,
     Stone,
     Gold,
-    Silver
+    Silver,
+    Air      // Empty space (unallocated chunks read as Air)
 };
 
-// Structure representing a single block in the world
+constexpr int BLOCK_TYPE_COUNT = 5;
+
+// Static per-type data, looked up instead of stored per voxel
+struct BlockProperties {
+    const char* name;
+    Color color;
+    float hardness;   // Time to mine
+    int value;        // Points/resources when mined
+};
+
+// Indexed by BlockType
+constexpr BlockProperties BLOCK_PROPERTIES[BLOCK_TYPE_COUNT] = {
+    { "Soil",   BROWN,                     0.5f,   1 },
+    { "Stone",  GRAY,                      1.5f,   5 },
+    { "Gold",   GOLD,                      2.0f, 100 },
+    { "Silver", Color{192, 192, 192, 255}, 1.8f,  50 },  // Silver color
+    { "Air",    BLANK,                     0.0f,   0 },
+};
+
+constexpr BlockProperties UNKNOWN_BLOCK_PROPERTIES = { "Unknown", WHITE, 1.0f, 0 };
+
+// Properties of a block type
+constexpr const BlockProperties& GetBlockProperties(BlockType type) {
+    return static_cast<int>(type) < BLOCK_TYPE_COUNT ? BLOCK_PROPERTIES[static_cast<int>(type)]
+                                                     : UNKNOWN_BLOCK_PROPERTIES;
+}
+
+// A block as handed out by World::GetBlock. The grid itself only stores the
+// BlockType; color and the rest resolve through BLOCK_PROPERTIES.
 struct Block {
     BlockType type;
     Color color;
-    
+
     // Constructor
-    Block(BlockType t = BlockType::Soil) : type(t) {
-        color = GetColorFromType(type);
-    }
-    
+    constexpr Block(BlockType t = BlockType::Soil) : type(t), color(GetColorFromType(t)) {}
+
     // Get color based on block type
-    static Color GetColorFromType(BlockType type) {
-        switch (type) {
-            case BlockType::Soil:
-                return BROWN;
-            case BlockType::Stone:
-                return GRAY;
-            case BlockType::Gold:
-                return GOLD;
-            case BlockType::Silver:
-                return Color{192, 192, 192, 255}; // Silver color
-            default:
-                return WHITE;
-        }
+    static constexpr Color GetColorFromType(BlockType type) {
+        return GetBlockProperties(type).color;
     }
-    
-    // Get string name of block type
-    static std::string GetTypeName(BlockType type) {
-        switch (type) {
-            case BlockType::Soil:
-                return "Soil";
-            case BlockType::Stone:
-                return "Stone";
-            case BlockType::Gold:
-                return "Gold";
-            case BlockType::Silver:
-                return "Silver";
-            default:
-                return "Unknown";
-        }
+
+    // Get name of block type (static string, no allocation)
+    static constexpr const char* GetTypeName(BlockType type) {
+        return GetBlockProperties(type).name;
     }
-    
+
     // Get the name of this block
-    std::string GetName() const {
+    constexpr const char* GetName() const {
         return GetTypeName(type);
     }
 };
 
+static_assert(sizeof(BlockType) == 1, "BlockType must stay one byte per voxel");
+
 } // namespace World
 
 #endif // BLOCK_H
@@ -0,0 +1,135 @@
+#include "BlockSampler.hpp"
+#include <algorithm>
+
+#ifdef WORLD_HAS_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef WORLD_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace World {
+
+namespace {
+
+// Rolls per batch handed from the hash kernels to the table lookup
+constexpr int BATCH = 64;
+
+void RollsScalar(const RowRandom& random, int begin, int count, uint32_t range, uint32_t* rolls) {
+    for (int i = 0; i < count; ++i) {
+        rolls[i] = random.Below(begin + i, range);
+    }
+}
+
+#ifdef WORLD_HAS_SSE2
+// Low 32 bits of a * b per lane (SSE2 has no pmulld)
+inline __m128i MulLo32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// High 32 bits of a * b per lane
+inline __m128i MulHi32(__m128i a, __m128i b) {
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), 32);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    const __m128i lowHalves = _mm_set_epi32(0, -1, 0, -1);
+    return _mm_or_si128(_mm_and_si128(even, lowHalves), _mm_andnot_si128(lowHalves, odd));
+}
+
+// RowRandom::Below for four x at a time
+void RollsSSE2(const RowRandom& random, int begin, int count, uint32_t range, uint32_t* rolls) {
+    const __m128i step = _mm_set1_epi32(static_cast<int>(RowRandom::X_STEP));
+    const __m128i key = _mm_set1_epi32(static_cast<int>(random.GetKey()));
+    const __m128i mul1 = _mm_set1_epi32(0x7FEB352D);
+    const __m128i mul2 = _mm_set1_epi32(static_cast<int>(0x846CA68Bu));
+    const __m128i scale = _mm_set1_epi32(static_cast<int>(range));
+    __m128i x = _mm_add_epi32(_mm_set1_epi32(begin), _mm_set_epi32(3, 2, 1, 0));
+    const __m128i four = _mm_set1_epi32(4);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i h = _mm_xor_si128(MulLo32(x, step), key);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        h = MulLo32(h, mul1);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+        h = MulLo32(h, mul2);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rolls + i), MulHi32(h, scale));
+        x = _mm_add_epi32(x, four);
+    }
+    RollsScalar(random, begin + i, count - i, range, rolls + i);
+}
+#endif
+
+#ifdef WORLD_HAS_AVX2
+// RowRandom::Below for eight x at a time
+__attribute__((target("avx2")))
+void RollsAVX2(const RowRandom& random, int begin, int count, uint32_t range, uint32_t* rolls) {
+    const __m256i step = _mm256_set1_epi32(static_cast<int>(RowRandom::X_STEP));
+    const __m256i key = _mm256_set1_epi32(static_cast<int>(random.GetKey()));
+    const __m256i mul1 = _mm256_set1_epi32(0x7FEB352D);
+    const __m256i mul2 = _mm256_set1_epi32(static_cast<int>(0x846CA68Bu));
+    const __m256i scale = _mm256_set1_epi32(static_cast<int>(range));
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32(begin), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    const __m256i eight = _mm256_set1_epi32(8);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i h = _mm256_xor_si256(_mm256_mullo_epi32(x, step), key);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        h = _mm256_mullo_epi32(h, mul1);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+        h = _mm256_mullo_epi32(h, mul2);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+
+        // High half of h * range: even lanes, then odd lanes, interleaved
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(h, scale), 32);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(h, 32), scale);
+        __m256i roll = _mm256_blend_epi32(even, odd, 0xAA);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rolls + i), roll);
+        x = _mm256_add_epi32(x, eight);
+    }
+    // Leave AVX state clean before the legacy-SSE code that follows
+    _mm256_zeroupper();
+    RollsScalar(random, begin + i, count - i, range, rolls + i);
+}
+#endif
+
+} // namespace
+
+BlockSampler::BlockSampler(std::initializer_list<std::pair<BlockType, uint32_t>> weights) {
+    for (const auto& [type, weight] : weights) {
+        table.insert(table.end(), weight, type);
+    }
+}
+
+void BlockSampler::SampleRow(const RowRandom& random, int begin, int end, BlockType* out, SimdLevel level) const {
+    level = std::min(level, DetectSimdLevel());
+    uint32_t range = GetRange();
+    uint32_t rolls[BATCH];
+    for (int x = begin; x < end; x += BATCH) {
+        int count = std::min(BATCH, end - x);
+        switch (level) {
+#ifdef WORLD_HAS_AVX2
+            case SimdLevel::AVX2:
+                RollsAVX2(random, x, count, range, rolls);
+                break;
+#endif
+#ifdef WORLD_HAS_SSE2
+            case SimdLevel::SSE2:
+                RollsSSE2(random, x, count, range, rolls);
+                break;
+#endif
+            default:
+                RollsScalar(random, x, count, range, rolls);
+                break;
+        }
+        for (int i = 0; i < count; ++i) {
+            *out++ = table[rolls[i]];
+        }
+    }
+}
+
+} // namespace World
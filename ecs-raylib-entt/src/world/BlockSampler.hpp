@@ -0,0 +1,48 @@
+#ifndef BLOCK_SAMPLER_H
+#define BLOCK_SAMPLER_H
+
+#include "Block.hpp"
+#include "Random.hpp"
+#include "Simd.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace World {
+
+// Draws block types from a fixed weighted distribution (e.g. 80% Soil,
+// 20% Stone). Weights become a table with one entry per unit of weight, so
+// a roll maps to its type with a single load and no compares; a whole row
+// is drawn at once, hashing eight voxels per step with SIMD.
+class BlockSampler {
+public:
+    // (type, weight) pairs; the chance of a type is its share of the total
+    BlockSampler(std::initializer_list<std::pair<BlockType, uint32_t>> weights);
+
+    // Total weight (the range rolls are drawn from)
+    uint32_t GetRange() const { return static_cast<uint32_t>(table.size()); }
+
+    // Type for a roll in [0, GetRange())
+    BlockType FromRoll(uint32_t roll) const { return table[roll]; }
+
+    // Type at x of a row
+    BlockType Sample(const RowRandom& random, int x) const {
+        return table[random.Below(x, GetRange())];
+    }
+
+    // Fill out[0, end - begin) with the types at x in [begin, end) of a
+    // row; identical to Sample for each x at every level
+    void SampleRow(const RowRandom& random, int begin, int end, BlockType* out, SimdLevel level) const;
+
+    void SampleRow(const RowRandom& random, int begin, int end, BlockType* out) const {
+        SampleRow(random, begin, end, out, DetectSimdLevel());
+    }
+
+private:
+    std::vector<BlockType> table;
+};
+
+} // namespace World
+
+#endif // BLOCK_SAMPLER_H
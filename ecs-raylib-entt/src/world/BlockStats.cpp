@@ -0,0 +1,120 @@
+#include "BlockStats.hpp"
+#include <algorithm>
+
+#ifdef WORLD_HAS_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef WORLD_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace World {
+
+namespace {
+
+// Byte accumulators overflow after 255 increments, so vector loops fold
+// them into the totals at least that often
+constexpr size_t MAX_BLOCKS_PER_FOLD = 255;
+
+void CountScalar(const uint8_t* bytes, size_t n, uint64_t* counts) {
+    uint32_t local[BLOCK_TYPE_COUNT] = {};
+    for (size_t i = 0; i < n; ++i) {
+        if (bytes[i] < BLOCK_TYPE_COUNT) ++local[bytes[i]];
+    }
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+        counts[t] += local[t];
+    }
+}
+
+#ifdef WORLD_HAS_SSE2
+// Per type: compare 16 bytes at a time against the type (0xFF on a match),
+// subtract the mask from a byte accumulator, and fold with SAD
+void CountSSE2(const uint8_t* bytes, size_t n, uint64_t* counts) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i keys[BLOCK_TYPE_COUNT];
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+        keys[t] = _mm_set1_epi8(static_cast<char>(t));
+    }
+
+    size_t i = 0;
+    while (n - i >= 16) {
+        size_t blocks = std::min((n - i) / 16, MAX_BLOCKS_PER_FOLD);
+        __m128i acc[BLOCK_TYPE_COUNT];
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) acc[t] = zero;
+
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+                acc[t] = _mm_sub_epi8(acc[t], _mm_cmpeq_epi8(v, keys[t]));
+            }
+        }
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+            __m128i sums = _mm_sad_epu8(acc[t], zero);  // two 64-bit lanes, each < 2^16
+            counts[t] += static_cast<uint64_t>(_mm_cvtsi128_si32(sums)) +
+                         static_cast<uint64_t>(_mm_extract_epi16(sums, 4));
+        }
+    }
+    CountScalar(bytes + i, n - i, counts);
+}
+#endif
+
+#ifdef WORLD_HAS_AVX2
+// Same as CountSSE2 with 32 bytes per step
+__attribute__((target("avx2")))
+void CountAVX2(const uint8_t* bytes, size_t n, uint64_t* counts) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i keys[BLOCK_TYPE_COUNT];
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+        keys[t] = _mm256_set1_epi8(static_cast<char>(t));
+    }
+
+    size_t i = 0;
+    while (n - i >= 32) {
+        size_t blocks = std::min((n - i) / 32, MAX_BLOCKS_PER_FOLD);
+        __m256i acc[BLOCK_TYPE_COUNT];
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) acc[t] = zero;
+
+        for (size_t b = 0; b < blocks; ++b, i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+            for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+                acc[t] = _mm256_sub_epi8(acc[t], _mm256_cmpeq_epi8(v, keys[t]));
+            }
+        }
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+            __m256i sums = _mm256_sad_epu8(acc[t], zero);  // four 64-bit lanes
+            __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+            counts[t] += static_cast<uint64_t>(_mm_cvtsi128_si32(pair)) +
+                         static_cast<uint64_t>(_mm_extract_epi16(pair, 4));
+        }
+    }
+    // Leave AVX state clean before any legacy-SSE code runs; GCC does not
+    // emit vzeroupper ahead of the tail call, and the transition penalty
+    // otherwise costs more than a short call's whole loop
+    _mm256_zeroupper();
+    CountSSE2(bytes + i, n - i, counts);
+}
+#endif
+
+} // namespace
+
+void CountBlockTypes(const BlockType* types, size_t n, uint64_t* counts, SimdLevel level) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(types);
+    level = std::min(level, DetectSimdLevel());
+    switch (level) {
+#ifdef WORLD_HAS_AVX2
+        case SimdLevel::AVX2:
+            CountAVX2(bytes, n, counts);
+            return;
+#endif
+#ifdef WORLD_HAS_SSE2
+        case SimdLevel::SSE2:
+            CountSSE2(bytes, n, counts);
+            return;
+#endif
+        default:
+            CountScalar(bytes, n, counts);
+            return;
+    }
+}
+
+} // namespace World
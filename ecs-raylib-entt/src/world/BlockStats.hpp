@@ -0,0 +1,53 @@
+#ifndef BLOCK_STATS_H
+#define BLOCK_STATS_H
+
+#include "Block.hpp"
+#include "Simd.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+// Add to counts[t] how many of the n types are t. The level is lowered to
+// what the CPU supports; all levels give the same counts.
+void CountBlockTypes(const BlockType* types, size_t n, uint64_t* counts, SimdLevel level);
+
+inline void CountBlockTypes(const BlockType* types, size_t n, uint64_t* counts) {
+    CountBlockTypes(types, n, counts, DetectSimdLevel());
+}
+
+// Per-type counts for one region
+using TypeCounts = std::array<uint64_t, BLOCK_TYPE_COUNT>;
+
+// Block histogram of a whole world (World::ComputeStatistics). The shell is
+// every voxel within SURFACE_LAYER_COUNT of a world face (see
+// World::IsExposedSurface); the rest is interior.
+struct BlockStatistics {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    TypeCounts counts{};
+    TypeCounts shellCounts{};
+    TypeCounts interiorCounts{};
+    std::vector<TypeCounts> layerCounts;  // one per y
+
+    uint64_t GetTotal() const { return static_cast<uint64_t>(width) * height * depth; }
+    uint64_t GetSolid() const { return Solid(counts); }
+    uint64_t GetShellSolid() const { return Solid(shellCounts); }
+    uint64_t GetInteriorSolid() const { return Solid(interiorCounts); }
+
+    // Blocks of every type but air
+    static uint64_t Solid(const TypeCounts& region) {
+        uint64_t solid = 0;
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+            if (static_cast<BlockType>(t) != BlockType::Air) solid += region[t];
+        }
+        return solid;
+    }
+};
+
+} // namespace World
+
+#endif // BLOCK_STATS_H
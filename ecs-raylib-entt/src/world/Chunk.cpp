@@ -0,0 +1,157 @@
+#include "Chunk.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+namespace World {
+
+void Chunk::Set(int lx, int ly, int lz, BlockType type) {
+    int slot = FindInPalette(type);
+    if (slot < 0) {
+        // New type: append to the palette, widening the indices if it no longer fits
+        palette.push_back(type);
+        slot = static_cast<int>(palette.size()) - 1;
+        int needed = BitsForPaletteSize(palette.size());
+        if (needed > bitsPerVoxel) {
+            Repack(needed);
+        }
+    } else if (bitsPerVoxel == 0) {
+        return;  // uniform chunk already of this type
+    }
+    UnshareIndices();
+    WriteIndex(LocalIndex(lx, ly, lz), static_cast<uint32_t>(slot));
+}
+
+void Chunk::Fill(BlockType type) {
+    palette.assign(1, type);
+    palette.shrink_to_fit();
+    indices.reset();
+    bitsPerVoxel = 0;
+}
+
+bool Chunk::Compact() {
+    if (bitsPerVoxel == 0) {
+        return true;
+    }
+
+    // Count references to each palette slot
+    std::array<int, 256> uses{};
+    for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+        uses[ReadIndex(i)]++;
+    }
+
+    size_t used = std::count_if(uses.begin(), uses.begin() + palette.size(),
+                                [](int n) { return n > 0; });
+    if (used == palette.size() && BitsForPaletteSize(used) == bitsPerVoxel) {
+        return false;
+    }
+
+    // Re-encode from the expanded contents with only the live types
+    std::vector<BlockType> types(CHUNK_VOLUME);
+    Decode(types.data());
+    Encode(types.data());
+    return bitsPerVoxel == 0;
+}
+
+void Chunk::Encode(const BlockType* types) {
+    // Map each type to a palette slot in order of first appearance
+    std::array<int16_t, 256> slotOf;
+    slotOf.fill(-1);
+    palette.clear();
+    for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+        uint8_t key = static_cast<uint8_t>(types[i]);
+        if (slotOf[key] < 0) {
+            slotOf[key] = static_cast<int16_t>(palette.size());
+            palette.push_back(types[i]);
+        }
+    }
+    palette.shrink_to_fit();
+
+    ResetIndices(BitsForPaletteSize(palette.size()));
+    if (bitsPerVoxel == 0) {
+        return;
+    }
+
+    // Pack whole words at a time: 64 / bits entries per word (fewer in the
+    // last word when the chunk is smaller than one)
+    int perWord = 64 / bitsPerVoxel;
+    size_t i = 0;
+    for (size_t w = 0; w < WordCount(bitsPerVoxel); ++w) {
+        uint64_t packed = 0;
+        int entries = static_cast<int>(std::min<size_t>(perWord, CHUNK_VOLUME - i));
+        for (int k = 0; k < entries; ++k, ++i) {
+            packed |= static_cast<uint64_t>(slotOf[static_cast<uint8_t>(types[i])]) << (k * bitsPerVoxel);
+        }
+        indices[w] = packed;
+    }
+}
+
+void Chunk::Decode(BlockType* out) const {
+    if (bitsPerVoxel == 0) {
+        std::fill(out, out + CHUNK_VOLUME, palette[0]);
+        return;
+    }
+
+    int perWord = 64 / bitsPerVoxel;
+    uint64_t mask = (uint64_t{1} << bitsPerVoxel) - 1;
+    size_t i = 0;
+    for (size_t w = 0; w < WordCount(bitsPerVoxel); ++w) {
+        uint64_t word = indices[w];
+        int entries = static_cast<int>(std::min<size_t>(perWord, CHUNK_VOLUME - i));
+        for (int k = 0; k < entries; ++k, ++i) {
+            out[i] = palette[(word >> (k * bitsPerVoxel)) & mask];
+        }
+    }
+}
+
+void Chunk::ResetIndices(int bits) {
+    bool reusable = indices && !SharesIndices() && WordCount(bits) == WordCount(bitsPerVoxel);
+    bitsPerVoxel = bits;
+    if (bits == 0) {
+        indices.reset();
+    } else if (reusable) {
+        std::fill(indices.get(), indices.get() + WordCount(bits), 0);
+    } else {
+        indices.reset(new uint64_t[WordCount(bits)]());
+    }
+}
+
+void Chunk::UnshareIndices() {
+    if (!SharesIndices()) {
+        // A copy dropped on another thread may have been the last to read
+        // the array; order its reads before our writes
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return;
+    }
+    std::shared_ptr<uint64_t[]> copy(new uint64_t[WordCount(bitsPerVoxel)]);
+    std::memcpy(copy.get(), indices.get(), WordCount(bitsPerVoxel) * sizeof(uint64_t));
+    indices = std::move(copy);
+}
+
+int Chunk::FindInPalette(BlockType type) const {
+    for (size_t i = 0; i < palette.size(); ++i) {
+        if (palette[i] == type) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void Chunk::Repack(int newBits) {
+    // A new array, so a copy sharing the old one keeps it as it was
+    std::shared_ptr<uint64_t[]> old = std::move(indices);
+    int oldBits = bitsPerVoxel;
+    ResetIndices(newBits);
+    if (newBits == 0 || oldBits == 0) {
+        return;  // every voxel is (or was) palette slot 0
+    }
+
+    uint64_t oldMask = (uint64_t{1} << oldBits) - 1;
+    for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+        size_t bit = i * oldBits;
+        WriteIndex(i, static_cast<uint32_t>((old[bit >> 6] >> (bit & 63)) & oldMask));
+    }
+}
+
+} // namespace World
@@ -0,0 +1,167 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include "Block.hpp"
+#include "VoxelLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Edge length of a chunk, set at configure time (see WORLD_CHUNK_SIZE in CMake)
+#ifndef WORLD_CHUNK_SIZE
+#define WORLD_CHUNK_SIZE 16
+#endif
+
+namespace World {
+
+constexpr int CHUNK_SIZE = WORLD_CHUNK_SIZE;
+constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// log2(CHUNK_SIZE), used to split world coordinates into chunk + local parts
+constexpr int ChunkShift() {
+    int shift = 0;
+    while ((1 << shift) < CHUNK_SIZE) ++shift;
+    return shift;
+}
+constexpr int CHUNK_SHIFT = ChunkShift();
+constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+
+static_assert((1 << CHUNK_SHIFT) == CHUNK_SIZE, "WORLD_CHUNK_SIZE must be a power of two");
+
+// Integer coordinate of a chunk (world coordinate >> CHUNK_SHIFT)
+struct ChunkCoord {
+    int x, y, z;
+
+    bool operator==(const ChunkCoord& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+    bool operator!=(const ChunkCoord& other) const { return !(*this == other); }
+};
+
+struct ChunkCoordHash {
+    size_t operator()(const ChunkCoord& c) const {
+        // Large odd multipliers spread neighbouring coordinates across buckets
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(c.x)) * 0x9E3779B185EBCA87ull;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(c.y)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(c.z)) * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+// Chunk containing a world position
+inline ChunkCoord ChunkCoordOf(int x, int y, int z) {
+    return { x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT };
+}
+
+// Slot of a local (0..CHUNK_SIZE-1) position inside a chunk
+constexpr size_t LocalIndex(int lx, int ly, int lz) {
+    return LinearIndex<GRID_LAYOUT>(lx, ly, lz, CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+}
+
+// A CHUNK_SIZE^3 block of voxels, palette-compressed: the chunk keeps a
+// small palette of the types it contains plus one 1/2/4/8-bit palette index
+// per voxel. Chunks made of a single type (solid Stone interior, open air)
+// keep just the palette entry and no index array at all. The index width
+// grows automatically when a write brings in a type the palette lacks.
+//
+// Copies share the index array until one of them is written to (copy on
+// write), so copying a chunk costs its palette only. A copy may be read on
+// another thread while the original keeps changing; the original takes a
+// private array on its first write.
+class Chunk {
+public:
+    explicit Chunk(BlockType fill = BlockType::Air) : palette{ fill }, bitsPerVoxel(0) {}
+
+    BlockType Get(int lx, int ly, int lz) const {
+        if (bitsPerVoxel == 0) {
+            return palette[0];
+        }
+        return palette[ReadIndex(LocalIndex(lx, ly, lz))];
+    }
+
+    // Write one voxel, growing the palette/index width if needed
+    void Set(int lx, int ly, int lz, BlockType type);
+
+    // Make the whole chunk a single type and release the index array
+    void Fill(BlockType type);
+
+    // Drop palette entries no longer referenced and narrow the index width.
+    // Returns true if the chunk is uniform afterwards.
+    bool Compact();
+
+    // Replace the contents with CHUNK_VOLUME types in LocalIndex order,
+    // picking the smallest palette and index width that fits
+    void Encode(const BlockType* types);
+
+    // Expand the contents to CHUNK_VOLUME types in LocalIndex order
+    void Decode(BlockType* out) const;
+
+    bool IsUniform() const { return bitsPerVoxel == 0; }
+    BlockType GetUniformType() const { return palette[0]; }
+
+    // Palette inspection
+    int GetPaletteSize() const { return static_cast<int>(palette.size()); }
+    int GetBitsPerVoxel() const { return bitsPerVoxel; }
+
+    // Change counter assigned by the owning World; consumers (meshes, caches)
+    // compare it against the value they were built from
+    uint64_t GetRevision() const { return revision; }
+    void SetRevision(uint64_t value) { revision = value; }
+
+    // Heap bytes used by this chunk's palette and index array (a shared
+    // array counts for every chunk sharing it)
+    size_t MemoryUsage() const {
+        return palette.capacity() * sizeof(BlockType) + WordCount(bitsPerVoxel) * sizeof(uint64_t);
+    }
+
+    // True if the index array is shared with a copy
+    bool SharesIndices() const { return indices && indices.use_count() > 1; }
+
+private:
+    std::vector<BlockType> palette;       // palette[0] is the fill type when uniform
+    std::shared_ptr<uint64_t[]> indices;  // bit-packed palette indices, null when uniform
+    int bitsPerVoxel;                     // 0 (uniform), 1, 2, 4 or 8
+    uint64_t revision = 0;
+
+    // Words holding the indices, rounded up (a 2^3 chunk at 1 bit is 8 bits)
+    static constexpr size_t WordCount(int bits) {
+        return (static_cast<size_t>(CHUNK_VOLUME) * bits + 63) / 64;
+    }
+
+    uint32_t ReadIndex(size_t slot) const {
+        size_t bit = slot * bitsPerVoxel;
+        uint64_t mask = (uint64_t{1} << bitsPerVoxel) - 1;
+        return static_cast<uint32_t>((indices[bit >> 6] >> (bit & 63)) & mask);
+    }
+
+    void WriteIndex(size_t slot, uint32_t value) {
+        size_t bit = slot * bitsPerVoxel;
+        uint64_t mask = (uint64_t{1} << bitsPerVoxel) - 1;
+        uint64_t& word = indices[bit >> 6];
+        word = (word & ~(mask << (bit & 63))) | (static_cast<uint64_t>(value) << (bit & 63));
+    }
+
+    // Zeroed index array for a width: the current one when no copy shares
+    // it and the size fits, else a new one
+    void ResetIndices(int bits);
+
+    // Take a private copy of the index array before writing to it
+    void UnshareIndices();
+
+    // Palette slot of a type, or -1
+    int FindInPalette(BlockType type) const;
+
+    // Repack the index array at a new width (0 drops it)
+    void Repack(int newBits);
+};
+
+// Smallest supported index width (0, 1, 2, 4, 8) for a palette size
+constexpr int BitsForPaletteSize(size_t size) {
+    return size <= 1 ? 0 : size <= 2 ? 1 : size <= 4 ? 2 : size <= 16 ? 4 : 8;
+}
+
+} // namespace World
+
+#endif // CHUNK_H
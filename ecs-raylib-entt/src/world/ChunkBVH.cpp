@@ -0,0 +1,166 @@
+#include "ChunkBVH.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace World {
+
+namespace {
+
+// Chunks per leaf
+constexpr int LEAF_SIZE = 4;
+
+BoundingBox Merge(const BoundingBox& a, const BoundingBox& b) {
+    return {
+        { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+        { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) },
+    };
+}
+
+float Axis(const Vector3& v, int axis) {
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+} // namespace
+
+BoundingBox ChunkBVH::ChunkBounds(const ChunkCoord& coord, int width, int height, int depth) {
+    int x0 = coord.x << CHUNK_SHIFT;
+    int y0 = coord.y << CHUNK_SHIFT;
+    int z0 = coord.z << CHUNK_SHIFT;
+    int x1 = std::min(x0 + CHUNK_SIZE, width);
+    int y1 = std::min(y0 + CHUNK_SIZE, height);
+    int z1 = std::min(z0 + CHUNK_SIZE, depth);
+    return {
+        { x0 - 0.5f, y0 - 0.5f, z0 - 0.5f },
+        { x1 - 0.5f, y1 - 0.5f, z1 - 0.5f },
+    };
+}
+
+void ChunkBVH::Build(const World& world) {
+    std::vector<ChunkCoord> coords;
+    world.GetLoadedChunks(coords);
+    Build(coords, world.GetWidth(), world.GetHeight(), world.GetDepth());
+    builtLayout = world.GetChunkLayoutRevision();
+}
+
+void ChunkBVH::Build(const std::vector<ChunkCoord>& coords, int width, int height, int depth) {
+    builtWidth = width;
+    builtHeight = height;
+    builtDepth = depth;
+    builtLayout = 0;
+
+    items = coords;
+    itemBounds.clear();
+    itemBounds.reserve(items.size());
+    for (const ChunkCoord& coord : items) {
+        itemBounds.push_back(ChunkBounds(coord, width, height, depth));
+    }
+
+    nodes.clear();
+    if (items.empty()) return;
+    nodes.reserve(2 * (items.size() / LEAF_SIZE + 1));
+    BuildNode(0, static_cast<int>(items.size()));
+}
+
+int ChunkBVH::BuildNode(int first, int count) {
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back({});
+
+    BoundingBox bounds = itemBounds[first];
+    for (int i = first + 1; i < first + count; ++i) {
+        bounds = Merge(bounds, itemBounds[i]);
+    }
+
+    if (count <= LEAF_SIZE) {
+        nodes[index] = { bounds, first, count, -1, -1 };
+        return index;
+    }
+
+    // Split at the median of the longest axis
+    Vector3 extent = Vector3{ bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), first);
+    int half = count / 2;
+    std::nth_element(order.begin(), order.begin() + half, order.end(), [&](int a, int b) {
+        return Axis(itemBounds[a].min, axis) + Axis(itemBounds[a].max, axis) <
+               Axis(itemBounds[b].min, axis) + Axis(itemBounds[b].max, axis);
+    });
+
+    // Apply the partition to the item arrays
+    std::vector<ChunkCoord> sortedItems(count);
+    std::vector<BoundingBox> sortedBounds(count);
+    for (int i = 0; i < count; ++i) {
+        sortedItems[i] = items[order[i]];
+        sortedBounds[i] = itemBounds[order[i]];
+    }
+    std::copy(sortedItems.begin(), sortedItems.end(), items.begin() + first);
+    std::copy(sortedBounds.begin(), sortedBounds.end(), itemBounds.begin() + first);
+
+    int left = BuildNode(first, half);
+    int right = BuildNode(first + half, count - half);
+    nodes[index] = { bounds, first, 0, left, right };
+    return index;
+}
+
+bool ChunkBVH::IsBuiltFor(const World& world) const {
+    return builtWidth == world.GetWidth() && builtHeight == world.GetHeight() &&
+           builtDepth == world.GetDepth() && items.size() == world.GetChunkCount() &&
+           builtLayout == world.GetChunkLayoutRevision();
+}
+
+size_t ChunkBVH::Query(const Frustum& frustum, std::vector<ChunkCoord>& out, ChunkCullStats* stats) const {
+    ChunkCullStats local;
+    local.chunksTotal = static_cast<int>(items.size());
+    size_t before = out.size();
+
+    if (!nodes.empty()) {
+        // Each entry carries the planes its parent still straddled
+        struct Entry { int node; uint8_t planes; };
+        Entry stack[64];
+        int top = 0;
+        stack[top++] = { 0, ALL_FRUSTUM_PLANES };
+        while (top > 0) {
+            Entry entry = stack[--top];
+            const Node& node = nodes[entry.node];
+            ++local.nodesVisited;
+
+            uint8_t planes = entry.planes;
+            Containment containment = ClassifyAABB(frustum, node.bounds, planes);
+            if (containment == Containment::Outside) continue;
+            if (containment == Containment::Inside) {
+                CollectAll(entry.node, out);
+                continue;
+            }
+
+            if (node.count > 0) {
+                for (int i = node.first; i < node.first + node.count; ++i) {
+                    ++local.chunksTested;
+                    uint8_t itemPlanes = planes;
+                    if (ClassifyAABB(frustum, itemBounds[i], itemPlanes) != Containment::Outside) {
+                        out.push_back(items[i]);
+                    }
+                }
+            } else {
+                stack[top++] = { node.left, planes };
+                stack[top++] = { node.right, planes };
+            }
+        }
+    }
+
+    local.chunksSubmitted = static_cast<int>(out.size() - before);
+    if (stats) *stats = local;
+    return out.size() - before;
+}
+
+void ChunkBVH::CollectAll(int index, std::vector<ChunkCoord>& out) const {
+    const Node& node = nodes[index];
+    if (node.count > 0) {
+        out.insert(out.end(), items.begin() + node.first, items.begin() + node.first + node.count);
+    } else {
+        CollectAll(node.left, out);
+        CollectAll(node.right, out);
+    }
+}
+
+} // namespace World
@@ -0,0 +1,73 @@
+#ifndef CHUNK_BVH_H
+#define CHUNK_BVH_H
+
+#include "World.hpp"
+#include "Frustum.hpp"
+#include <vector>
+
+namespace World {
+
+// Counters from one ChunkBVH::Query
+struct ChunkCullStats {
+    int nodesVisited = 0;     // BVH nodes tested against the frustum
+    int chunksTested = 0;     // chunk boxes tested individually in leaves
+    int chunksSubmitted = 0;  // chunks that survived
+    int chunksTotal = 0;      // chunks in the hierarchy
+};
+
+// Bounding volume hierarchy over the allocated chunks of a world, used for
+// frustum culling. Built by median splits along the longest axis; a node
+// fully inside the frustum accepts its whole subtree without further tests
+// and a node fully outside rejects it; children skip the planes their
+// parent was already inside. Chunk boxes only depend on chunk
+// coordinates and world bounds, so the tree survives regeneration and only
+// needs rebuilding when chunks are allocated or dropped (including chunks
+// streamed in and out of a lazy world) or the world is cleared.
+class ChunkBVH {
+public:
+    // Build over every allocated chunk of the world
+    void Build(const World& world);
+
+    // Build over an explicit set of chunks inside the given world bounds
+    void Build(const std::vector<ChunkCoord>& coords, int width, int height, int depth);
+
+    // True if the tree was built for the world's current chunk set
+    bool IsBuiltFor(const World& world) const;
+
+    // Append the chunks intersecting the frustum to out; returns how many
+    size_t Query(const Frustum& frustum, std::vector<ChunkCoord>& out, ChunkCullStats* stats = nullptr) const;
+
+    size_t GetChunkCount() const { return items.size(); }
+    size_t GetNodeCount() const { return nodes.size(); }
+
+    // World-space box of a chunk's blocks (block (x, y, z) is centred on
+    // (x, y, z)), clipped to the world bounds
+    static BoundingBox ChunkBounds(const ChunkCoord& coord, int width, int height, int depth);
+
+private:
+    // Leaves hold count > 0 items starting at first; inner nodes have two children
+    struct Node {
+        BoundingBox bounds;
+        int first;
+        int count;
+        int left;
+        int right;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<ChunkCoord> items;
+    std::vector<BoundingBox> itemBounds;
+    int builtWidth = 0;
+    int builtHeight = 0;
+    int builtDepth = 0;
+    uint64_t builtLayout = 0;  // World::GetChunkLayoutRevision at Build
+
+    int BuildNode(int first, int count);
+
+    // Add every chunk under a node without testing it
+    void CollectAll(int node, std::vector<ChunkCoord>& out) const;
+};
+
+} // namespace World
+
+#endif // CHUNK_BVH_H
@@ -0,0 +1,195 @@
+#include "ChunkMesher.hpp"
+
+namespace World {
+
+namespace {
+
+constexpr int PADDED = PADDED_CHUNK_SIZE;
+
+// Cheap per-direction shading so faces read without lighting
+float FaceShade(int axis, int dir) {
+    if (axis == 1) return dir > 0 ? 1.0f : 0.55f;
+    return axis == 0 ? 0.8f : 0.9f;
+}
+
+void EmitQuad(ChunkMeshData& out, const float origin[3], int axis, int dir,
+              int w, int h, BlockType type) {
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    float du[3] = { 0, 0, 0 };
+    float dv[3] = { 0, 0, 0 };
+    du[u] = static_cast<float>(w);
+    dv[v] = static_cast<float>(h);
+
+    // Counter-clockwise seen from the side the normal points to (u x v = +axis)
+    float corners[4][3];
+    for (int k = 0; k < 3; ++k) {
+        corners[0][k] = origin[k];
+        corners[2][k] = origin[k] + du[k] + dv[k];
+        if (dir > 0) {
+            corners[1][k] = origin[k] + du[k];
+            corners[3][k] = origin[k] + dv[k];
+        } else {
+            corners[1][k] = origin[k] + dv[k];
+            corners[3][k] = origin[k] + du[k];
+        }
+    }
+
+    Color color = GetBlockProperties(type).color;
+    float shade = FaceShade(axis, dir);
+    unsigned char r = static_cast<unsigned char>(color.r * shade);
+    unsigned char g = static_cast<unsigned char>(color.g * shade);
+    unsigned char b = static_cast<unsigned char>(color.b * shade);
+
+    unsigned short first = static_cast<unsigned short>(out.GetVertexCount());
+    for (int c = 0; c < 4; ++c) {
+        for (int k = 0; k < 3; ++k) {
+            out.vertices.push_back(corners[c][k]);
+            out.normals.push_back(k == axis ? static_cast<float>(dir) : 0.0f);
+        }
+        out.colors.push_back(r);
+        out.colors.push_back(g);
+        out.colors.push_back(b);
+        out.colors.push_back(color.a);
+    }
+
+    const unsigned short quad[6] = { 0, 1, 2, 0, 2, 3 };
+    for (unsigned short i : quad) {
+        out.indices.push_back(static_cast<unsigned short>(first + i));
+    }
+}
+
+} // namespace
+
+void FillPaddedChunk(const World& world, const ChunkCoord& coord, const BlockType* local, BlockType* padded) {
+    int baseX = coord.x << CHUNK_SHIFT;
+    int baseY = coord.y << CHUNK_SHIFT;
+    int baseZ = coord.z << CHUNK_SHIFT;
+
+    for (int y = 0; y < PADDED; ++y) {
+        for (int z = 0; z < PADDED; ++z) {
+            for (int x = 0; x < PADDED; ++x) {
+                int lx = x - 1, ly = y - 1, lz = z - 1;
+                bool inside = lx >= 0 && lx < CHUNK_SIZE && ly >= 0 && ly < CHUNK_SIZE &&
+                              lz >= 0 && lz < CHUNK_SIZE;
+                BlockType type = BlockType::Air;
+                int wx = baseX + lx, wy = baseY + ly, wz = baseZ + lz;
+                if (!world.IsValidPosition(wx, wy, wz)) {
+                    type = BlockType::Air;  // the world boundary is open
+                } else if (inside) {
+                    type = local[LocalIndex(lx, ly, lz)];
+                } else {
+                    type = world.GetBlockType(wx, wy, wz);
+                }
+                padded[PaddedIndex(x, y, z)] = type;
+            }
+        }
+    }
+}
+
+size_t CountVisibleFaces(const BlockType* padded) {
+    static constexpr int STEP[3] = { 1, PADDED * PADDED, PADDED };  // x, y, z in PaddedIndex
+    size_t faces = 0;
+    for (int y = 1; y <= CHUNK_SIZE; ++y) {
+        for (int z = 1; z <= CHUNK_SIZE; ++z) {
+            for (int x = 1; x <= CHUNK_SIZE; ++x) {
+                int index = PaddedIndex(x, y, z);
+                if (padded[index] == BlockType::Air) continue;
+                for (int axis = 0; axis < 3; ++axis) {
+                    faces += padded[index - STEP[axis]] == BlockType::Air;
+                    faces += padded[index + STEP[axis]] == BlockType::Air;
+                }
+            }
+        }
+    }
+    return faces;
+}
+
+void BuildChunkMesh(const World& world, const ChunkCoord& coord, ChunkMeshData& out) {
+    // Empty and buried chunks have no faces; skip decoding them
+    if (world.IsChunkHidden(coord)) {
+        out.Clear();
+        return;
+    }
+    std::vector<BlockType> local(CHUNK_VOLUME);
+    std::vector<BlockType> padded(PADDED_CHUNK_VOLUME);
+    world.GetChunkTypes(coord, local.data());
+    FillPaddedChunk(world, coord, local.data(), padded.data());
+    BuildChunkMesh(padded.data(), coord, out);
+}
+
+void BuildChunkMesh(const BlockType* padded, const ChunkCoord& coord, ChunkMeshData& out) {
+    out.Clear();
+
+    int base[3] = { coord.x << CHUNK_SHIFT, coord.y << CHUNK_SHIFT, coord.z << CHUNK_SHIFT };
+    std::vector<BlockType> mask(CHUNK_SIZE * CHUNK_SIZE);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+
+        for (int dir = -1; dir <= 1; dir += 2) {
+            for (int slice = 0; slice < CHUNK_SIZE; ++slice) {
+                // Mask of visible faces in this slice, keyed by block type
+                bool any = false;
+                for (int j = 0; j < CHUNK_SIZE; ++j) {
+                    for (int i = 0; i < CHUNK_SIZE; ++i) {
+                        int q[3];
+                        q[axis] = slice; q[u] = i; q[v] = j;
+                        int n[3] = { q[0], q[1], q[2] };
+                        n[axis] += dir;
+
+                        BlockType self = padded[PaddedIndex(q[0] + 1, q[1] + 1, q[2] + 1)];
+                        BlockType next = padded[PaddedIndex(n[0] + 1, n[1] + 1, n[2] + 1)];
+                        bool visible = self != BlockType::Air && next == BlockType::Air;
+                        mask[j * CHUNK_SIZE + i] = visible ? self : BlockType::Air;
+                        any |= visible;
+                    }
+                }
+                if (!any) continue;
+
+                // Greedily grow rectangles of equal type along u, then v
+                for (int j = 0; j < CHUNK_SIZE; ++j) {
+                    for (int i = 0; i < CHUNK_SIZE; ) {
+                        BlockType type = mask[j * CHUNK_SIZE + i];
+                        if (type == BlockType::Air) {
+                            ++i;
+                            continue;
+                        }
+
+                        int w = 1;
+                        while (i + w < CHUNK_SIZE && mask[j * CHUNK_SIZE + i + w] == type) ++w;
+
+                        int h = 1;
+                        for (; j + h < CHUNK_SIZE; ++h) {
+                            bool rowMatches = true;
+                            for (int k = 0; k < w; ++k) {
+                                if (mask[(j + h) * CHUNK_SIZE + i + k] != type) {
+                                    rowMatches = false;
+                                    break;
+                                }
+                            }
+                            if (!rowMatches) break;
+                        }
+
+                        float origin[3];
+                        origin[axis] = base[axis] + slice + 0.5f * dir;
+                        origin[u] = base[u] + i - 0.5f;
+                        origin[v] = base[v] + j - 0.5f;
+                        EmitQuad(out, origin, axis, dir, w, h, type);
+
+                        for (int dy = 0; dy < h; ++dy) {
+                            for (int dx = 0; dx < w; ++dx) {
+                                mask[(j + dy) * CHUNK_SIZE + i + dx] = BlockType::Air;
+                            }
+                        }
+                        i += w;
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace World
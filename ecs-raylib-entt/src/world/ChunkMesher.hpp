@@ -0,0 +1,64 @@
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include "World.hpp"
+#include <vector>
+
+namespace World {
+
+// CPU-side geometry for one chunk, laid out the way raylib's Mesh expects:
+// 3 floats per vertex position/normal, 4 bytes per vertex color and
+// 6 indices (two triangles) per quad. Positions are in block units with
+// block (x, y, z) centred on (x, y, z), matching DrawCubeV.
+struct ChunkMeshData {
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    std::vector<unsigned char> colors;
+    std::vector<unsigned short> indices;
+
+    int GetVertexCount() const { return static_cast<int>(vertices.size() / 3); }
+    int GetQuadCount() const { return GetVertexCount() / 4; }
+    int GetTriangleCount() const { return GetQuadCount() * 2; }
+    bool IsEmpty() const { return vertices.empty(); }
+
+    void Clear() {
+        vertices.clear();
+        normals.clear();
+        colors.clear();
+        indices.clear();
+    }
+};
+
+// A chunk plus a one-voxel border taken from the neighbouring chunks, in
+// (y, z, x) order; padded (x, y, z) is local (x - 1, y - 1, z - 1)
+constexpr int PADDED_CHUNK_SIZE = CHUNK_SIZE + 2;
+constexpr int PADDED_CHUNK_VOLUME = PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE;
+
+inline int PaddedIndex(int x, int y, int z) {
+    return (y * PADDED_CHUNK_SIZE + z) * PADDED_CHUNK_SIZE + x;
+}
+
+// Fill a padded chunk from the chunk's own blocks (CHUNK_VOLUME types in
+// LocalIndex order) and a border read through the world. Voxels outside
+// the world are air, so the world boundary shows faces.
+void FillPaddedChunk(const World& world, const ChunkCoord& coord, const BlockType* local, BlockType* padded);
+
+// Faces of a padded chunk's blocks that touch air (0: nothing to mesh)
+size_t CountVisibleFaces(const BlockType* padded);
+
+// Build the mesh for one chunk with greedy meshing: faces between a solid
+// block and air (or the world boundary) are kept, hidden faces are culled,
+// and coplanar visible faces of the same type are merged into rectangles.
+// Neighbouring chunks are read through the world so faces on chunk
+// borders are culled correctly. Chunks World::IsChunkHidden reports (all
+// air, or solid inside solid) get an empty mesh without being decoded.
+// Pure CPU; needs no GPU context.
+void BuildChunkMesh(const World& world, const ChunkCoord& coord, ChunkMeshData& out);
+
+// Same, from an already filled padded chunk. Only reads the buffer, so it
+// can run on any thread.
+void BuildChunkMesh(const BlockType* padded, const ChunkCoord& coord, ChunkMeshData& out);
+
+} // namespace World
+
+#endif // CHUNK_MESHER_H
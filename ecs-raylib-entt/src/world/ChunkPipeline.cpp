@@ -0,0 +1,156 @@
+#include "ChunkPipeline.hpp"
+#include <algorithm>
+
+namespace World {
+
+void ChunkPipeline::StageCounter::Add(Clock::duration elapsed) {
+    uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    totalNs.fetch_add(ns, std::memory_order_relaxed);
+    samples.fetch_add(1, std::memory_order_relaxed);
+    uint64_t seen = maxNs.load(std::memory_order_relaxed);
+    while (ns > seen && !maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+}
+
+StageLatency ChunkPipeline::StageCounter::Snapshot() const {
+    StageLatency latency;
+    latency.samples = samples.load(std::memory_order_relaxed);
+    if (latency.samples > 0) {
+        latency.averageMs = totalNs.load(std::memory_order_relaxed) * 1e-6 / latency.samples;
+        latency.maxMs = maxNs.load(std::memory_order_relaxed) * 1e-6;
+    }
+    return latency;
+}
+
+ChunkPipeline::ChunkPipeline(int threads) {
+    for (int t = 0; t < std::max(threads, 1); ++t) {
+        workers.emplace_back(&ChunkPipeline::WorkerLoop, this);
+    }
+}
+
+ChunkPipeline::~ChunkPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ChunkPipeline::DefaultWorkerCount() {
+    return std::max(1, World::DefaultThreadCount() - 1);
+}
+
+void ChunkPipeline::Reset(const World& world) {
+    generator = world.CopySource();
+    epoch.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        discarded += jobs.size();
+        jobs.clear();
+    }
+    inFlight.clear();
+}
+
+bool ChunkPipeline::Request(const ChunkCoord& coord) {
+    if (!generator || !generator->IsValidChunk(coord) || !inFlight.insert(coord).second) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back({ coord, epoch.load(std::memory_order_relaxed), generator, Clock::now() });
+    }
+    jobReady.notify_one();
+    return true;
+}
+
+void ChunkPipeline::WorkerLoop() {
+    std::vector<BlockType> padded(PADDED_CHUNK_VOLUME);
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        // Superseded by a Reset while queued
+        if (job.epoch != epoch.load(std::memory_order_acquire)) continue;
+
+        Result result;
+        result.coord = job.coord;
+        result.epoch = job.epoch;
+        Clock::time_point started = Clock::now();
+        waitLatency.Add(started - job.queuedAt);
+
+        // Stage 1: blocks from the seed (or the save file)
+        result.types.resize(CHUNK_VOLUME);
+        job.generator->GetChunkTypes(job.coord, result.types.data());
+        Clock::time_point generated = Clock::now();
+        generateLatency.Add(generated - started);
+
+        // Stage 2: border from the generator, then face culling
+        FillPaddedChunk(*job.generator, job.coord, result.types.data(), padded.data());
+        size_t faces = CountVisibleFaces(padded.data());
+        Clock::time_point culled = Clock::now();
+        cullLatency.Add(culled - generated);
+
+        // Stage 3: greedy mesh
+        if (faces > 0) {
+            BuildChunkMesh(padded.data(), job.coord, result.mesh);
+            meshLatency.Add(Clock::now() - culled);
+        }
+
+        results.Push(std::move(result));
+    }
+}
+
+bool ChunkPipeline::Install(World& world, const Result& result) {
+    if (result.epoch != epoch.load(std::memory_order_relaxed)) {
+        ++discarded;
+        return false;
+    }
+    inFlight.erase(result.coord);
+
+    // Already made resident (and maybe edited) since it was requested
+    if (world.GetChunk(result.coord) || !world.LoadChunk(result.coord, result.types.data())) {
+        ++discarded;
+        return false;
+    }
+    ++completed;
+    return true;
+}
+
+bool ChunkPipeline::IsMeshCurrent(const World& world, const ChunkCoord& coord) {
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int dir = -1; dir <= 1; dir += 2) {
+            ChunkCoord neighbour = coord;
+            (axis == 0 ? neighbour.x : axis == 1 ? neighbour.y : neighbour.z) += dir;
+            if (world.IsChunkModified(neighbour)) return false;
+        }
+    }
+    return true;
+}
+
+PipelineStats ChunkPipeline::GetStats() const {
+    PipelineStats stats;
+    stats.inFlight = inFlight.size();
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stats.queued = jobs.size();
+    }
+    stats.ready = results.Size();
+    stats.completed = completed;
+    stats.discarded = discarded;
+    stats.wait = waitLatency.Snapshot();
+    stats.generate = generateLatency.Snapshot();
+    stats.cull = cullLatency.Snapshot();
+    stats.mesh = meshLatency.Snapshot();
+    stats.drain = drainLatency.Snapshot();
+    return stats;
+}
+
+} // namespace World
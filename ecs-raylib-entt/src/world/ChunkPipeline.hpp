@@ -0,0 +1,177 @@
+#ifndef CHUNK_PIPELINE_H
+#define CHUNK_PIPELINE_H
+
+#include "World.hpp"
+#include "ChunkMesher.hpp"
+#include "MpscQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace World {
+
+// Latency of one pipeline stage
+struct StageLatency {
+    double averageMs = 0.0;
+    double maxMs = 0.0;
+    size_t samples = 0;
+};
+
+// Snapshot of a ChunkPipeline's counters
+struct PipelineStats {
+    size_t inFlight = 0;    // requested and not drained yet
+    size_t queued = 0;      // waiting for a worker
+    size_t ready = 0;       // finished, waiting in the result queue
+    size_t completed = 0;   // installed into the world by Drain
+    size_t discarded = 0;   // results dropped (world reset, or the chunk was already resident)
+    StageLatency wait;      // request to a worker picking it up
+    StageLatency generate;  // block generation
+    StageLatency cull;      // padded fill and face culling
+    StageLatency mesh;      // greedy meshing (chunks with visible faces only)
+    StageLatency drain;     // main-thread install per Drain call
+};
+
+// Builds chunks of a lazy world off the main thread. Each requested chunk
+// goes through three stages on a worker: generation from the seed, face
+// culling over the chunk and its generated border (chunks with nothing
+// visible skip the last stage) and greedy meshing. Finished chunks land
+// in a lock-free single-consumer queue; the main thread drains it under a
+// time budget, installing blocks into the world and handing each mesh to
+// the caller (for GPU upload), so frame time stays flat while terrain
+// streams in. Workers only read a private source copy of the world
+// (World::CopySource: same bounds, seed, generator and save file), never
+// the world itself.
+class ChunkPipeline {
+public:
+    explicit ChunkPipeline(int threads = DefaultWorkerCount());
+    ~ChunkPipeline();
+
+    ChunkPipeline(const ChunkPipeline&) = delete;
+    ChunkPipeline& operator=(const ChunkPipeline&) = delete;
+
+    // Workers to use: one per hardware thread, leaving one for the main thread
+    static int DefaultWorkerCount();
+
+    // Start over for a world (its bounds and current seed); call after the
+    // world is regenerated or loaded. Queued requests and unfinished results for the
+    // previous world are dropped.
+    void Reset(const World& world);
+
+    // Queue a chunk; false if it is outside the world or already in flight
+    bool Request(const ChunkCoord& coord);
+
+    // True if the chunk was requested and not drained yet
+    bool IsPending(const ChunkCoord& coord) const { return inFlight.count(coord) != 0; }
+
+    // Nothing requested is outstanding
+    bool IsIdle() const { return inFlight.empty(); }
+
+    // Install finished chunks into the world until budgetMs has passed (at
+    // least one per call if any is ready), calling
+    // onMesh(coord, const ChunkMeshData&) for each installed chunk whose
+    // mesh is still right (empty for chunks with nothing visible); chunks
+    // next to an edited chunk are left to be meshed from the world.
+    // Returns the number of chunks installed.
+    template <typename Fn>
+    size_t Drain(World& world, double budgetMs, Fn&& onMesh) {
+        return Drain(world, budgetMs, [](const ChunkCoord&) {}, onMesh);
+    }
+
+    // Same, also calling onInstall(coord) for every installed chunk, stale
+    // mesh or not, before its onMesh; its time counts against the budget
+    template <typename InstallFn, typename MeshFn>
+    size_t Drain(World& world, double budgetMs, InstallFn&& onInstall, MeshFn&& onMesh) {
+        Clock::time_point start = Clock::now();
+        size_t installed = 0;
+        Result result;
+        while (results.TryPop(result)) {
+            if (Install(world, result)) {
+                ++installed;
+                onInstall(result.coord);
+                if (IsMeshCurrent(world, result.coord)) {
+                    onMesh(result.coord, result.mesh);
+                }
+            }
+            if (Clock::now() - start >= std::chrono::duration<double, std::milli>(budgetMs)) break;
+        }
+        if (installed > 0) {
+            drainLatency.Add(Clock::now() - start);
+        }
+        return installed;
+    }
+
+    // Current counters
+    PipelineStats GetStats() const;
+
+    int GetWorkerCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        ChunkCoord coord;
+        uint64_t epoch;
+        std::shared_ptr<const World> generator;
+        Clock::time_point queuedAt;
+    };
+
+    struct Result {
+        ChunkCoord coord{};
+        uint64_t epoch = 0;
+        std::vector<BlockType> types;
+        ChunkMeshData mesh;
+    };
+
+    // Lock-free running totals for one stage
+    struct StageCounter {
+        std::atomic<uint64_t> totalNs{ 0 };
+        std::atomic<uint64_t> maxNs{ 0 };
+        std::atomic<uint64_t> samples{ 0 };
+
+        void Add(Clock::duration elapsed);
+        StageLatency Snapshot() const;
+    };
+
+    // Workers and their job queue
+    std::vector<std::thread> workers;
+    mutable std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    bool stopping = false;
+
+    // Finished chunks, consumed by Drain on the owning thread
+    MpscQueue<Result> results;
+
+    // Owning-thread state: the generator for the current epoch and the
+    // chunks requested under it
+    std::shared_ptr<const World> generator;
+    std::atomic<uint64_t> epoch{ 0 };
+    std::unordered_set<ChunkCoord, ChunkCoordHash> inFlight;
+    size_t completed = 0;
+    size_t discarded = 0;
+
+    StageCounter waitLatency;
+    StageCounter generateLatency;
+    StageCounter cullLatency;
+    StageCounter meshLatency;
+    StageCounter drainLatency;
+
+    void WorkerLoop();
+
+    // Install one result; false if it was dropped
+    bool Install(World& world, const Result& result);
+
+    // True if no neighbour of the chunk was edited (the mesh used the
+    // generated border)
+    static bool IsMeshCurrent(const World& world, const ChunkCoord& coord);
+};
+
+} // namespace World
+
+#endif // CHUNK_PIPELINE_H
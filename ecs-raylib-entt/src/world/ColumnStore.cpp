@@ -0,0 +1,282 @@
+#include "ColumnStore.hpp"
+#include "World.hpp"
+#include <algorithm>
+
+namespace World {
+
+ColumnStore::ColumnStore(int width, int height, int depth, BlockType fill)
+    : width(width), height(std::clamp(height, 0, MAX_HEIGHT)), depth(depth),
+      columns(static_cast<size_t>(width) * depth) {
+    if (this->height > 0) {
+        for (std::vector<Run>& runs : columns) {
+            runs.push_back({ static_cast<uint16_t>(this->height), fill });
+        }
+    }
+}
+
+ColumnStore ColumnStore::FromWorld(const World& world) {
+    ColumnStore store(world.GetWidth(), world.GetHeight(), world.GetDepth());
+    for (std::vector<Run>& runs : store.columns) {
+        runs.clear();
+    }
+
+    // Chunks bottom up per chunk column, so each column grows upwards
+    std::vector<BlockType> types(CHUNK_VOLUME);
+    for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+        for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+            for (int cy = 0; cy < world.GetChunksY(); ++cy) {
+                world.GetChunkTypes({ cx, cy, cz }, types.data());
+                int baseX = cx << CHUNK_SHIFT, baseY = cy << CHUNK_SHIFT, baseZ = cz << CHUNK_SHIFT;
+                int sizeX = std::min(CHUNK_SIZE, store.width - baseX);
+                int sizeY = std::min(CHUNK_SIZE, store.height - baseY);
+                int sizeZ = std::min(CHUNK_SIZE, store.depth - baseZ);
+                for (int lz = 0; lz < sizeZ; ++lz) {
+                    for (int lx = 0; lx < sizeX; ++lx) {
+                        std::vector<Run>& runs = store.columns[store.ColumnIndex(baseX + lx, baseZ + lz)];
+                        for (int ly = 0; ly < sizeY; ++ly) {
+                            BlockType type = types[LocalIndex(lx, ly, lz)];
+                            if (!runs.empty() && runs.back().type == type) {
+                                ++runs.back().end;
+                            } else {
+                                runs.push_back({ static_cast<uint16_t>(baseY + ly + 1), type });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (std::vector<Run>& runs : store.columns) {
+        runs.shrink_to_fit();
+    }
+    return store;
+}
+
+size_t ColumnStore::FindRun(const std::vector<Run>& runs, int y) {
+    auto it = std::upper_bound(runs.begin(), runs.end(), y,
+                               [](int value, const Run& run) { return value < run.end; });
+    return static_cast<size_t>(it - runs.begin());
+}
+
+BlockType ColumnStore::GetBlockType(int x, int y, int z) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || z < 0 || z >= depth) {
+        return BlockType::Air;
+    }
+    const std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+    return runs[FindRun(runs, y)].type;
+}
+
+void ColumnStore::SetBlock(int x, int y, int z, BlockType type) {
+    if (x < 0 || x >= width || y < 0 || y >= height || z < 0 || z >= depth) {
+        return;
+    }
+    std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+    size_t i = FindRun(runs, y);
+    BlockType old = runs[i].type;
+    if (old == type) {
+        return;
+    }
+
+    // Split the run around y: [begin, y) old, [y, y + 1) type, [y + 1, end) old
+    int begin = i > 0 ? runs[i - 1].end : 0;
+    int end = runs[i].end;
+    Run pieces[3];
+    size_t count = 0;
+    if (y > begin) pieces[count++] = { static_cast<uint16_t>(y), old };
+    size_t changed = i + count;
+    pieces[count++] = { static_cast<uint16_t>(y + 1), type };
+    if (y + 1 < end) pieces[count++] = { static_cast<uint16_t>(end), old };
+    runs[i] = pieces[0];
+    runs.insert(runs.begin() + i + 1, pieces + 1, pieces + count);
+
+    // Merge the new block into equal runs on either side
+    if (changed + 1 < runs.size() && runs[changed + 1].type == type) {
+        runs[changed].end = runs[changed + 1].end;
+        runs.erase(runs.begin() + changed + 1);
+    }
+    if (changed > 0 && runs[changed - 1].type == type) {
+        runs[changed - 1].end = runs[changed].end;
+        runs.erase(runs.begin() + changed);
+    }
+}
+
+void ColumnStore::SetChunkTypes(const ChunkCoord& coord, const BlockType* types) {
+    int baseX = coord.x << CHUNK_SHIFT, baseY = coord.y << CHUNK_SHIFT, baseZ = coord.z << CHUNK_SHIFT;
+    int y0 = std::max(baseY, 0), y1 = std::min(baseY + CHUNK_SIZE, height);
+    if (y0 >= y1) {
+        return;
+    }
+
+    // Each column becomes: its runs below the chunk (the last one cut at
+    // y0), the chunk's blocks, then its runs above (the first one cut at
+    // y1), merging equal neighbours as they are appended
+    std::vector<Run> spliced;
+    auto append = [&](int end, BlockType type) {
+        if (!spliced.empty() && spliced.back().type == type) {
+            spliced.back().end = static_cast<uint16_t>(end);
+        } else {
+            spliced.push_back({ static_cast<uint16_t>(end), type });
+        }
+    };
+    for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+        int z = baseZ + lz;
+        if (z < 0 || z >= depth) continue;
+        for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+            int x = baseX + lx;
+            if (x < 0 || x >= width) continue;
+            std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+            spliced.clear();
+            size_t i = 0;
+            for (; i < runs.size() && runs[i].end <= y0; ++i) {
+                spliced.push_back(runs[i]);
+            }
+            if (y0 > 0 && (spliced.empty() || spliced.back().end < y0)) {
+                append(y0, runs[i].type);
+            }
+            for (int y = y0; y < y1; ++y) {
+                append(y + 1, types[LocalIndex(x - baseX, y - baseY, lz)]);
+            }
+            for (size_t j = FindRun(runs, y1); j < runs.size(); ++j) {
+                append(runs[j].end, runs[j].type);
+            }
+            runs.assign(spliced.begin(), spliced.end());
+        }
+    }
+}
+
+int ColumnStore::GetColumnTop(int x, int z) const {
+    const std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+    if (runs.empty()) {
+        return -1;
+    }
+    if (runs.back().type != BlockType::Air) {
+        return height - 1;
+    }
+    // Neighbouring runs differ, so the one below a top air run is solid
+    return runs.size() > 1 ? runs[runs.size() - 2].end - 1 : -1;
+}
+
+size_t ColumnStore::GetRunCount() const {
+    size_t count = 0;
+    for (const std::vector<Run>& runs : columns) {
+        count += runs.size();
+    }
+    return count;
+}
+
+void ColumnStore::GetChunkTypes(const ChunkCoord& coord, BlockType* out) const {
+    int baseX = coord.x << CHUNK_SHIFT, baseY = coord.y << CHUNK_SHIFT, baseZ = coord.z << CHUNK_SHIFT;
+    for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+        for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+            int x = baseX + lx, z = baseZ + lz;
+            int ly = 0;
+            if (x >= 0 && x < width && z >= 0 && z < depth && baseY >= 0 && baseY < height) {
+                const std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+                for (size_t i = FindRun(runs, baseY); i < runs.size() && ly < CHUNK_SIZE; ++i) {
+                    int runEnd = std::min(static_cast<int>(runs[i].end) - baseY, CHUNK_SIZE);
+                    for (; ly < runEnd; ++ly) {
+                        out[LocalIndex(lx, ly, lz)] = runs[i].type;
+                    }
+                }
+            }
+            for (; ly < CHUNK_SIZE; ++ly) {
+                out[LocalIndex(lx, ly, lz)] = BlockType::Air;
+            }
+        }
+    }
+}
+
+BlockStatistics ColumnStore::ComputeStatistics() const {
+    BlockStatistics stats;
+    stats.width = width;
+    stats.height = height;
+    stats.depth = depth;
+    stats.layerCounts.assign(height, TypeCounts{});
+
+    // Each run adds one block per layer it spans: record where it starts
+    // and stops, then sum the layers bottom up (unsigned wrap-around
+    // cancels out in the running sums)
+    std::vector<TypeCounts> starts(static_cast<size_t>(height) + 1, TypeCounts{});
+    int interiorX0 = SURFACE_LAYER_COUNT, interiorX1 = width - SURFACE_LAYER_COUNT;
+    int interiorY0 = SURFACE_LAYER_COUNT, interiorY1 = height - SURFACE_LAYER_COUNT;
+    int interiorZ0 = SURFACE_LAYER_COUNT, interiorZ1 = depth - SURFACE_LAYER_COUNT;
+    ForEachRun([&](int x, int z, const BlockRun& run) {
+        int t = static_cast<int>(run.type);
+        ++starts[run.begin][t];
+        --starts[run.end][t];
+        if (x >= interiorX0 && x < interiorX1 && z >= interiorZ0 && z < interiorZ1) {
+            int overlap = std::min(run.end, interiorY1) - std::max(run.begin, interiorY0);
+            if (overlap > 0) stats.interiorCounts[t] += static_cast<uint64_t>(overlap);
+        }
+    });
+
+    TypeCounts running{};
+    for (int y = 0; y < height; ++y) {
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+            running[t] += starts[y][t];
+            stats.layerCounts[y][t] = running[t];
+            stats.counts[t] += running[t];
+        }
+    }
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+        stats.shellCounts[t] = stats.counts[t] - stats.interiorCounts[t];
+    }
+    return stats;
+}
+
+size_t ColumnStore::CountSolidOverAir(const std::vector<Run>& column, const std::vector<Run>& neighbour) {
+    size_t count = 0;
+    size_t a = 0, b = 0;
+    int y = 0;
+    while (a < column.size() && b < neighbour.size()) {
+        int end = std::min(column[a].end, neighbour[b].end);
+        if (column[a].type != BlockType::Air && neighbour[b].type == BlockType::Air) {
+            count += static_cast<size_t>(end - y);
+        }
+        y = end;
+        if (column[a].end == end) ++a;
+        if (neighbour[b].end == end) ++b;
+    }
+    return count;
+}
+
+size_t ColumnStore::CountVisibleFaces() const {
+    static const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    size_t faces = 0;
+    for (int z = 0; z < depth; ++z) {
+        for (int x = 0; x < width; ++x) {
+            const std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+            size_t solid = 0;
+
+            // Top and bottom faces only where a solid run meets air (or
+            // the world's top or bottom)
+            for (size_t i = 0; i < runs.size(); ++i) {
+                if (runs[i].type == BlockType::Air) continue;
+                solid += static_cast<size_t>(runs[i].end - (i > 0 ? runs[i - 1].end : 0));
+                if (i + 1 == runs.size() || runs[i + 1].type == BlockType::Air) ++faces;
+                if (i == 0 || runs[i - 1].type == BlockType::Air) ++faces;
+            }
+            if (solid == 0) continue;
+
+            for (const int* offset : offsets) {
+                int nx = x + offset[0], nz = z + offset[1];
+                if (nx < 0 || nx >= width || nz < 0 || nz >= depth) {
+                    faces += solid;  // world edge
+                } else {
+                    faces += CountSolidOverAir(runs, columns[ColumnIndex(nx, nz)]);
+                }
+            }
+        }
+    }
+    return faces;
+}
+
+size_t ColumnStore::GetMemoryUsage() const {
+    size_t bytes = columns.capacity() * sizeof(std::vector<Run>);
+    for (const std::vector<Run>& runs : columns) {
+        bytes += runs.capacity() * sizeof(Run);
+    }
+    return bytes;
+}
+
+} // namespace World
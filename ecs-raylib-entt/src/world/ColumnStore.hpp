@@ -0,0 +1,131 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include "Block.hpp"
+#include "BlockStats.hpp"
+#include "Chunk.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+class World;
+
+// Blocks y in [begin, end) of one column, all of one type
+struct BlockRun {
+    int begin;
+    int end;
+    BlockType type;
+
+    int Size() const { return end - begin; }
+};
+
+// A world stored as runs along y, one run list per (x, z) column: a
+// compact form for worlds made of long vertical runs (the generated shell
+// over a mostly Stone interior is a handful of runs per column, where
+// chunks keep an index per voxel). Neighbouring runs always differ in
+// type. Reads binary-search a column's runs, O(log runs); a write splits
+// the run it lands in and merges with equal neighbours. Statistics and
+// face counts walk runs rather than voxels. Heights up to MAX_HEIGHT.
+//
+// Chunks stay the World's own storage (streaming, meshing and save files
+// work per chunk). A World with its column run index enabled keeps one
+// next to its chunks for statistics and face counts; a standalone one is built
+// from a world with FromWorld and hands chunks back through GetChunkTypes.
+class ColumnStore {
+public:
+    // Run ends are 16-bit
+    static constexpr int MAX_HEIGHT = 65535;
+
+    // A world of one type (air by default). Heights are clamped to
+    // [0, MAX_HEIGHT], so a taller store keeps only its bottom MAX_HEIGHT
+    // layers; check the height before building one.
+    ColumnStore(int width, int height, int depth, BlockType fill = BlockType::Air);
+
+    // Every block of a world (generating lazy chunks as needed), read a
+    // chunk column at a time
+    static ColumnStore FromWorld(const World& world);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int GetDepth() const { return depth; }
+
+    // Block at a position; positions outside the store read as air
+    BlockType GetBlockType(int x, int y, int z) const;
+
+    // Change one block (no-op outside the store)
+    void SetBlock(int x, int y, int z, BlockType type);
+
+    // Replace a chunk's blocks with CHUNK_VOLUME types in LocalIndex order
+    // (voxels past the edge are ignored); each column's runs are spliced
+    // once, O(runs + CHUNK_SIZE) per column
+    void SetChunkTypes(const ChunkCoord& coord, const BlockType* types);
+
+    // Highest solid y of a column, or -1 if it is all air. O(1).
+    int GetColumnTop(int x, int z) const;
+
+    // Runs of one column, bottom up: fn(const BlockRun&)
+    template <typename Fn>
+    void ForEachRun(int x, int z, Fn&& fn) const {
+        const std::vector<Run>& runs = columns[ColumnIndex(x, z)];
+        int begin = 0;
+        for (const Run& run : runs) {
+            fn(BlockRun{ begin, run.end, run.type });
+            begin = run.end;
+        }
+    }
+
+    // Runs of every column, columns in (z, x) order: fn(x, z, const BlockRun&)
+    template <typename Fn>
+    void ForEachRun(Fn&& fn) const {
+        for (int z = 0; z < depth; ++z) {
+            for (int x = 0; x < width; ++x) {
+                ForEachRun(x, z, [&](const BlockRun& run) { fn(x, z, run); });
+            }
+        }
+    }
+
+    // Runs in one column and in the whole store
+    size_t GetRunCount(int x, int z) const { return columns[ColumnIndex(x, z)].size(); }
+    size_t GetRunCount() const;
+
+    // A chunk's blocks, CHUNK_VOLUME types in LocalIndex order (voxels
+    // past the edge are air), filled a run at a time
+    void GetChunkTypes(const ChunkCoord& coord, BlockType* out) const;
+
+    // Same histogram as World::ComputeStatistics, from run lengths.
+    // O(runs + height).
+    BlockStatistics ComputeStatistics() const;
+
+    // Faces of solid blocks that touch air (outside the store is air): the
+    // count a mesher culls down to, summed over the world. Side faces
+    // come from overlapping a column's solid runs with its neighbours' air
+    // runs, so the cost is O(runs).
+    size_t CountVisibleFaces() const;
+
+    // Bytes used by the run lists
+    size_t GetMemoryUsage() const;
+
+private:
+    // A run ends (exclusive) at end and starts where the previous one ends
+    struct Run {
+        uint16_t end;
+        BlockType type;
+    };
+
+    int width, height, depth;
+    std::vector<std::vector<Run>> columns;  // [z * width + x]
+
+    size_t ColumnIndex(int x, int z) const { return static_cast<size_t>(z) * width + x; }
+
+    // Index of the run holding y
+    static size_t FindRun(const std::vector<Run>& runs, int y);
+
+    // Blocks solid in column and air in neighbour at the same y
+    static size_t CountSolidOverAir(const std::vector<Run>& column, const std::vector<Run>& neighbour);
+};
+
+} // namespace World
+
+#endif // COLUMN_STORE_H
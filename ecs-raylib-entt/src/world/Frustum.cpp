@@ -0,0 +1,90 @@
+#include "Frustum.hpp"
+#include <raymath.h>
+#include <cmath>
+
+namespace World {
+
+namespace {
+
+Plane MakePlane(float a, float b, float c, float d) {
+    float length = std::sqrt(a * a + b * b + c * c);
+    if (length == 0.0f) return { 0.0f, 0.0f, 0.0f, d };
+    return { a / length, b / length, c / length, d / length };
+}
+
+} // namespace
+
+Frustum ExtractFrustum(const Matrix& m) {
+    // Rows of the matrix in clip = M * p form (raymath stores columns as
+    // m0..m3, m4..m7, ... so row i is m[i], m[i+4], m[i+8], m[i+12])
+    const float r0[4] = { m.m0, m.m4, m.m8, m.m12 };
+    const float r1[4] = { m.m1, m.m5, m.m9, m.m13 };
+    const float r2[4] = { m.m2, m.m6, m.m10, m.m14 };
+    const float r3[4] = { m.m3, m.m7, m.m11, m.m15 };
+
+    // Gribb/Hartmann: -w <= x  ->  (row3 + row0) . p >= 0, and so on
+    Frustum f;
+    f.planes[Frustum::Left]   = MakePlane(r3[0] + r0[0], r3[1] + r0[1], r3[2] + r0[2], r3[3] + r0[3]);
+    f.planes[Frustum::Right]  = MakePlane(r3[0] - r0[0], r3[1] - r0[1], r3[2] - r0[2], r3[3] - r0[3]);
+    f.planes[Frustum::Bottom] = MakePlane(r3[0] + r1[0], r3[1] + r1[1], r3[2] + r1[2], r3[3] + r1[3]);
+    f.planes[Frustum::Top]    = MakePlane(r3[0] - r1[0], r3[1] - r1[1], r3[2] - r1[2], r3[3] - r1[3]);
+    f.planes[Frustum::Near]   = MakePlane(r3[0] + r2[0], r3[1] + r2[1], r3[2] + r2[2], r3[3] + r2[3]);
+    f.planes[Frustum::Far]    = MakePlane(r3[0] - r2[0], r3[1] - r2[1], r3[2] - r2[2], r3[3] - r2[3]);
+    return f;
+}
+
+Matrix CameraViewProjection(const Camera3D& camera, float aspect, float nearPlane, float farPlane) {
+    // Mirrors BeginMode3D
+    Matrix projection;
+    if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+        double top = camera.fovy / 2.0;
+        double right = top * aspect;
+        projection = MatrixOrtho(-right, right, -top, top, nearPlane, farPlane);
+    } else {
+        projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect, nearPlane, farPlane);
+    }
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    return MatrixMultiply(view, projection);
+}
+
+Containment ClassifyAABB(const Frustum& frustum, const BoundingBox& box) {
+    uint8_t planeMask = ALL_FRUSTUM_PLANES;
+    return ClassifyAABB(frustum, box, planeMask);
+}
+
+Containment ClassifyAABB(const Frustum& frustum, const BoundingBox& box, uint8_t& planeMask) {
+    for (int side = 0; side < Frustum::SideCount; ++side) {
+        uint8_t bit = static_cast<uint8_t>(1 << side);
+        if (!(planeMask & bit)) continue;
+        const Plane& plane = frustum.planes[side];
+
+        // Corner furthest along the plane normal, and the one opposite it
+        Vector3 positive = {
+            plane.a >= 0.0f ? box.max.x : box.min.x,
+            plane.b >= 0.0f ? box.max.y : box.min.y,
+            plane.c >= 0.0f ? box.max.z : box.min.z,
+        };
+        if (plane.Distance(positive) < 0.0f) {
+            return Containment::Outside;
+        }
+
+        Vector3 negative = {
+            plane.a >= 0.0f ? box.min.x : box.max.x,
+            plane.b >= 0.0f ? box.min.y : box.max.y,
+            plane.c >= 0.0f ? box.min.z : box.max.z,
+        };
+        if (plane.Distance(negative) >= 0.0f) {
+            planeMask &= static_cast<uint8_t>(~bit);  // fully inside this plane
+        }
+    }
+    return planeMask == 0 ? Containment::Inside : Containment::Intersecting;
+}
+
+bool ContainsPoint(const Frustum& frustum, const Vector3& p) {
+    for (const Plane& plane : frustum.planes) {
+        if (plane.Distance(p) < 0.0f) return false;
+    }
+    return true;
+}
+
+} // namespace World
@@ -0,0 +1,60 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <raylib.h>
+#include <cstdint>
+
+namespace World {
+
+// Plane a*x + b*y + c*z + d = 0 with a unit normal (a, b, c) pointing into
+// the frustum, so Distance() > 0 means inside
+struct Plane {
+    float a, b, c, d;
+
+    float Distance(const Vector3& p) const { return a * p.x + b * p.y + c * p.z + d; }
+};
+
+// The six clip planes of a camera
+struct Frustum {
+    enum Side { Left, Right, Bottom, Top, Near, Far, SideCount };
+    Plane planes[SideCount];
+};
+
+// Result of testing a volume against a frustum
+enum class Containment { Outside, Intersecting, Inside };
+
+// Extract the frustum planes from a view-projection matrix (clip = M * p,
+// OpenGL clip space with -w <= x, y, z <= w), as built by
+// MatrixMultiply(view, projection). Planes are normalized.
+Frustum ExtractFrustum(const Matrix& viewProjection);
+
+// View-projection matrix raylib uses for a camera between BeginMode3D and
+// EndMode3D, for a viewport of the given aspect ratio (width / height)
+Matrix CameraViewProjection(const Camera3D& camera, float aspect,
+                            float nearPlane = 0.01f, float farPlane = 1000.0f);
+
+// Classify an axis-aligned box: fully outside one plane, fully inside all
+// six, or straddling. Conservative: boxes near a frustum corner may report
+// Intersecting while actually outside, never the other way round.
+Containment ClassifyAABB(const Frustum& frustum, const BoundingBox& box);
+
+// Same, testing only the planes whose bit (1 << Frustum::Side) is set in
+// planeMask, and clearing the bits of planes the box is fully inside. A
+// hierarchy passes the reduced mask to its children, which lie inside the
+// same planes, so deeper nodes test fewer planes.
+Containment ClassifyAABB(const Frustum& frustum, const BoundingBox& box, uint8_t& planeMask);
+
+// Mask with every plane of a frustum
+constexpr uint8_t ALL_FRUSTUM_PLANES = (1 << Frustum::SideCount) - 1;
+
+// True unless the box is certainly outside the frustum
+inline bool IntersectsAABB(const Frustum& frustum, const BoundingBox& box) {
+    return ClassifyAABB(frustum, box) != Containment::Outside;
+}
+
+// True if the point is inside (or on) all six planes
+bool ContainsPoint(const Frustum& frustum, const Vector3& p);
+
+} // namespace World
+
+#endif // FRUSTUM_H
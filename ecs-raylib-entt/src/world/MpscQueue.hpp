@@ -0,0 +1,66 @@
+#ifndef WORLD_MPSC_QUEUE_H
+#define WORLD_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace World {
+
+// Unbounded lock-free queue for many producers and one consumer (Vyukov's
+// intrusive MPSC list). Push is one atomic exchange and never blocks, so
+// worker threads can hand results over without contending on a lock; only
+// the owning thread may call TryPop. T must be default-constructible (the
+// consumer keeps a stub node).
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node()), tail(head.load()) {}
+
+    ~MpscQueue() {
+        T discard;
+        while (TryPop(discard)) {}
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread
+    void Push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer thread only; false if nothing is ready. A push still being
+    // linked in counts as not ready yet.
+    bool TryPop(T& out) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(next->value);
+        delete tail;
+        tail = next;  // next becomes the stub; its value was moved out
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Items pushed and not yet popped (approximate while producers run)
+    size_t Size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        T value{};
+    };
+
+    std::atomic<Node*> head;  // last pushed node (producers)
+    Node* tail;               // stub before the oldest item (consumer)
+    std::atomic<size_t> count{ 0 };
+};
+
+} // namespace World
+
+#endif // WORLD_MPSC_QUEUE_H
@@ -0,0 +1,116 @@
+#include "Noise.hpp"
+#include "Random.hpp"
+
+namespace World {
+
+namespace {
+
+// Perlin's quintic ease curve: zero first and second derivatives at the
+// lattice points, so cells join without creases
+inline float Fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+inline float Lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+// Integer floor without a libm call
+inline int FastFloor(float x) {
+    int i = static_cast<int>(x);
+    return i - (x < static_cast<float>(i));
+}
+
+// Gradients are looked up rather than picked with branches: the hash is
+// random, so branches on it would mispredict half the time
+
+// Four diagonal gradients (x, z)
+constexpr float GRAD2[4][2] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+
+inline float Gradient(uint32_t hash, float x, float z) {
+    const float* g = GRAD2[hash & 3];
+    return g[0] * x + g[1] * z;
+}
+
+// The twelve cube-edge gradients of Perlin's improved noise, padded to
+// sixteen by repeating four
+constexpr float GRAD3[16][3] = {
+    { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+    { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+    { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 },
+    { 1, 1, 0 }, { 0, -1, 1 }, { -1, 1, 0 }, { 0, -1, -1 },
+};
+
+inline float Gradient(uint32_t hash, float x, float y, float z) {
+    const float* g = GRAD3[hash & 15];
+    return g[0] * x + g[1] * y + g[2] * z;
+}
+
+} // namespace
+
+GradientNoise::GradientNoise(uint64_t seed) : key(static_cast<uint32_t>(SplitMix64(seed))) {
+}
+
+// Lattice hashes chain one coordinate at a time, so the corners of a
+// cell share their partial hashes: HashX(x), then Next(h, y), Next(h, z)
+
+uint32_t GradientNoise::HashX(int x) const {
+    return Mix32(key ^ static_cast<uint32_t>(x));
+}
+
+uint32_t GradientNoise::Next(uint32_t hash, int coordinate) {
+    return Mix32(hash + static_cast<uint32_t>(coordinate));
+}
+
+float GradientNoise::Sample(float x, float z) const {
+    int ix = FastFloor(x), iz = FastFloor(z);
+    x -= static_cast<float>(ix);
+    z -= static_cast<float>(iz);
+
+    uint32_t h0 = HashX(ix), h1 = HashX(ix + 1);
+    float n00 = Gradient(Next(h0, iz), x, z);
+    float n10 = Gradient(Next(h1, iz), x - 1.0f, z);
+    float n01 = Gradient(Next(h0, iz + 1), x, z - 1.0f);
+    float n11 = Gradient(Next(h1, iz + 1), x - 1.0f, z - 1.0f);
+
+    float u = Fade(x), w = Fade(z);
+    return Lerp(Lerp(n00, n10, u), Lerp(n01, n11, u), w);
+}
+
+float GradientNoise::Sample(float x, float y, float z) const {
+    int ix = FastFloor(x), iy = FastFloor(y), iz = FastFloor(z);
+    x -= static_cast<float>(ix);
+    y -= static_cast<float>(iy);
+    z -= static_cast<float>(iz);
+
+    uint32_t h0 = HashX(ix), h1 = HashX(ix + 1);
+    uint32_t h00 = Next(h0, iy), h10 = Next(h1, iy), h01 = Next(h0, iy + 1), h11 = Next(h1, iy + 1);
+    float n000 = Gradient(Next(h00, iz), x, y, z);
+    float n100 = Gradient(Next(h10, iz), x - 1.0f, y, z);
+    float n010 = Gradient(Next(h01, iz), x, y - 1.0f, z);
+    float n110 = Gradient(Next(h11, iz), x - 1.0f, y - 1.0f, z);
+    float n001 = Gradient(Next(h00, iz + 1), x, y, z - 1.0f);
+    float n101 = Gradient(Next(h10, iz + 1), x - 1.0f, y, z - 1.0f);
+    float n011 = Gradient(Next(h01, iz + 1), x, y - 1.0f, z - 1.0f);
+    float n111 = Gradient(Next(h11, iz + 1), x - 1.0f, y - 1.0f, z - 1.0f);
+
+    float u = Fade(x), v = Fade(y), w = Fade(z);
+    float nx00 = Lerp(n000, n100, u), nx10 = Lerp(n010, n110, u);
+    float nx01 = Lerp(n001, n101, u), nx11 = Lerp(n011, n111, u);
+    return Lerp(Lerp(nx00, nx10, v), Lerp(nx01, nx11, v), w);
+}
+
+float GradientNoise::Fractal(float x, float z, int octaves) const {
+    float sum = 0.0f, amplitude = 1.0f, total = 0.0f;
+    for (int octave = 0; octave < octaves; ++octave) {
+        // Offset each octave so their lattices (and zeros) do not line up
+        sum += amplitude * Sample(x + octave * 17.31f, z - octave * 9.73f);
+        total += amplitude;
+        x *= 2.0f;
+        z *= 2.0f;
+        amplitude *= 0.5f;
+    }
+    return total > 0.0f ? sum / total : 0.0f;
+}
+
+} // namespace World
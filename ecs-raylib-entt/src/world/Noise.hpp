@@ -0,0 +1,33 @@
+#ifndef WORLD_NOISE_H
+#define WORLD_NOISE_H
+
+#include <cstdint>
+
+namespace World {
+
+// Seeded Perlin gradient noise in 2D and 3D. Lattice gradients come from
+// hashing the seed with the lattice coordinates rather than from a
+// permutation table, so any point can be evaluated on its own, on any
+// thread, and always gives the same value (like VoxelRandom).
+class GradientNoise {
+public:
+    explicit GradientNoise(uint64_t seed = 0);
+
+    // Noise at a point, roughly in [-1, 1] (0 on lattice points)
+    float Sample(float x, float z) const;
+    float Sample(float x, float y, float z) const;
+
+    // Sum of octaves, each at twice the frequency and half the amplitude of
+    // the last, scaled back to roughly [-1, 1]
+    float Fractal(float x, float z, int octaves) const;
+
+private:
+    uint32_t key;
+
+    uint32_t HashX(int x) const;
+    static uint32_t Next(uint32_t hash, int coordinate);
+};
+
+} // namespace World
+
+#endif // WORLD_NOISE_H
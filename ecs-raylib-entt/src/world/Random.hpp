@@ -0,0 +1,79 @@
+#ifndef WORLD_RANDOM_H
+#define WORLD_RANDOM_H
+
+#include <cstdint>
+
+namespace World {
+
+// SplitMix64 finalizer: a bijective 64-bit mix with good avalanche
+constexpr uint64_t SplitMix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// 32-bit integer hash (Wellons' lowbias32): two multiplies, cheap to run
+// eight lanes at a time
+constexpr uint32_t Mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    return x ^ (x >> 16);
+}
+
+// Counter-based random numbers: each value is a hash of the seed and a
+// voxel coordinate, with no state carried between draws. Chunks can be
+// generated in any order and on any thread (or one block at a time) and
+// still come out identical.
+class VoxelRandom {
+public:
+    explicit constexpr VoxelRandom(uint64_t seed) : seed(seed) {}
+
+    // 64 random bits for (x, y, z)
+    constexpr uint64_t Bits(int x, int y, int z) const {
+        uint64_t h = SplitMix64(seed ^ static_cast<uint32_t>(x));
+        h = SplitMix64(h ^ static_cast<uint32_t>(y));
+        return SplitMix64(h ^ static_cast<uint32_t>(z));
+    }
+
+    // Uniform integer in [0, range) for (x, y, z)
+    constexpr uint32_t Below(int x, int y, int z, uint32_t range) const {
+        return static_cast<uint32_t>(((Bits(x, y, z) >> 32) * range) >> 32);
+    }
+
+private:
+    uint64_t seed;
+};
+
+// Counter-based random numbers for one row of voxels (fixed y and z). The
+// row gets its own key from the seed; each voxel along x then costs one
+// 32-bit hash, so whole rows can be drawn in vector batches (see
+// BlockSampler). Values are still a pure function of seed and coordinates.
+class RowRandom {
+public:
+    static constexpr uint32_t X_STEP = 0x9E3779B9u;  // odd, so x maps to distinct inputs
+
+    constexpr RowRandom(uint64_t seed, int y, int z)
+        : key(static_cast<uint32_t>(SplitMix64(SplitMix64(seed ^ static_cast<uint32_t>(y)) ^ static_cast<uint32_t>(z)))) {}
+
+    // 32 random bits for x in this row
+    constexpr uint32_t Bits(int x) const {
+        return Mix32(static_cast<uint32_t>(x) * X_STEP ^ key);
+    }
+
+    // Uniform integer in [0, range) for x in this row
+    constexpr uint32_t Below(int x, uint32_t range) const {
+        return static_cast<uint32_t>((static_cast<uint64_t>(Bits(x)) * range) >> 32);
+    }
+
+    uint32_t GetKey() const { return key; }
+
+private:
+    uint32_t key;
+};
+
+} // namespace World
+
+#endif // WORLD_RANDOM_H
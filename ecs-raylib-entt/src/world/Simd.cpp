@@ -0,0 +1,34 @@
+#include "Simd.hpp"
+
+namespace World {
+
+namespace {
+
+SimdLevel DetectOnce() {
+#ifdef WORLD_HAS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+#ifdef WORLD_HAS_SSE2
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+} // namespace
+
+SimdLevel DetectSimdLevel() {
+    static const SimdLevel level = DetectOnce();
+    return level;
+}
+
+const char* GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default:              return "Scalar";
+    }
+}
+
+} // namespace World
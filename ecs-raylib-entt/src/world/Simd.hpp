@@ -0,0 +1,30 @@
+#ifndef WORLD_SIMD_H
+#define WORLD_SIMD_H
+
+// Vector code paths the world's kernels can take. Kernels are compiled for
+// every level the compiler can target (AVX2 per function, so the build
+// needs no -mavx2) and the level is picked at run time.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WORLD_HAS_SSE2 1
+#endif
+#if defined(WORLD_HAS_SSE2) && defined(__GNUC__)
+#define WORLD_HAS_AVX2 1
+#endif
+
+namespace World {
+
+// Instruction sets the kernels can use
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Best level this build and CPU support (checked once at first use)
+SimdLevel DetectSimdLevel();
+
+const char* GetSimdLevelName(SimdLevel level);
+
+} // namespace World
+
+#endif // WORLD_SIMD_H
@@ -0,0 +1,177 @@
+#include "Terrain.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace World {
+
+namespace {
+
+constexpr int STEP = TerrainGenerator::LATTICE_STEP;
+
+inline float Lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+// Bilinear blend across y and z of the four lattice values on one x
+// (c[y + 2z]); rows blend these per lattice x, then along x
+inline float BlendYZ(float c00, float c10, float c01, float c11, float v, float w) {
+    return Lerp(Lerp(c00, c10, v), Lerp(c01, c11, v), w);
+}
+
+// Cell of a block along one axis and its fraction inside the cell
+inline int Cell(int coordinate) {
+    return coordinate >= 0 ? coordinate / STEP : -((-coordinate + STEP - 1) / STEP);
+}
+
+inline float Fraction(int coordinate) {
+    return static_cast<float>(coordinate - Cell(coordinate) * STEP) / STEP;
+}
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(const TerrainRules& rules, uint64_t seed, int worldHeight)
+    : rules(rules),
+      worldHeight(worldHeight),
+      hills(seed),
+      caves{ GradientNoise(seed + 1), rules.caveScale } {
+    for (size_t i = 0; i < rules.ores.size(); ++i) {
+        ores.push_back({ GradientNoise(seed + 2 + i), rules.ores[i].scale });
+    }
+}
+
+int TerrainGenerator::GetHeight(int x, int z) const {
+    float noise = hills.Fractal(x / rules.hillScale, z / rules.hillScale, rules.hillOctaves);
+    float surface = (rules.baseHeight + rules.hillHeight * noise) * worldHeight;
+    return std::clamp(static_cast<int>(std::floor(surface)), 0, worldHeight - 1);
+}
+
+void TerrainGenerator::GetHeights(int cx, int cz, int width, int depth, int* out) const {
+    int baseX = cx << CHUNK_SHIFT, baseZ = cz << CHUNK_SHIFT;
+    int sizeX = std::min(CHUNK_SIZE, width - baseX);
+    int sizeZ = std::min(CHUNK_SIZE, depth - baseZ);
+    for (int lz = 0; lz < sizeZ; ++lz) {
+        for (int lx = 0; lx < sizeX; ++lx) {
+            out[lz * CHUNK_SIZE + lx] = GetHeight(baseX + lx, baseZ + lz);
+        }
+    }
+}
+
+float TerrainGenerator::LatticeValue(const Field& field, int i, int j, int k) {
+    // Half-cell offset keeps lattice points off the noise's own lattice,
+    // where it is always zero
+    float scale = STEP / field.scale;
+    return field.noise.Sample((i + 0.5f) * scale, (j + 0.5f) * scale, (k + 0.5f) * scale);
+}
+
+float TerrainGenerator::Interpolate(const Field& field, int x, int y, int z) {
+    // Same operations in the same order as GenerateChunk's rows, so both
+    // give bit-identical values
+    int i = Cell(x), j = Cell(y), k = Cell(z);
+    float v = Fraction(y), w = Fraction(z);
+    float edges[2];
+    for (int e = 0; e < 2; ++e) {
+        edges[e] = BlendYZ(LatticeValue(field, i + e, j, k), LatticeValue(field, i + e, j + 1, k),
+                           LatticeValue(field, i + e, j, k + 1), LatticeValue(field, i + e, j + 1, k + 1), v, w);
+    }
+    return Lerp(edges[0], edges[1], Fraction(x));
+}
+
+void TerrainGenerator::FillLattice(const Field& field, int baseI, int baseJ, int baseK, Lattice& out) {
+    for (int k = 0; k < LATTICE_POINTS; ++k)
+        for (int j = 0; j < LATTICE_POINTS; ++j)
+            for (int i = 0; i < LATTICE_POINTS; ++i)
+                out[(k * LATTICE_POINTS + j) * LATTICE_POINTS + i] = LatticeValue(field, baseI + i, baseJ + j, baseK + k);
+}
+
+template <typename CaveAt, typename OreAt>
+BlockType TerrainGenerator::Classify(int depth, CaveAt&& caveAt, OreAt&& oreAt) const {
+    if (depth < 0) return BlockType::Air;
+    if (depth < rules.soilDepth) return BlockType::Soil;
+    if (depth >= rules.caveRoof && rules.caveThreshold < 1.0f && caveAt() > rules.caveThreshold) {
+        return BlockType::Air;
+    }
+    for (size_t i = 0; i < ores.size(); ++i) {
+        const OreRule& ore = rules.ores[i];
+        if (depth >= ore.minDepth && oreAt(i) > ore.threshold) return ore.type;
+    }
+    return BlockType::Stone;
+}
+
+BlockType TerrainGenerator::GenerateBlock(int x, int y, int z) const {
+    return Classify(GetHeight(x, z) - y,
+                    [&] { return Interpolate(caves, x, y, z); },
+                    [&](size_t i) { return Interpolate(ores[i], x, y, z); });
+}
+
+void TerrainGenerator::GenerateChunk(const ChunkCoord& coord, int width, int height, int depth, BlockType* out,
+                                     const int* heights) const {
+    std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+    int baseX = coord.x << CHUNK_SHIFT;
+    int baseY = coord.y << CHUNK_SHIFT;
+    int baseZ = coord.z << CHUNK_SHIFT;
+    int sizeX = std::min(CHUNK_SIZE, width - baseX);
+    int sizeY = std::min(CHUNK_SIZE, height - baseY);
+    int sizeZ = std::min(CHUNK_SIZE, depth - baseZ);
+    if (sizeX <= 0 || sizeY <= 0 || sizeZ <= 0) return;
+
+    // Heightmap first: a chunk wholly above the terrain is left as air
+    int ownHeights[CHUNK_SIZE * CHUNK_SIZE];
+    if (!heights) {
+        GetHeights(coord.x, coord.z, width, depth, ownHeights);
+        heights = ownHeights;
+    }
+    int top = -1;
+    for (int lz = 0; lz < sizeZ; ++lz) {
+        top = std::max(top, *std::max_element(heights + lz * CHUNK_SIZE, heights + lz * CHUNK_SIZE + sizeX));
+    }
+    if (top < baseY) return;
+
+    // The 3D fields at the chunk's lattice points (chunks are whole cells)
+    int baseI = baseX / STEP, baseJ = baseY / STEP, baseK = baseZ / STEP;
+    Lattice caveLattice;
+    std::vector<Lattice> oreLattices(ores.size());
+    FillLattice(caves, baseI, baseJ, baseK, caveLattice);
+    for (size_t i = 0; i < ores.size(); ++i) {
+        FillLattice(ores[i], baseI, baseJ, baseK, oreLattices[i]);
+    }
+
+    // Each field along a row: blend y and z at the row's lattice x points,
+    // then interpolate along x (straight-line loops the compiler vectorizes)
+    auto fillRow = [&](const Lattice& lattice, int cellJ, int cellK, float v, float w, float* row) {
+        float edges[LATTICE_POINTS];
+        for (int i = 0; i < LATTICE_POINTS; ++i) {
+            auto at = [&](int j, int k) { return lattice[(k * LATTICE_POINTS + j) * LATTICE_POINTS + i]; };
+            edges[i] = BlendYZ(at(cellJ, cellK), at(cellJ + 1, cellK), at(cellJ, cellK + 1), at(cellJ + 1, cellK + 1), v, w);
+        }
+        for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+            row[lx] = Lerp(edges[lx / STEP], edges[lx / STEP + 1], Fraction(lx));
+        }
+    };
+    float caveRow[CHUNK_SIZE];
+    std::vector<float> oreRows(ores.size() * CHUNK_SIZE);
+
+    for (int ly = 0; ly < sizeY; ++ly) {
+        int y = baseY + ly;
+        if (y > top) break;
+        int cellJ = ly / STEP;
+        float v = Fraction(ly);
+        for (int lz = 0; lz < sizeZ; ++lz) {
+            const int* rowHeights = heights + lz * CHUNK_SIZE;
+            if (*std::max_element(rowHeights, rowHeights + sizeX) < y) continue;  // all air
+
+            int cellK = lz / STEP;
+            float w = Fraction(lz);
+            fillRow(caveLattice, cellJ, cellK, v, w, caveRow);
+            for (size_t i = 0; i < ores.size(); ++i) {
+                fillRow(oreLattices[i], cellJ, cellK, v, w, &oreRows[i * CHUNK_SIZE]);
+            }
+            for (int lx = 0; lx < sizeX; ++lx) {
+                out[LocalIndex(lx, ly, lz)] = Classify(rowHeights[lx] - y,
+                    [&] { return caveRow[lx]; },
+                    [&](size_t i) { return oreRows[i * CHUNK_SIZE + lx]; });
+            }
+        }
+    }
+}
+
+} // namespace World
@@ -0,0 +1,118 @@
+#ifndef WORLD_TERRAIN_H
+#define WORLD_TERRAIN_H
+
+#include "Block.hpp"
+#include "Chunk.hpp"
+#include "Noise.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+// What World::Generate fills the world with
+enum class GeneratorMode {
+    SolidCube,  // a solid block: 80/20 Soil/Stone shell over a 70/20/10 Stone/Gold/Silver interior
+    Terrain     // noise terrain: hills, caves and ore veins (see TerrainRules)
+};
+
+// One kind of ore and where its veins form
+struct OreRule {
+    BlockType type = BlockType::Gold;
+    int minDepth = 0;         // blocks below the surface before it appears
+    float scale = 10.0f;      // vein size: wavelength of its noise, in blocks
+    float threshold = 0.5f;   // ore where the noise is above this; higher is rarer
+};
+
+// Layer rules for noise terrain. Heights are fractions of the world height,
+// so the same rules fit any world size; everything else is in blocks.
+struct TerrainRules {
+    float baseHeight = 0.6f;        // mean surface height
+    float hillHeight = 0.25f;       // hills and valleys reach this far above and below it
+    float hillScale = 32.0f;        // wavelength of the largest hills
+    int hillOctaves = 4;            // finer detail layered on top of them
+    int soilDepth = 3;              // soil from the surface down; stone below
+    float caveScale = 20.0f;        // cave size: wavelength of the cave noise
+    float caveThreshold = 0.3f;     // air where the noise is above this (1 or more: no caves)
+    int caveRoof = 4;               // rock kept between the surface and any cave
+
+    // Checked in order; the first vein a stone block falls in decides it
+    std::vector<OreRule> ores{
+        { BlockType::Gold, 8, 10.0f, 0.45f },
+        { BlockType::Silver, 4, 12.0f, 0.4f },
+    };
+};
+
+// Noise terrain for one seed and world height. A fractal 2D heightmap gives
+// the surface (soil over stone, air above); 3D noise carves caves and lays
+// ore veins into the stone. The 3D fields are sampled every LATTICE_STEP
+// blocks and interpolated, so a chunk costs a few hundred noise samples
+// rather than several per voxel, and chunks above the terrain cost only
+// their heightmap. Every block is a pure function of the seed and its
+// coordinates, like the solid-cube generator.
+class TerrainGenerator {
+public:
+    // Chunks must be whole lattice cells, so chunks smaller than four
+    // blocks use a lattice cell per chunk
+    static constexpr int LATTICE_STEP = CHUNK_SIZE < 4 ? CHUNK_SIZE : 4;
+
+    TerrainGenerator(const TerrainRules& rules, uint64_t seed, int worldHeight);
+
+    const TerrainRules& GetRules() const { return rules; }
+
+    // y of the column's top block before caves are carved, in [0, worldHeight).
+    // Nothing above it is ever solid.
+    int GetHeight(int x, int z) const;
+
+    // GetHeight for the CHUNK_SIZE x CHUNK_SIZE columns of chunk column
+    // (cx, cz), at out[lz * CHUNK_SIZE + lx]; only columns inside width x
+    // depth are filled
+    void GetHeights(int cx, int cz, int width, int depth, int* out) const;
+
+    // Block at (x, y, z) of the world (the caller checks the bounds)
+    BlockType GenerateBlock(int x, int y, int z) const;
+
+    // Fill one chunk (CHUNK_VOLUME types in LocalIndex order) of a world
+    // with the given bounds; voxels outside it are Air. Matches
+    // GenerateBlock voxel for voxel. Chunks of one column can share their
+    // heights (from GetHeights) instead of each computing them again.
+    void GenerateChunk(const ChunkCoord& coord, int width, int height, int depth, BlockType* out,
+                       const int* heights = nullptr) const;
+
+private:
+    // A 3D noise field and its wavelength in blocks
+    struct Field {
+        GradientNoise noise;
+        float scale;
+    };
+
+    // Field values at the LATTICE_STEP lattice points over one chunk
+    static_assert(CHUNK_SIZE % LATTICE_STEP == 0, "chunks must be whole lattice cells");
+    static constexpr int LATTICE_POINTS = CHUNK_SIZE / LATTICE_STEP + 1;
+    using Lattice = std::array<float, LATTICE_POINTS * LATTICE_POINTS * LATTICE_POINTS>;
+
+    TerrainRules rules;
+    int worldHeight;
+    GradientNoise hills;
+    Field caves;
+    std::vector<Field> ores;
+
+    // Value of a field at lattice point (i, j, k), i.e. block (i, j, k) * LATTICE_STEP
+    static float LatticeValue(const Field& field, int i, int j, int k);
+
+    // Field at a block, interpolated from its cell's eight lattice points
+    static float Interpolate(const Field& field, int x, int y, int z);
+
+    // Field values over a chunk's lattice (base in lattice units)
+    static void FillLattice(const Field& field, int baseI, int baseJ, int baseK, Lattice& out);
+
+    // Block for a voxel depth blocks under its column's surface (negative
+    // above it). caveAt() and oreAt(i) give the fields at the voxel and are
+    // only called where they can matter.
+    template <typename CaveAt, typename OreAt>
+    BlockType Classify(int depth, CaveAt&& caveAt, OreAt&& oreAt) const;
+};
+
+} // namespace World
+
+#endif // WORLD_TERRAIN_H
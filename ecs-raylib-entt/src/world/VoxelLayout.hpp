@@ -0,0 +1,150 @@
+#ifndef VOXEL_LAYOUT_H
+#define VOXEL_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace World {
+
+// Linear ordering of a 3D voxel grid inside one contiguous buffer
+enum class VoxelLayout {
+    YZX,    // x fastest, then z, then y (layer-major, matches the old [y][z][x])
+    XZY,    // y fastest, then z, then x (column-major, good for vertical scans)
+    Morton  // Z-order curve, keeps 3D neighbours close in memory
+};
+
+// Layout used by the world grid, picked at compile time (see WORLD_GRID_LAYOUT in CMake)
+#if defined(WORLD_GRID_LAYOUT_XZY)
+constexpr VoxelLayout GRID_LAYOUT = VoxelLayout::XZY;
+#elif defined(WORLD_GRID_LAYOUT_MORTON)
+constexpr VoxelLayout GRID_LAYOUT = VoxelLayout::Morton;
+#else
+constexpr VoxelLayout GRID_LAYOUT = VoxelLayout::YZX;
+#endif
+
+// Insert two zero bits between each of the low 10 bits of v
+constexpr uint32_t MortonSpread(uint32_t v) {
+    v &= 0x000003ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8))  & 0x0300f00f;
+    v = (v | (v << 4))  & 0x030c30c3;
+    v = (v | (v << 2))  & 0x09249249;
+    return v;
+}
+
+// Inverse of MortonSpread
+constexpr uint32_t MortonCompact(uint32_t v) {
+    v &= 0x09249249;
+    v = (v ^ (v >> 2))  & 0x030c30c3;
+    v = (v ^ (v >> 4))  & 0x0300f00f;
+    v = (v ^ (v >> 8))  & 0xff0000ff;
+    v = (v ^ (v >> 16)) & 0x000003ff;
+    return v;
+}
+
+// Interleave coordinates as ...y z x (x in the lowest bit)
+constexpr uint32_t MortonEncode(int x, int y, int z) {
+    return MortonSpread(static_cast<uint32_t>(x)) |
+           (MortonSpread(static_cast<uint32_t>(z)) << 1) |
+           (MortonSpread(static_cast<uint32_t>(y)) << 2);
+}
+
+constexpr void MortonDecode(uint32_t code, int& x, int& y, int& z) {
+    x = static_cast<int>(MortonCompact(code));
+    z = static_cast<int>(MortonCompact(code >> 1));
+    y = static_cast<int>(MortonCompact(code >> 2));
+}
+
+// Smallest power of two >= v
+constexpr int NextPowerOfTwo(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// Side of the power-of-two cube Morton order needs to cover a grid
+constexpr int MortonSide(int width, int height, int depth) {
+    int side = NextPowerOfTwo(width);
+    if (NextPowerOfTwo(height) > side) side = NextPowerOfTwo(height);
+    if (NextPowerOfTwo(depth) > side) side = NextPowerOfTwo(depth);
+    return side;
+}
+
+// Number of slots a grid of the given size needs in this layout.
+// Morton order addresses a power-of-two cube, so the buffer is padded.
+template <VoxelLayout L>
+constexpr size_t LayoutCapacity(int width, int height, int depth) {
+    if constexpr (L == VoxelLayout::Morton) {
+        int side = MortonSide(width, height, depth);
+        return static_cast<size_t>(side) * side * side;
+    } else {
+        return static_cast<size_t>(width) * height * depth;
+    }
+}
+
+// Map (x, y, z) to a slot in the flat buffer
+template <VoxelLayout L>
+constexpr size_t LinearIndex(int x, int y, int z, int width, int height, int depth) {
+    if constexpr (L == VoxelLayout::YZX) {
+        (void)height;
+        return (static_cast<size_t>(y) * depth + z) * width + x;
+    } else if constexpr (L == VoxelLayout::XZY) {
+        (void)width;
+        return (static_cast<size_t>(x) * depth + z) * height + y;
+    } else {
+        (void)width; (void)height; (void)depth;
+        return MortonEncode(x, y, z);
+    }
+}
+
+// Visit every (x, y, z) of a grid in the layout's storage order, so the
+// callback streams through memory instead of striding across it.
+// fn(x, y, z, index)
+template <VoxelLayout L, typename Fn>
+void ForEachInLayout(int width, int height, int depth, Fn&& fn) {
+    if constexpr (L == VoxelLayout::YZX) {
+        size_t index = 0;
+        for (int y = 0; y < height; ++y)
+            for (int z = 0; z < depth; ++z)
+                for (int x = 0; x < width; ++x)
+                    fn(x, y, z, index++);
+    } else if constexpr (L == VoxelLayout::XZY) {
+        size_t index = 0;
+        for (int x = 0; x < width; ++x)
+            for (int z = 0; z < depth; ++z)
+                for (int y = 0; y < height; ++y)
+                    fn(x, y, z, index++);
+    } else {
+        // Walk the padded cube in 4x4x4 bricks: each brick is a contiguous run of
+        // 64 codes, bricks fully outside the grid are skipped without decoding.
+        constexpr int BRICK = 4;
+        int bricksPerSide = (MortonSide(width, height, depth) + BRICK - 1) / BRICK;
+        size_t brickCount = static_cast<size_t>(bricksPerSide) * bricksPerSide * bricksPerSide;
+        for (size_t brick = 0; brick < brickCount; ++brick) {
+            int bx = 0, by = 0, bz = 0;
+            MortonDecode(static_cast<uint32_t>(brick), bx, by, bz);
+            bx *= BRICK; by *= BRICK; bz *= BRICK;
+            if (bx >= width || by >= height || bz >= depth) continue;
+            
+            bool whole = bx + BRICK <= width && by + BRICK <= height && bz + BRICK <= depth;
+            size_t base = brick * BRICK * BRICK * BRICK;
+            for (uint32_t local = 0; local < BRICK * BRICK * BRICK; ++local) {
+                int x = bx + static_cast<int>(MortonCompact(local));
+                int z = bz + static_cast<int>(MortonCompact(local >> 1));
+                int y = by + static_cast<int>(MortonCompact(local >> 2));
+                if (whole || (x < width && y < height && z < depth)) {
+                    fn(x, y, z, base + local);
+                }
+            }
+        }
+    }
+}
+
+static_assert(LinearIndex<VoxelLayout::YZX>(1, 2, 3, 36, 36, 36) == (2 * 36 + 3) * 36 + 1, "YZX index");
+static_assert(LinearIndex<VoxelLayout::XZY>(1, 2, 3, 36, 36, 36) == (1 * 36 + 3) * 36 + 2, "XZY index");
+static_assert(MortonEncode(1, 0, 0) == 1 && MortonEncode(0, 0, 1) == 2 && MortonEncode(0, 1, 0) == 4, "Morton bit order");
+static_assert(LayoutCapacity<VoxelLayout::Morton>(36, 36, 36) == 64 * 64 * 64, "Morton padding");
+
+} // namespace World
+
+#endif // VOXEL_LAYOUT_H
@@ -0,0 +1,303 @@
+#include "VoxelOctree.hpp"
+#include "World.hpp"
+#include <algorithm>
+
+namespace World {
+
+VoxelBox VoxelBox::Intersect(const VoxelBox& other) const {
+    return { std::max(minX, other.minX), std::max(minY, other.minY), std::max(minZ, other.minZ),
+             std::min(maxX, other.maxX), std::min(maxY, other.maxY), std::min(maxZ, other.maxZ) };
+}
+
+VoxelBox VoxelBox::OfChunk(const ChunkCoord& coord) {
+    int x = coord.x << CHUNK_SHIFT, y = coord.y << CHUNK_SHIFT, z = coord.z << CHUNK_SHIFT;
+    return { x, y, z, x + CHUNK_SIZE, y + CHUNK_SIZE, z + CHUNK_SIZE };
+}
+
+VoxelOctree::VoxelOctree(int width, int height, int depth, BlockType fill)
+    : width(width), height(height), depth(depth), size(1), levels(0) {
+    // At least a chunk across, so every chunk has a node of its own
+    int extent = std::max({ width, height, depth, CHUNK_SIZE });
+    while (size < extent) {
+        size <<= 1;
+        ++levels;
+    }
+    nodes.push_back({ 0, BlockType::Air, REGION_AIR });
+    FillRegion(GetBounds(), fill);
+}
+
+VoxelOctree VoxelOctree::FromWorld(const World& world) {
+    VoxelOctree tree(world.GetWidth(), world.GetHeight(), world.GetDepth());
+    std::vector<BlockType> types(CHUNK_VOLUME);
+    for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+        for (int cy = 0; cy < world.GetChunksY(); ++cy) {
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, types.data());
+                tree.SetChunkTypes({ cx, cy, cz }, types.data());
+            }
+        }
+    }
+    return tree;
+}
+
+void VoxelOctree::SetChunkTypes(const ChunkCoord& coord, const BlockType* types) {
+    int x = coord.x << CHUNK_SHIFT, y = coord.y << CHUNK_SHIFT, z = coord.z << CHUNK_SHIFT;
+    if (VoxelBox::OfChunk(coord).Intersect(GetBounds()).IsEmpty()) {
+        return;
+    }
+
+    // Walk down to the chunk's node, splitting leaves, then build its
+    // subtree and merge back up the path
+    uint32_t path[32];
+    int length = 0;
+    uint32_t node = 0;
+    for (int half = size >> 1; half >= CHUNK_SIZE; half >>= 1) {
+        if (nodes[node].children == 0) {
+            Split(node);
+        }
+        path[length++] = node;
+        int i = ((x & half) ? 1 : 0) | ((y & half) ? 2 : 0) | ((z & half) ? 4 : 0);
+        node = nodes[node].children + i;
+    }
+    Build(node, x, y, z, CHUNK_SIZE, types);
+
+    while (length > 0) {
+        --length;
+        int cellSize = size >> length;
+        Refresh(path[length], x & ~(cellSize - 1), y & ~(cellSize - 1), z & ~(cellSize - 1), cellSize);
+    }
+}
+
+BlockType VoxelOctree::GetBlockType(int x, int y, int z) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || z < 0 || z >= depth) {
+        return BlockType::Air;
+    }
+    uint32_t node = 0;
+    for (int half = size >> 1; nodes[node].children != 0; half >>= 1) {
+        int i = ((x & half) ? 1 : 0) | ((y & half) ? 2 : 0) | ((z & half) ? 4 : 0);
+        node = nodes[node].children + i;
+    }
+    return nodes[node].type;
+}
+
+void VoxelOctree::SetBlock(int x, int y, int z, BlockType type) {
+    if (x < 0 || x >= width || y < 0 || y >= height || z < 0 || z >= depth) {
+        return;
+    }
+
+    // Walk down, splitting leaves of another type, remembering the path
+    uint32_t path[32];
+    int length = 0;
+    uint32_t node = 0;
+    for (int half = size >> 1; half > 0; half >>= 1) {
+        if (nodes[node].children == 0) {
+            if (nodes[node].type == type) return;
+            Split(node);
+        }
+        path[length++] = node;
+        int i = ((x & half) ? 1 : 0) | ((y & half) ? 2 : 0) | ((z & half) ? 4 : 0);
+        node = nodes[node].children + i;
+    }
+    nodes[node].type = type;
+    nodes[node].contents = ContentsOf(type);
+
+    while (length > 0) {
+        --length;
+        int cellSize = size >> length;
+        Refresh(path[length], x & ~(cellSize - 1), y & ~(cellSize - 1), z & ~(cellSize - 1), cellSize);
+    }
+}
+
+void VoxelOctree::FillRegion(const VoxelBox& box, BlockType type) {
+    VoxelBox clipped = box.Intersect(GetBounds());
+    if (!clipped.IsEmpty()) {
+        Fill(0, 0, 0, 0, size, clipped, type);
+    }
+}
+
+void VoxelOctree::Fill(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box, BlockType type) {
+    VoxelBox cell = Cell(x, y, z, cellSize).Intersect(GetBounds());
+    if (cell.Intersect(box).IsEmpty()) {
+        return;
+    }
+    if (box.Contains(cell)) {
+        MakeLeaf(node, type);
+        return;
+    }
+    if (nodes[node].children == 0) {
+        if (nodes[node].type == type) return;
+        Split(node);
+    }
+    int half = cellSize / 2;
+    for (int i = 0; i < 8; ++i) {
+        Fill(nodes[node].children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+             half, box, type);
+    }
+    Refresh(node, x, y, z, cellSize);
+}
+
+void VoxelOctree::Build(uint32_t node, int x, int y, int z, int cellSize, const BlockType* types) {
+    if (cellSize == 1) {
+        BlockType type = types[LocalIndex(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+        nodes[node].type = type;
+        nodes[node].contents = ContentsOf(type);
+        return;
+    }
+    if (nodes[node].children == 0) {
+        Split(node);
+    }
+    int half = cellSize / 2;
+    for (int i = 0; i < 8; ++i) {
+        Build(nodes[node].children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+              half, types);
+    }
+    Refresh(node, x, y, z, cellSize);
+}
+
+bool VoxelOctree::IsRegionUniform(const VoxelBox& box, BlockType* type) const {
+    VoxelBox clipped = box.Intersect(GetBounds());
+    if (clipped.IsEmpty()) {
+        return false;
+    }
+    BlockType found = BlockType::Air;
+    bool any = false;
+    if (!Uniform(0, 0, 0, 0, size, clipped, found, any)) {
+        return false;
+    }
+    if (type) *type = found;
+    return true;
+}
+
+bool VoxelOctree::Uniform(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box,
+                          BlockType& found, bool& any) const {
+    if (Cell(x, y, z, cellSize).Intersect(box).IsEmpty()) {
+        return true;
+    }
+    const Node& n = nodes[node];
+    if (n.children == 0) {
+        if (!any) {
+            found = n.type;
+            any = true;
+        }
+        return n.type == found;
+    }
+    int half = cellSize / 2;
+    for (int i = 0; i < 8; ++i) {
+        if (!Uniform(n.children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+                     half, box, found, any)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t VoxelOctree::GetRegionContents(const VoxelBox& box) const {
+    VoxelBox clipped = box.Intersect(GetBounds());
+    if (clipped.IsEmpty()) {
+        return REGION_EMPTY;
+    }
+    return Contents(0, 0, 0, 0, size, clipped);
+}
+
+uint8_t VoxelOctree::Contents(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box) const {
+    VoxelBox cell = Cell(x, y, z, cellSize).Intersect(GetBounds());
+    if (cell.Intersect(box).IsEmpty()) {
+        return REGION_EMPTY;
+    }
+    const Node& n = nodes[node];
+    if (n.children == 0 || box.Contains(cell) || n.contents != REGION_MIXED) {
+        return n.contents;
+    }
+    int half = cellSize / 2;
+    uint8_t contents = REGION_EMPTY;
+    for (int i = 0; i < 8 && contents != REGION_MIXED; ++i) {
+        contents |= Contents(n.children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+                             half, box);
+    }
+    return contents;
+}
+
+void VoxelOctree::GetChunkTypes(const ChunkCoord& coord, BlockType* out) const {
+    std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+    int baseX = coord.x << CHUNK_SHIFT, baseY = coord.y << CHUNK_SHIFT, baseZ = coord.z << CHUNK_SHIFT;
+    ForEachRegion(VoxelBox::OfChunk(coord), [&](const VoxelBox& region, BlockType type) {
+        if (type == BlockType::Air) return;
+        for (int z = region.minZ; z < region.maxZ; ++z) {
+            for (int y = region.minY; y < region.maxY; ++y) {
+                for (int x = region.minX; x < region.maxX; ++x) {
+                    out[LocalIndex(x - baseX, y - baseY, z - baseZ)] = type;
+                }
+            }
+        }
+    });
+}
+
+size_t VoxelOctree::GetMemoryUsage() const {
+    return nodes.capacity() * sizeof(Node) + freeGroups.capacity() * sizeof(uint32_t);
+}
+
+void VoxelOctree::MakeLeaf(uint32_t node, BlockType type) {
+    ReleaseChildren(node);
+    nodes[node].type = type;
+    nodes[node].contents = ContentsOf(type);
+}
+
+void VoxelOctree::Split(uint32_t node) {
+    uint32_t first;
+    if (!freeGroups.empty()) {
+        first = freeGroups.back();
+        freeGroups.pop_back();
+    } else {
+        first = static_cast<uint32_t>(nodes.size());
+        nodes.resize(nodes.size() + 8);
+    }
+    Node leaf = { 0, nodes[node].type, nodes[node].contents };
+    std::fill(nodes.begin() + first, nodes.begin() + first + 8, leaf);
+    nodes[node].children = first;
+}
+
+void VoxelOctree::Refresh(uint32_t node, int x, int y, int z, int cellSize) {
+    uint32_t first = nodes[node].children;
+    if (first == 0) {
+        return;
+    }
+
+    // Children wholly outside the world are never read: they neither stop
+    // a merge nor add to the contents
+    int half = cellSize / 2;
+    bool uniform = true;
+    bool any = false;
+    BlockType type = BlockType::Air;
+    uint8_t contents = REGION_EMPTY;
+    for (int i = 0; i < 8; ++i) {
+        if (x + (i & 1) * half >= width || y + (i >> 1 & 1) * half >= height || z + (i >> 2 & 1) * half >= depth) {
+            continue;
+        }
+        const Node& child = nodes[first + i];
+        if (!any) {
+            type = child.type;
+            any = true;
+        }
+        uniform = uniform && child.children == 0 && child.type == type;
+        contents |= child.contents;
+    }
+    if (uniform) {
+        MakeLeaf(node, type);
+    } else {
+        nodes[node].contents = contents;
+    }
+}
+
+void VoxelOctree::ReleaseChildren(uint32_t node) {
+    uint32_t first = nodes[node].children;
+    if (first == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < 8; ++i) {
+        ReleaseChildren(first + i);
+    }
+    freeGroups.push_back(first);
+    nodes[node].children = 0;
+}
+
+} // namespace World
@@ -0,0 +1,221 @@
+#ifndef VOXEL_OCTREE_H
+#define VOXEL_OCTREE_H
+
+#include "Block.hpp"
+#include "Chunk.hpp"
+#include "Frustum.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+class World;
+
+// Half-open box of blocks [min, max) on each axis
+struct VoxelBox {
+    int minX, minY, minZ;
+    int maxX, maxY, maxZ;
+
+    bool IsEmpty() const { return minX >= maxX || minY >= maxY || minZ >= maxZ; }
+    int64_t GetVolume() const {
+        return IsEmpty() ? 0 : static_cast<int64_t>(maxX - minX) * (maxY - minY) * (maxZ - minZ);
+    }
+    bool Contains(const VoxelBox& other) const {
+        return other.minX >= minX && other.maxX <= maxX && other.minY >= minY && other.maxY <= maxY &&
+               other.minZ >= minZ && other.maxZ <= maxZ;
+    }
+    VoxelBox Intersect(const VoxelBox& other) const;
+
+    // Grown by amount blocks on every side
+    VoxelBox Expand(int amount) const {
+        return { minX - amount, minY - amount, minZ - amount, maxX + amount, maxY + amount, maxZ + amount };
+    }
+
+    // Blocks of one chunk
+    static VoxelBox OfChunk(const ChunkCoord& coord);
+};
+
+// What a region holds (VoxelOctree::GetRegionContents)
+enum RegionContents : uint8_t {
+    REGION_EMPTY = 0,  // no blocks (outside the world)
+    REGION_AIR = 1,
+    REGION_SOLID = 2,
+    REGION_MIXED = REGION_AIR | REGION_SOLID
+};
+
+// A sparse voxel octree over a world's blocks, answering region queries
+// for large, mostly uniform worlds. The root is a power-of-two cube covering
+// the world (blocks past its edge are air); every region of a single type
+// collapses into one leaf, so open sky or solid rock costs one node however
+// big it is. Reads, writes and aligned fills walk one path, O(depth);
+// other fills touch the nodes along the region's boundary. Each node also
+// records whether its region holds air, solid blocks or both, so
+// "is this region all air / all solid" is answered without visiting the
+// blocks, and region and frustum queries visit uniform boxes, not voxels.
+//
+// It is an index, not a storage backend: chunks stay the World's only
+// storage. A World keeps one as its resident chunk region index, a copy
+// of the resident chunks kept in step with them
+// (World::GetResidentContents), which meshing uses to skip chunks with
+// nothing to draw; a standalone one is built from a world with FromWorld,
+// or directly with fills, and hands chunks back through GetChunkTypes.
+class VoxelOctree {
+public:
+    // A world of one type (air by default)
+    VoxelOctree(int width, int height, int depth, BlockType fill = BlockType::Air);
+
+    // Every block of a world (generating lazy chunks as needed), one chunk
+    // subtree at a time
+    static VoxelOctree FromWorld(const World& world);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int GetDepth() const { return depth; }
+
+    // Edge of the root cube and levels below it
+    int GetRootSize() const { return size; }
+    int GetLevels() const { return levels; }
+
+    // Block at a position; outside the world reads as air. O(depth).
+    BlockType GetBlockType(int x, int y, int z) const;
+
+    // Change one block (no-op outside the world), splitting leaves on the
+    // way down and merging uniform siblings on the way back. O(depth).
+    void SetBlock(int x, int y, int z, BlockType type);
+
+    // Make every block of a box (clipped to the world) one type
+    void FillRegion(const VoxelBox& box, BlockType type);
+
+    // Replace a chunk's blocks with CHUNK_VOLUME types in LocalIndex order
+    // (voxels past the world's edge are ignored); O(CHUNK_VOLUME + depth)
+    void SetChunkTypes(const ChunkCoord& coord, const BlockType* types);
+
+    // True if the blocks of a box (clipped to the world, not empty) are all
+    // one type, which goes to type if given
+    bool IsRegionUniform(const VoxelBox& box, BlockType* type = nullptr) const;
+
+    // Whether a box (clipped to the world) holds air, solid blocks or both;
+    // nodes inside the box answer from their summary without descending
+    uint8_t GetRegionContents(const VoxelBox& box) const;
+    bool IsRegionAir(const VoxelBox& box) const { return GetRegionContents(box) == REGION_AIR; }
+    bool IsRegionSolid(const VoxelBox& box) const { return GetRegionContents(box) == REGION_SOLID; }
+
+    // Visit a box (clipped to the world) as uniform boxes, one per leaf it
+    // overlaps: fn(const VoxelBox&, BlockType)
+    template <typename Fn>
+    void ForEachRegion(const VoxelBox& box, Fn&& fn) const {
+        VoxelBox clipped = box.Intersect(GetBounds());
+        if (!clipped.IsEmpty()) {
+            VisitRegion(0, 0, 0, 0, size, clipped, fn);
+        }
+    }
+
+    // Visit the solid leaves a frustum may see (blocks centred on integer
+    // coordinates, as drawn): fn(const VoxelBox&, BlockType). Subtrees
+    // outside the frustum or all air are skipped whole.
+    template <typename Fn>
+    void ForEachVisibleRegion(const Frustum& frustum, Fn&& fn) const {
+        VisitVisible(0, 0, 0, 0, size, ALL_FRUSTUM_PLANES, frustum, fn);
+    }
+
+    // A chunk's blocks, CHUNK_VOLUME types in LocalIndex order (voxels
+    // past the edge are air), filled a uniform box at a time
+    void GetChunkTypes(const ChunkCoord& coord, BlockType* out) const;
+
+    // Nodes in use (leaves and inner nodes)
+    size_t GetNodeCount() const { return nodes.size() - freeGroups.size() * 8; }
+
+    // Bytes used by the node pool
+    size_t GetMemoryUsage() const;
+
+private:
+    // children is the first of 8 consecutive nodes (0 for a leaf; child i
+    // covers the octant with x, y, z offsets from bits 0, 1, 2 of i). A
+    // leaf's region is all type; contents summarises any node's region.
+    // Only the part of a region inside the world counts, so a leaf may
+    // reach past the world's edge.
+    struct Node {
+        uint32_t children;
+        BlockType type;
+        uint8_t contents;
+    };
+
+    int width, height, depth;
+    int size;    // root edge, a power of two
+    int levels;  // log2(size)
+    std::vector<Node> nodes;              // nodes[0] is the root
+    std::vector<uint32_t> freeGroups;     // released groups of 8 children
+
+    VoxelBox GetBounds() const { return { 0, 0, 0, width, height, depth }; }
+
+    static uint8_t ContentsOf(BlockType type) {
+        return type == BlockType::Air ? REGION_AIR : REGION_SOLID;
+    }
+
+    // Make a node a leaf of one type, releasing its subtree
+    void MakeLeaf(uint32_t node, BlockType type);
+
+    // Give a leaf 8 children of its type
+    void Split(uint32_t node);
+
+    // After the children of the node at (x, y, z) changed: merge them if
+    // the ones inside the world are leaves of one type, else refresh the
+    // node's contents
+    void Refresh(uint32_t node, int x, int y, int z, int cellSize);
+
+    void ReleaseChildren(uint32_t node);
+
+    void Fill(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box, BlockType type);
+    void Build(uint32_t node, int x, int y, int z, int cellSize, const BlockType* types);
+    bool Uniform(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box,
+                 BlockType& found, bool& any) const;
+    uint8_t Contents(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box) const;
+
+    static VoxelBox Cell(int x, int y, int z, int cellSize) {
+        return { x, y, z, x + cellSize, y + cellSize, z + cellSize };
+    }
+
+    template <typename Fn>
+    void VisitRegion(uint32_t node, int x, int y, int z, int cellSize, const VoxelBox& box, Fn& fn) const {
+        VoxelBox clipped = Cell(x, y, z, cellSize).Intersect(box);
+        if (clipped.IsEmpty()) return;
+        const Node& n = nodes[node];
+        if (n.children == 0) {
+            fn(clipped, n.type);
+            return;
+        }
+        int half = cellSize / 2;
+        for (int i = 0; i < 8; ++i) {
+            VisitRegion(n.children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+                        half, box, fn);
+        }
+    }
+
+    template <typename Fn>
+    void VisitVisible(uint32_t node, int x, int y, int z, int cellSize, uint8_t planes,
+                      const Frustum& frustum, Fn& fn) const {
+        const Node& n = nodes[node];
+        if (n.contents == REGION_AIR) return;
+        VoxelBox clipped = Cell(x, y, z, cellSize).Intersect(GetBounds());
+        if (clipped.IsEmpty()) return;
+        BoundingBox bounds = {
+            { clipped.minX - 0.5f, clipped.minY - 0.5f, clipped.minZ - 0.5f },
+            { clipped.maxX - 0.5f, clipped.maxY - 0.5f, clipped.maxZ - 0.5f },
+        };
+        if (ClassifyAABB(frustum, bounds, planes) == Containment::Outside) return;
+        if (n.children == 0) {
+            fn(clipped, n.type);
+            return;
+        }
+        int half = cellSize / 2;
+        for (int i = 0; i < 8; ++i) {
+            VisitVisible(n.children + i, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half,
+                         half, planes, frustum, fn);
+        }
+    }
+};
+
+} // namespace World
+
+#endif // VOXEL_OCTREE_H
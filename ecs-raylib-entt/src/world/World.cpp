@@ -1,101 +1,594 @@
 #include "World.hpp"
+#include "ChunkMesher.hpp"
 #include <iostream>
 #include <iomanip>
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
 
 namespace World {
 
-World::World() : rng(std::random_device{}()) {
-    InitializeGrid();
+World::World(int width, int height, int depth, uint64_t seed)
+    : width(width), height(height), depth(depth), seed(seed), regions(width, height, depth) {
 }
 
-void World::InitializeGrid() {
-    grid.clear();
-    grid.resize(WORLD_HEIGHT);
-    for (int y = 0; y < WORLD_HEIGHT; ++y) {
-        grid[y].resize(WORLD_DEPTH);
-        for (int z = 0; z < WORLD_DEPTH; ++z) {
-            grid[y][z].resize(WORLD_WIDTH);
-        }
+void World::SetGeneratorMode(GeneratorMode mode) {
+    generatorMode = mode;
+    UpdateTerrain();
+}
+
+void World::SetTerrainRules(const TerrainRules& rules) {
+    terrainRules = rules;
+    UpdateTerrain();
+}
+
+void World::UpdateTerrain() {
+    if (generatorMode == GeneratorMode::Terrain) {
+        terrain = std::make_shared<TerrainGenerator>(terrainRules, seed, height);
+    } else {
+        terrain.reset();
     }
+    InvalidateHeights();  // ungenerated chunks of a lazy world changed
+    columnRuns.reset();
+}
+
+void World::SetColumnRunIndex(bool enabled) {
+    columnRunIndex = enabled;
+    columnRuns.reset();
 }
 
 void World::Generate() {
+    Generate(seed, DefaultThreadCount());
+}
+
+void World::Generate(uint64_t newSeed) {
+    Generate(newSeed, DefaultThreadCount());
+}
+
+uint64_t World::RandomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+int World::DefaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void World::Generate(uint64_t newSeed, int threads) {
     // Generate completely solid world
     // Blocks on ANY boundary surface (6 faces): 80% Soil, 20% Stone
     // Interior blocks: 70% Stone, 20% Gold, 10% Silver
+    // Chunks are allocated (and given revisions) up front in a fixed order,
+    // then filled by the worker threads, each taking the next chunk column
+    // (terrain computes a column's heights once for all of its chunks)
     
-    for (int y = 0; y < WORLD_HEIGHT; ++y) {
-        for (int z = 0; z < WORLD_DEPTH; ++z) {
-            for (int x = 0; x < WORLD_WIDTH; ++x) {
-                // Check if this block is on any boundary (exposed surface)
-                if (IsExposedSurface(x, y, z)) {
-                    // Surface block: 80% Soil, 20% Stone
-                    grid[y][z][x] = GenerateSurfaceBlock();
+    seed = newSeed;
+    lazy = false;
+    file.reset();
+    UpdateTerrain();
+    modifiedChunks.clear();
+    ResetSaveState();
+    InvalidateHeights();
+    InvalidateRegions();
+    if (chunks.size() != static_cast<size_t>(GetChunksX()) * GetChunksY() * GetChunksZ()) {
+        ++layoutRevision;  // the full set of chunks differs from what was allocated
+    }
+    chunks.clear();
+    std::vector<std::vector<std::pair<ChunkCoord, Chunk*>>> work(static_cast<size_t>(GetChunksX()) * GetChunksZ());
+    ForEachChunkCoord([&](const ChunkCoord& coord) {
+        Chunk& chunk = chunks.emplace(coord, Chunk()).first->second;
+        chunk.SetRevision(++revisionCounter);
+        work[ColumnIndex(coord.x, coord.z)].emplace_back(coord, &chunk);
+    });
+    
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        std::vector<BlockType> scratch(CHUNK_VOLUME);
+        std::vector<int> heights(CHUNK_SIZE * CHUNK_SIZE);
+        for (size_t i = next++; i < work.size(); i = next++) {
+            if (terrain) {
+                const ChunkCoord& column = work[i].front().first;
+                terrain->GetHeights(column.x, column.z, width, depth, heights.data());
+            }
+            for (auto& [coord, chunk] : work[i]) {
+                if (terrain) {
+                    terrain->GenerateChunk(coord, width, height, depth, scratch.data(), heights.data());
                 } else {
-                    // Interior block: Stone, Gold, or Silver
-                    grid[y][z][x] = GenerateUndergroundBlock();
+                    GenerateChunkTypes(coord, scratch.data());
                 }
+                chunk->Encode(scratch.data());
             }
         }
+    };
+    
+    int workers = std::min(std::max(threads, 1), static_cast<int>(work.size()));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; ++t) {
+        pool.emplace_back(worker);
     }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+void World::GenerateLazily() {
+    GenerateLazily(seed);
+}
+
+void World::GenerateLazily(uint64_t newSeed) {
+    seed = newSeed;
+    lazy = true;
+    file.reset();
+    UpdateTerrain();
+    InvalidateHeights();
+    InvalidateRegions();
+    chunks.clear();
+    modifiedChunks.clear();
+    ResetSaveState();
+    ++layoutRevision;
+}
+
+FileStatus World::Save(const std::string& path, SaveMode mode) const {
+    return WriteSnapshot(*Capture(mode, false), path);
+}
+
+std::shared_ptr<const SaveSnapshot> World::CaptureSave(SaveMode mode) {
+    // Chunks of a capture still being written are not in the save file yet
+    std::shared_ptr<SaveSnapshot> snapshot = Capture(mode, !savePending);
+    snapshot->epoch = ++saveEpoch;
+    savePending = true;
+    unsavedChunks.clear();
+    return snapshot;
 }
 
-Block World::GenerateSurfaceBlock() {
-    // Generate random number between 0 and 99
-    std::uniform_int_distribution<int> dist(0, 99);
-    int roll = dist(rng);
+std::shared_ptr<SaveSnapshot> World::Capture(SaveMode mode, bool incremental) const {
+    size_t chunkCount = static_cast<size_t>(GetChunksX()) * GetChunksY() * GetChunksZ();
+    if (!GeneratesMissingChunks() && (lazy || chunks.size() != chunkCount)) {
+        mode = SaveMode::Snapshot;  // unmodified chunks may not match the seed
+    }
     
-    // 80% chance for Soil (0-79), 20% chance for Stone (80-99)
-    if (roll < 80) {
-        return Block(BlockType::Soil);
+    auto snapshot = std::make_shared<SaveSnapshot>();
+    WorldFileInfo& info = snapshot->info;
+    info.width = width;
+    info.height = height;
+    info.depth = depth;
+    info.seed = seed;
+    info.generatorMode = generatorMode;
+    info.terrainRules = terrainRules;
+    info.lazy = mode == SaveMode::Delta || GeneratesMissingChunks();
+    snapshot->mode = mode;
+    snapshot->source = CopySource();
+    
+    // The save file (or without one, the seed) holds every chunk that was
+    // not changed since the last capture, so only the changed ones are
+    // needed, as long as it records chunks the same way
+    snapshot->incremental = incremental && (file ? file->GetInfo().lazy == info.lazy : info.lazy);
+    if (snapshot->incremental) {
+        for (const ChunkCoord& coord : unsavedChunks) {
+            auto it = chunks.find(coord);
+            if (it == chunks.end()) continue;  // unloaded, reads as its saved copy again
+            bool modified = IsChunkModified(coord);
+            snapshot->replaced.push_back(coord);
+            if (info.lazy && !modified) continue;  // regenerated
+            snapshot->chunks.push_back({ coord, it->second, modified });
+        }
+        return snapshot;
+    }
+    
+    if (mode == SaveMode::Delta) {
+        // Only edited chunks differ from the seed
+        for (const ChunkCoord& coord : modifiedChunks) {
+            auto it = chunks.find(coord);
+            if (it == chunks.end()) continue;  // still in the file, carried over
+            snapshot->chunks.push_back({ coord, it->second, true });
+        }
     } else {
-        return Block(BlockType::Stone);
+        for (const auto& [coord, chunk] : chunks) {
+            bool modified = IsChunkModified(coord);
+            if (info.lazy && !modified) continue;  // generated again when needed
+            snapshot->chunks.push_back({ coord, chunk, modified });
+        }
     }
+    // Saved chunks never made resident since the load are carried over
+    if (file) {
+        snapshot->replaced.reserve(chunks.size());
+        for (const auto& [coord, chunk] : chunks) {
+            snapshot->replaced.push_back(coord);
+        }
+    }
+    return snapshot;
 }
 
-Block World::GenerateUndergroundBlock() {
-    // Underground distribution:
-    // 70% Stone, 20% Gold, 10% Silver (implementation-defined)
-    // You can adjust these percentages as needed
-    std::uniform_int_distribution<int> dist(0, 99);
-    int roll = dist(rng);
+FileStatus World::WriteSnapshot(const SaveSnapshot& snapshot, const std::string& path, SaveStats* stats) {
+    auto started = std::chrono::steady_clock::now();
+    WorldFileWriter writer(path, snapshot.info);
+    size_t written = 0, carried = 0;
+    std::vector<BlockType> types(CHUNK_VOLUME), generated(CHUNK_VOLUME);
+    for (const SaveSnapshot::SavedChunk& saved : snapshot.chunks) {
+        if (snapshot.mode == SaveMode::Delta) {
+            // An edit that was undone leaves nothing to store
+            saved.chunk.Decode(types.data());
+            snapshot.source->GenerateChunkTypes(saved.coord, generated.data());
+            written += writer.AddChunkChanges(saved.coord, types.data(), generated.data()) ? 1 : 0;
+        } else {
+            writer.AddChunk(saved.coord, saved.chunk, saved.modified);
+            ++written;
+        }
+    }
+    if (const WorldFile* file = snapshot.source->GetSaveFile()) {
+        std::unordered_set<ChunkCoord, ChunkCoordHash> replaced(snapshot.replaced.begin(), snapshot.replaced.end());
+        for (size_t i = 0; i < file->GetChunkCount(); ++i) {
+            if (replaced.count(file->GetChunkCoord(i)) == 0) {
+                writer.CopyChunk(*file, i);
+                ++carried;
+            }
+        }
+    }
+    FileStatus status = writer.Finish();
     
-    if (roll < 70) {
-        return Block(BlockType::Stone);
-    } else if (roll < 90) {
-        return Block(BlockType::Gold);
-    } else {
-        return Block(BlockType::Silver);
+    if (stats) {
+        stats->status = status;
+        stats->incremental = snapshot.incremental;
+        stats->chunksCaptured = snapshot.chunks.size();
+        stats->chunksWritten = written;
+        stats->chunksCarried = carried;
+        stats->bytesWritten = status == FileStatus::Ok ? writer.GetFileSize() : 0;
+        stats->writeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
     }
+    return status;
+}
+
+void World::CompleteSave(const SaveSnapshot& snapshot, std::shared_ptr<const WorldFile> written) {
+    if (snapshot.epoch != saveEpoch) {
+        return;  // captured before the world was replaced, or superseded
+    }
+    savePending = false;
+    if (!written) {
+        // The save file is still the one before the capture
+        for (const SaveSnapshot::SavedChunk& saved : snapshot.chunks) {
+            unsavedChunks.insert(saved.coord);
+        }
+        unsavedChunks.insert(snapshot.replaced.begin(), snapshot.replaced.end());
+        return;
+    }
+    file = std::move(written);
+}
+
+void World::ResetSaveState() {
+    unsavedChunks.clear();
+    ++saveEpoch;
+    savePending = false;
+}
+
+FileStatus World::Load(const std::string& path, bool verifyChunks) {
+    FileStatus status;
+    std::shared_ptr<const WorldFile> opened = WorldFile::Open(path, status);
+    if (!opened) {
+        return status;
+    }
+    if (verifyChunks && opened->CountCorruptChunks() > 0) {
+        return FileStatus::Corrupt;
+    }
+    
+    const WorldFileInfo& info = opened->GetInfo();
+    width = info.width;
+    height = info.height;
+    depth = info.depth;
+    seed = info.seed;
+    generatorMode = info.generatorMode;
+    terrainRules = info.terrainRules;
+    lazy = true;
+    file = std::move(opened);
+    UpdateTerrain();
+    InvalidateHeights();
+    InvalidateRegions();
+    chunks.clear();
+    modifiedChunks.clear();
+    ResetSaveState();
+    for (size_t i = 0; i < file->GetChunkCount(); ++i) {
+        if (file->IsChunkModified(i)) {
+            modifiedChunks.insert(file->GetChunkCoord(i));
+        }
+    }
+    ++layoutRevision;
+    return FileStatus::Ok;
+}
+
+std::shared_ptr<const World> World::CopySource() const {
+    auto copy = std::make_shared<World>(width, height, depth, seed);
+    copy->generatorMode = generatorMode;
+    copy->terrainRules = terrainRules;
+    copy->terrain = terrain;
+    copy->lazy = lazy;
+    copy->file = file;
+    return copy;
 }
 
-const Block& World::GetBlock(int x, int y, int z) const {
+const Chunk* World::LoadChunk(const ChunkCoord& coord) {
+    return LoadChunk(coord, nullptr);
+}
+
+const Chunk* World::LoadChunk(const ChunkCoord& coord, const BlockType* generated) {
+    if (!IsValidChunk(coord)) {
+        return nullptr;
+    }
+    if (!lazy) {
+        return GetChunk(coord);
+    }
+    return &MaterializeChunk(coord, generated);
+}
+
+bool World::UnloadChunk(const ChunkCoord& coord) {
+    // A saved copy with edits would bring them back after RegenerateChunk
+    size_t saved = FindSavedChunk(coord);
+    if (!lazy || IsChunkModified(coord) || (saved != WorldFile::NOT_FOUND && file->IsChunkModified(saved)) ||
+        chunks.erase(coord) == 0) {
+        return false;
+    }
+    if (regionsBuilt) {
+        regions.FillRegion(VoxelBox::OfChunk(coord), BlockType::Air);
+    }
+    ++layoutRevision;
+    return true;
+}
+
+bool World::IsChunkModified(const ChunkCoord& coord) const {
+    return modifiedChunks.count(coord) != 0;
+}
+
+void World::GetLoadedChunks(std::vector<ChunkCoord>& out) const {
+    out.clear();
+    out.reserve(chunks.size());
+    for (const auto& [coord, chunk] : chunks) {
+        out.push_back(coord);
+    }
+}
+
+Chunk& World::MaterializeChunk(const ChunkCoord& coord, const BlockType* generated) {
+    auto it = chunks.find(coord);
+    if (it != chunks.end()) {
+        return it->second;
+    }
+    
+    Chunk& chunk = chunks.emplace(coord, Chunk(BlockType::Air)).first->second;
+    if (generated) {
+        chunk.Encode(generated);
+        if (regionsBuilt) regions.SetChunkTypes(coord, generated);
+    } else if (lazy) {
+        std::vector<BlockType> data(CHUNK_VOLUME);
+        GetSourceChunkTypes(coord, data.data());
+        chunk.Encode(data.data());
+        if (regionsBuilt) regions.SetChunkTypes(coord, data.data());
+    }
+    chunk.SetRevision(++revisionCounter);
+    ++layoutRevision;
+    return chunk;
+}
+
+BlockType World::GenerateBlock(int x, int y, int z) const {
     if (!IsValidPosition(x, y, z)) {
-        static Block emptyBlock(BlockType::Stone);
-        return emptyBlock;
+        return BlockType::Air;
+    }
+    
+    if (terrain) {
+        return terrain->GenerateBlock(x, y, z);
+    }
+    
+    RowRandom random(seed, y, z);
+    // Check if this block is on any boundary (exposed surface)
+    if (IsExposedSurface(x, y, z)) {
+        // Surface block: 80% Soil, 20% Stone
+        return GetSurfaceSampler().Sample(random, x);
+    }
+    // Interior block: Stone, Gold, or Silver
+    return GetUndergroundSampler().Sample(random, x);
+}
+
+void World::GenerateChunkTypes(const ChunkCoord& coord, BlockType* out) const {
+    if (terrain && IsValidChunk(coord)) {
+        terrain->GenerateChunk(coord, width, height, depth, out);
+        return;
+    }
+    
+    // Same blocks as GenerateBlock, a row at a time: each row is split
+    // into its shell and interior spans once, and every span is drawn in
+    // one batch from its distribution
+    const BlockSampler& surface = GetSurfaceSampler();
+    const BlockSampler& underground = GetUndergroundSampler();
+    
+    std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+    if (!IsValidChunk(coord)) {
+        return;
+    }
+    
+    int baseX = coord.x << CHUNK_SHIFT;
+    int baseY = coord.y << CHUNK_SHIFT;
+    int baseZ = coord.z << CHUNK_SHIFT;
+    int endX = std::min(baseX + CHUNK_SIZE, width);
+    int sizeY = std::min(CHUNK_SIZE, height - baseY);
+    int sizeZ = std::min(CHUNK_SIZE, depth - baseZ);
+    BlockType row[CHUNK_SIZE];
+    
+    for (int ly = 0; ly < sizeY; ++ly) {
+        for (int lz = 0; lz < sizeZ; ++lz) {
+            int y = baseY + ly, z = baseZ + lz;
+            RowRandom random(seed, y, z);
+            RowSpan interior = GetInteriorSpan(y, z);
+            int innerBegin = std::clamp(interior.begin, baseX, endX);
+            int innerEnd = std::clamp(interior.end, innerBegin, endX);
+            
+            surface.SampleRow(random, baseX, innerBegin, row);
+            underground.SampleRow(random, innerBegin, innerEnd, row + (innerBegin - baseX));
+            surface.SampleRow(random, innerEnd, endX, row + (innerEnd - baseX));
+            
+            if constexpr (GRID_LAYOUT == VoxelLayout::YZX) {
+                std::copy(row, row + (endX - baseX), out + LocalIndex(0, ly, lz));
+            } else {
+                for (int lx = 0; lx < endX - baseX; ++lx) {
+                    out[LocalIndex(lx, ly, lz)] = row[lx];
+                }
+            }
+        }
+    }
+}
+
+void World::RegenerateBlock(int x, int y, int z) {
+    if (IsValidPosition(x, y, z)) {
+        SetBlock(x, y, z, Block(GenerateBlock(x, y, z)));
     }
-    return grid[y][z][x];
 }
 
-Block& World::GetBlockMutable(int x, int y, int z) {
-    static Block errorBlock(BlockType::Stone);
+void World::RegenerateChunk(const ChunkCoord& coord) {
+    if (!IsValidChunk(coord)) {
+        return;
+    }
+    
+    std::vector<BlockType> data(CHUNK_VOLUME);
+    GenerateChunkTypes(coord, data.data());
+    auto [it, added] = chunks.try_emplace(coord);
+    if (added) {
+        ++layoutRevision;
+    }
+    it->second.Encode(data.data());
+    it->second.SetRevision(++revisionCounter);
+    modifiedChunks.erase(coord);
+    unsavedChunks.insert(coord);
+    InvalidateHeights(coord.x, coord.z);
+    if (regionsBuilt) {
+        regions.SetChunkTypes(coord, data.data());
+    }
+    if (columnRuns) {
+        columnRuns->SetChunkTypes(coord, data.data());
+    }
+    
+    // Blocks on the border of the neighbouring chunks see this chunk's faces
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int dir = -1; dir <= 1; dir += 2) {
+            ChunkCoord neighbour = coord;
+            (axis == 0 ? neighbour.x : axis == 1 ? neighbour.y : neighbour.z) += dir;
+            TouchChunk(neighbour);
+        }
+    }
+}
+
+const BlockSampler& World::GetSurfaceSampler() {
+    // 80% chance for Soil, 20% chance for Stone
+    static const BlockSampler sampler({ { BlockType::Soil, 80 }, { BlockType::Stone, 20 } });
+    return sampler;
+}
+
+const BlockSampler& World::GetUndergroundSampler() {
+    // Underground distribution:
+    // 70% Stone, 20% Gold, 10% Silver (implementation-defined)
+    // You can adjust these percentages as needed
+    static const BlockSampler sampler({ { BlockType::Stone, 70 }, { BlockType::Gold, 20 }, { BlockType::Silver, 10 } });
+    return sampler;
+}
+
+Block World::GetBlock(int x, int y, int z) const {
+    return Block(GetBlockType(x, y, z));
+}
+
+BlockType World::GetBlockType(int x, int y, int z) const {
     if (!IsValidPosition(x, y, z)) {
-        return errorBlock;
+        return BlockType::Stone;
     }
-    return grid[y][z][x];
+    auto it = chunks.find(ChunkCoordOf(x, y, z));
+    if (it == chunks.end()) {
+        return lazy ? GetSourceBlock(x, y, z) : BlockType::Air;
+    }
+    return it->second.Get(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK);
 }
 
 void World::SetBlock(int x, int y, int z, const Block& block) {
-    if (IsValidPosition(x, y, z)) {
-        grid[y][z][x] = block;
+    if (!IsValidPosition(x, y, z) || GetBlockType(x, y, z) == block.type) {
+        return;
+    }
+    ChunkCoord coord = ChunkCoordOf(x, y, z);
+    Chunk& chunk = MaterializeChunk(coord);
+    int lx = x & CHUNK_MASK, ly = y & CHUNK_MASK, lz = z & CHUNK_MASK;
+    chunk.Set(lx, ly, lz, block.type);
+    chunk.SetRevision(++revisionCounter);
+    modifiedChunks.insert(coord);
+    unsavedChunks.insert(coord);
+    UpdateColumnHeight(x, y, z, block.type);
+    if (regionsBuilt) {
+        regions.SetBlock(x, y, z, block.type);
     }
+    if (columnRuns) {
+        columnRuns->SetBlock(x, y, z, block.type);
+    }
+    
+    // Faces of blocks across a chunk border depend on this block too
+    if (lx == 0)              TouchChunk({ coord.x - 1, coord.y, coord.z });
+    if (lx == CHUNK_MASK)     TouchChunk({ coord.x + 1, coord.y, coord.z });
+    if (ly == 0)              TouchChunk({ coord.x, coord.y - 1, coord.z });
+    if (ly == CHUNK_MASK)     TouchChunk({ coord.x, coord.y + 1, coord.z });
+    if (lz == 0)              TouchChunk({ coord.x, coord.y, coord.z - 1 });
+    if (lz == CHUNK_MASK)     TouchChunk({ coord.x, coord.y, coord.z + 1 });
+}
+
+void World::TouchChunk(const ChunkCoord& coord) {
+    auto it = chunks.find(coord);
+    if (it != chunks.end()) {
+        it->second.SetRevision(++revisionCounter);
+    }
+}
+
+uint64_t World::GetChunkRevision(const ChunkCoord& coord) const {
+    const Chunk* chunk = GetChunk(coord);
+    return chunk ? chunk->GetRevision() : 0;
 }
 
 bool World::IsValidPosition(int x, int y, int z) const {
-    return x >= 0 && x < WORLD_WIDTH && 
-           y >= 0 && y < WORLD_HEIGHT && 
-           z >= 0 && z < WORLD_DEPTH;
+    return x >= 0 && x < width && 
+           y >= 0 && y < height && 
+           z >= 0 && z < depth;
+}
+
+const Chunk* World::GetChunk(const ChunkCoord& coord) const {
+    auto it = chunks.find(coord);
+    return it == chunks.end() ? nullptr : &it->second;
+}
+
+void World::GetChunkTypes(const ChunkCoord& coord, BlockType* out) const {
+    if (const Chunk* chunk = GetChunk(coord)) {
+        chunk->Decode(out);
+    } else if (lazy) {
+        GetSourceChunkTypes(coord, out);
+    } else {
+        std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+    }
+}
+
+bool World::IsValidChunk(const ChunkCoord& coord) const {
+    return coord.x >= 0 && coord.x < GetChunksX() &&
+           coord.y >= 0 && coord.y < GetChunksY() &&
+           coord.z >= 0 && coord.z < GetChunksZ();
+}
+
+size_t World::GetUniformChunkCount() const {
+    size_t count = 0;
+    for (const auto& [coord, chunk] : chunks) {
+        if (chunk.IsUniform()) count++;
+    }
+    return count;
+}
+
+size_t World::GetMemoryUsage() const {
+    // Chunk objects and their palettes/indices, plus the hash map's bucket array
+    size_t bytes = chunks.bucket_count() * sizeof(void*);
+    for (const auto& [coord, chunk] : chunks) {
+        bytes += sizeof(ChunkCoord) + sizeof(Chunk) + chunk.MemoryUsage();
+    }
+    return bytes;
+}
+
+size_t World::GetColumnRunIndexMemoryUsage() const {
+    return columnRuns ? columnRuns->GetMemoryUsage() : 0;
 }
 
 bool World::IsSurfaceLayer(int y) const {
@@ -106,86 +599,396 @@ bool World::IsExposedSurface(int x, int y, int z) const {
     // A block is part of the surface shell if it's within SURFACE_LAYER_COUNT distance
     // from ANY of the 6 boundaries
     // This creates a thick shell around the entire cube
-    
-    // Top layers (y = 0 to SURFACE_LAYER_COUNT-1)
-    if (y < SURFACE_LAYER_COUNT) return true;
-    
-    // Bottom layers (y = WORLD_HEIGHT-SURFACE_LAYER_COUNT to WORLD_HEIGHT-1)
-    if (y >= WORLD_HEIGHT - SURFACE_LAYER_COUNT) return true;
-    
-    // Left layers (x = 0 to SURFACE_LAYER_COUNT-1)
-    if (x < SURFACE_LAYER_COUNT) return true;
-    
-    // Right layers (x = WORLD_WIDTH-SURFACE_LAYER_COUNT to WORLD_WIDTH-1)
-    if (x >= WORLD_WIDTH - SURFACE_LAYER_COUNT) return true;
-    
-    // Front layers (z = 0 to SURFACE_LAYER_COUNT-1)
-    if (z < SURFACE_LAYER_COUNT) return true;
-    
-    // Back layers (z = WORLD_DEPTH-SURFACE_LAYER_COUNT to WORLD_DEPTH-1)
-    if (z >= WORLD_DEPTH - SURFACE_LAYER_COUNT) return true;
-    
-    // Not in any surface layer = interior
-    return false;
+    return !GetInteriorSpan(y, z).Contains(x);
+}
+
+RowSpan World::GetInteriorSpan(int y, int z) const {
+    // Rows in the top/bottom or front/back layers are all shell; any other
+    // row is shell only within SURFACE_LAYER_COUNT of its two ends
+    if (y < SURFACE_LAYER_COUNT || y >= height - SURFACE_LAYER_COUNT ||
+        z < SURFACE_LAYER_COUNT || z >= depth - SURFACE_LAYER_COUNT) {
+        return {};
+    }
+    return { SURFACE_LAYER_COUNT, width - SURFACE_LAYER_COUNT };
 }
 
 bool World::IsAir(int x, int y, int z) const {
-    // No air blocks in solid world
-    return false;
+    return IsValidPosition(x, y, z) && GetBlockType(x, y, z) == BlockType::Air;
 }
 
 void World::Clear() {
-    InitializeGrid();
+    chunks.clear();
+    modifiedChunks.clear();
+    ResetSaveState();
+    InvalidateHeights();
+    InvalidateRegions();
+    columnRuns.reset();
+    lazy = false;
+    file.reset();
+    ++layoutRevision;
 }
 
 int World::GetSurfaceLevel(int x, int z) const {
-    if (x < 0 || x >= WORLD_WIDTH || z < 0 || z >= WORLD_DEPTH) {
-        return 0; // fallback
+    // Highest solid block at this (x,z); if nothing found (or outside the
+    // world), just return 0
+    return std::max(GetColumnHeight(x, z), 0);
+}
+
+int World::GetColumnHeight(int x, int z) const {
+    if (x < 0 || x >= width || z < 0 || z >= depth) {
+        return -1;
+    }
+    const ColumnHeights& column = GetColumnHeights(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+    return column.heights[(z & CHUNK_MASK) * CHUNK_SIZE + (x & CHUNK_MASK)];
+}
+
+HeightRange World::GetChunkColumnHeights(int cx, int cz) const {
+    if (cx < 0 || cx >= GetChunksX() || cz < 0 || cz >= GetChunksZ()) {
+        return {};
+    }
+    return GetColumnHeights(cx, cz).range;
+}
+
+uint8_t World::GetResidentContents(const VoxelBox& box) const {
+    return GetRegions().GetRegionContents(box);
+}
+
+bool World::IsChunkEmpty(const ChunkCoord& coord) const {
+    if (!IsValidChunk(coord)) {
+        return false;
+    }
+    if (!GetChunk(coord)) {
+        return !lazy;
     }
+    return GetResidentContents(VoxelBox::OfChunk(coord)) == REGION_AIR;
+}
 
-    // Find the highest solid block (from top down) at this (x,z)
-    for (int y = WORLD_HEIGHT - 1; y >= 0; --y) {
-        const Block& b = grid[y][z][x];
-        if (true) {   // or just "if (true)" since you have no air yet
-            return y;
+bool World::IsChunkHidden(const ChunkCoord& coord) const {
+    if (IsChunkEmpty(coord)) {
+        return true;
+    }
+    
+    // Blocks on the world's edge show faces (see FillPaddedChunk)
+    VoxelBox around = VoxelBox::OfChunk(coord).Expand(1);
+    if (!GetChunk(coord) || around.minX < 0 || around.minY < 0 || around.minZ < 0 ||
+        around.maxX > width || around.maxY > height || around.maxZ > depth) {
+        return false;
+    }
+    return GetResidentContents(around) == REGION_SOLID;
+}
+
+const ColumnStore* World::GetColumnRuns() const {
+    if (!columnRunIndex || height > ColumnStore::MAX_HEIGHT) {
+        return nullptr;
+    }
+    if (!columnRuns) {
+        columnRuns = ColumnStore::FromWorld(*this);
+    }
+    return &*columnRuns;
+}
+
+void World::InvalidateRegions() {
+    regions = VoxelOctree(width, height, depth);
+    regionsBuilt = false;
+}
+
+const VoxelOctree& World::GetRegions() const {
+    if (!regionsBuilt) {
+        std::vector<BlockType> types(CHUNK_VOLUME);
+        for (const auto& [coord, chunk] : chunks) {
+            chunk.Decode(types.data());
+            regions.SetChunkTypes(coord, types.data());
         }
+        regionsBuilt = true;
     }
-    // If nothing found, just return 0
-    return 0;
+    return regions;
 }
 
-void World::PrintStatistics() const {
-    // Count each block type
-    std::map<BlockType, int> counts;
-    std::map<BlockType, int> surfaceCounts;
-    std::map<BlockType, int> interiorCounts;
-    int exposedSurfaceCount = 0;
-    int interiorBlockCount = 0;
-    
-    for (int y = 0; y < WORLD_HEIGHT; ++y) {
-        for (int z = 0; z < WORLD_DEPTH; ++z) {
-            for (int x = 0; x < WORLD_WIDTH; ++x) {
-                BlockType type = grid[y][z][x].type;
-                counts[type]++;
-                
-                // Check if this is an exposed surface (on any boundary)
-                if (IsExposedSurface(x, y, z)) {
-                    exposedSurfaceCount++;
-                    surfaceCounts[type]++;
+void World::InvalidateHeights() {
+    columnHeights.clear();
+}
+
+void World::InvalidateHeights(int cx, int cz) {
+    columnHeights.erase(ColumnIndex(cx, cz));
+}
+
+const World::ColumnHeights& World::GetColumnHeights(int cx, int cz) const {
+    auto [it, added] = columnHeights.try_emplace(ColumnIndex(cx, cz));
+    if (added) {
+        BuildColumnHeights(cx, cz, it->second);
+    }
+    return it->second;
+}
+
+int World::GeneratedTop(int x, int z) const {
+    return terrain ? terrain->GetHeight(x, z) : height - 1;
+}
+
+BlockType World::GetSourceBlock(int x, int y, int z) const {
+    size_t saved = FindSavedChunk(ChunkCoordOf(x, y, z));
+    if (saved != WorldFile::NOT_FOUND) {
+        BlockType base = file->IsChunkDelta(saved) ? GenerateBlock(x, y, z) : BlockType::Air;
+        return file->ReadBlock(saved, x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK, base);
+    }
+    return GeneratesMissingChunks() ? GenerateBlock(x, y, z) : BlockType::Air;
+}
+
+void World::GetSourceChunkTypes(const ChunkCoord& coord, BlockType* out) const {
+    size_t saved = FindSavedChunk(coord);
+    if (saved != WorldFile::NOT_FOUND) {
+        if (file->IsChunkDelta(saved)) {
+            GenerateChunkTypes(coord, out);  // the changes apply over it
+        }
+        file->ReadChunk(saved, out);
+    } else if (GeneratesMissingChunks()) {
+        GenerateChunkTypes(coord, out);
+    } else {
+        std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+    }
+}
+
+size_t World::FindSavedChunk(const ChunkCoord& coord) const {
+    return lazy && file ? file->Find(coord) : WorldFile::NOT_FOUND;
+}
+
+void World::BuildColumnHeights(int cx, int cz, ColumnHeights& column) const {
+    // Top down through the column's chunks until every (x, z) has found a
+    // solid block: uniform chunks answer at once, stored and saved chunks
+    // are decoded once, and ungenerated chunks of a lazy world only ask the
+    // generator from its highest possible solid block down
+    int baseX = cx << CHUNK_SHIFT, baseZ = cz << CHUNK_SHIFT;
+    int sizeX = std::min(CHUNK_SIZE, width - baseX);
+    int sizeZ = std::min(CHUNK_SIZE, depth - baseZ);
+    column.heights.fill(-1);
+    int unresolved = sizeX * sizeZ;
+    std::vector<BlockType> data;
+    
+    for (int cy = GetChunksY() - 1; cy >= 0 && unresolved > 0; --cy) {
+        int baseY = cy << CHUNK_SHIFT;
+        int topY = std::min(baseY + CHUNK_SIZE, height) - 1;
+        const Chunk* chunk = GetChunk({ cx, cy, cz });
+        size_t saved = chunk ? WorldFile::NOT_FOUND : FindSavedChunk({ cx, cy, cz });
+        bool generated = !chunk && saved == WorldFile::NOT_FOUND;
+        if (generated && !GeneratesMissingChunks()) continue;  // air
+        if (chunk && chunk->IsUniform() && chunk->GetUniformType() == BlockType::Air) continue;
+        bool decoded = saved != WorldFile::NOT_FOUND || (chunk && !chunk->IsUniform());
+        if (decoded) {
+            data.resize(CHUNK_VOLUME);
+            if (chunk) {
+                chunk->Decode(data.data());
+            } else {
+                GetSourceChunkTypes({ cx, cy, cz }, data.data());
+            }
+        }
+        
+        for (int lz = 0; lz < sizeZ; ++lz) {
+            for (int lx = 0; lx < sizeX; ++lx) {
+                int16_t& top = column.heights[lz * CHUNK_SIZE + lx];
+                if (top >= 0) continue;
+                int found = -1;
+                if (generated) {
+                    int x = baseX + lx, z = baseZ + lz;
+                    for (int y = std::min(topY, GeneratedTop(x, z)); y >= baseY && found < 0; --y) {
+                        if (GenerateBlock(x, y, z) != BlockType::Air) found = y;
+                    }
+                } else if (!decoded) {
+                    found = topY;  // uniform solid
                 } else {
-                    interiorBlockCount++;
-                    interiorCounts[type]++;
+                    for (int ly = topY - baseY; ly >= 0 && found < 0; --ly) {
+                        if (data[LocalIndex(lx, ly, lz)] != BlockType::Air) found = baseY + ly;
+                    }
+                }
+                if (found >= 0) {
+                    top = static_cast<int16_t>(found);
+                    --unresolved;
+                }
+            }
+        }
+    }
+    
+    UpdateColumnRange(cx, cz, column);
+}
+
+void World::UpdateColumnRange(int cx, int cz, ColumnHeights& column) const {
+    int sizeX = std::min(CHUNK_SIZE, width - (cx << CHUNK_SHIFT));
+    int sizeZ = std::min(CHUNK_SIZE, depth - (cz << CHUNK_SHIFT));
+    column.range = { height, -1 };
+    for (int lz = 0; lz < sizeZ; ++lz) {
+        for (int lx = 0; lx < sizeX; ++lx) {
+            int top = column.heights[lz * CHUNK_SIZE + lx];
+            column.range.lowest = std::min(column.range.lowest, top);
+            column.range.highest = std::max(column.range.highest, top);
+        }
+    }
+}
+
+void World::UpdateColumnHeight(int x, int y, int z, BlockType type) {
+    auto it = columnHeights.find(ColumnIndex(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT));
+    if (it == columnHeights.end()) {
+        return;  // built from the chunks when first asked for
+    }
+    ColumnHeights& column = it->second;
+    
+    int16_t& top = column.heights[(z & CHUNK_MASK) * CHUNK_SIZE + (x & CHUNK_MASK)];
+    int old = top;
+    if (type != BlockType::Air) {
+        if (y <= top) return;
+        top = static_cast<int16_t>(y);
+    } else {
+        if (y != top) return;
+        // The top block went away: the next solid one below (usually the
+        // very next block)
+        int below = y - 1;
+        while (below >= 0 && GetBlockType(x, below, z) == BlockType::Air) --below;
+        top = static_cast<int16_t>(below);
+    }
+    
+    // Widening the range is direct; only moving an extreme inwards needs
+    // the other columns
+    HeightRange& range = column.range;
+    if ((old == range.lowest && top > old) || (old == range.highest && top < old)) {
+        UpdateColumnRange(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT, column);
+    } else {
+        range.lowest = std::min<int>(range.lowest, top);
+        range.highest = std::max<int>(range.highest, top);
+    }
+}
+
+BlockStatistics World::ComputeStatistics(SimdLevel level) const {
+    if (const ColumnStore* runs = GetColumnRuns()) {
+        return runs->ComputeStatistics();
+    }
+    
+    BlockStatistics stats;
+    stats.width = width;
+    stats.height = height;
+    stats.depth = depth;
+    stats.layerCounts.assign(height, TypeCounts{});
+    
+    constexpr int LAYER_AREA = CHUNK_SIZE * CHUNK_SIZE;
+    std::vector<BlockType> local(CHUNK_VOLUME);
+    std::vector<BlockType> layered(CHUNK_VOLUME);
+    ForEachChunkCoord([&](const ChunkCoord& coord) {
+        GetChunkTypes(coord, local.data());
+        
+        // The kernels want each layer contiguous, rows along x
+        const BlockType* data = local.data();
+        if constexpr (GRID_LAYOUT != VoxelLayout::YZX) {
+            ForEachInLayout<GRID_LAYOUT>(CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE,
+                [&](int lx, int ly, int lz, size_t index) {
+                    layered[(ly * CHUNK_SIZE + lz) * CHUNK_SIZE + lx] = local[index];
+                });
+            data = layered.data();
+        }
+        
+        int baseX = coord.x << CHUNK_SHIFT;
+        int baseY = coord.y << CHUNK_SHIFT;
+        int baseZ = coord.z << CHUNK_SHIFT;
+        int sizeX = std::min(CHUNK_SIZE, width - baseX);
+        int sizeY = std::min(CHUNK_SIZE, height - baseY);
+        int sizeZ = std::min(CHUNK_SIZE, depth - baseZ);
+        uint64_t outside = LAYER_AREA - static_cast<uint64_t>(sizeX) * sizeZ;  // air past the world edge
+        
+        for (int ly = 0; ly < sizeY; ++ly) {
+            int y = baseY + ly;
+            const BlockType* layer = data + ly * LAYER_AREA;
+            TypeCounts& layerCounts = stats.layerCounts[y];
+            CountBlockTypes(layer, LAYER_AREA, layerCounts.data(), level);
+            layerCounts[static_cast<int>(BlockType::Air)] -= outside;
+            
+            // Interior spans; rows spanning the whole chunk width are
+            // merged into one contiguous run
+            const BlockType* run = nullptr;
+            size_t runLength = 0;
+            for (int lz = 0; lz < sizeZ; ++lz) {
+                RowSpan interior = GetInteriorSpan(y, baseZ + lz);
+                int lx0 = std::clamp(interior.begin - baseX, 0, sizeX);
+                int lx1 = std::clamp(interior.end - baseX, lx0, sizeX);
+                if (lx0 == 0 && lx1 == CHUNK_SIZE) {
+                    if (!run) run = layer + lz * CHUNK_SIZE;
+                    runLength += CHUNK_SIZE;
+                    continue;
+                }
+                if (run) {
+                    CountBlockTypes(run, runLength, stats.interiorCounts.data(), level);
+                    run = nullptr;
+                    runLength = 0;
+                }
+                if (lx0 < lx1) {
+                    CountBlockTypes(layer + lz * CHUNK_SIZE + lx0, lx1 - lx0, stats.interiorCounts.data(), level);
                 }
             }
+            if (run) {
+                CountBlockTypes(run, runLength, stats.interiorCounts.data(), level);
+            }
         }
+    });
+    
+    for (const TypeCounts& layer : stats.layerCounts) {
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) stats.counts[t] += layer[t];
     }
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+        stats.shellCounts[t] = stats.counts[t] - stats.interiorCounts[t];
+    }
+    return stats;
+}
+
+size_t World::CountVisibleFaces() const {
+    if (const ColumnStore* runs = GetColumnRuns()) {
+        return runs->CountVisibleFaces();
+    }
+    
+    std::vector<BlockType> local(CHUNK_VOLUME);
+    std::vector<BlockType> padded(PADDED_CHUNK_VOLUME);
+    size_t faces = 0;
+    ForEachChunkCoord([&](const ChunkCoord& coord) {
+        GetChunkTypes(coord, local.data());
+        FillPaddedChunk(*this, coord, local.data(), padded.data());
+        faces += ::World::CountVisibleFaces(padded.data());
+    });
+    return faces;
+}
+
+void World::PrintStatistics() const {
+    BlockStatistics stats = ComputeStatistics();
+    uint64_t exposedSurfaceCount = stats.GetShellSolid();
+    uint64_t interiorBlockCount = stats.GetInteriorSolid();
     
-    int totalBlocks = WORLD_WIDTH * WORLD_HEIGHT * WORLD_DEPTH;
+    uint64_t totalBlocks = stats.GetTotal();
+    uint64_t solidBlocks = stats.GetSolid();
+    
+    // One line per type present in a region (air only in the overall one)
+    auto printDistribution = [](const TypeCounts& region, uint64_t total, bool withAir) {
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) {
+            BlockType type = static_cast<BlockType>(t);
+            if (region[t] == 0 || (type == BlockType::Air && !withAir)) continue;
+            double percentage = (region[t] * 100.0) / total;
+            std::cout << std::setw(10) << Block::GetTypeName(type) << ": " 
+                      << std::setw(5) << region[t] << " (" 
+                      << std::fixed << std::setprecision(1) << percentage << "%)" << std::endl;
+        }
+    };
     
     std::cout << "\n===== WORLD STATISTICS (3D - SOLID WORLD WITH 6-FACE SURFACES) =====" << std::endl;
-    std::cout << "World Size: " << WORLD_WIDTH << "x" << WORLD_HEIGHT << "x" << WORLD_DEPTH
+    std::cout << "World Size: " << width << "x" << height << "x" << depth
               << " (" << totalBlocks << " blocks)" << std::endl;
-    std::cout << "All Blocks Solid: " << totalBlocks << " (100%)" << std::endl;
+    std::cout << "Seed: " << seed << ", generator: "
+              << (generatorMode == GeneratorMode::Terrain ? "noise terrain" : "solid cube")
+              << " (counted " << (GetColumnRuns() ? std::string("over the column run index")
+                                                  : std::string("with ") + GetSimdLevelName(DetectSimdLevel()))
+              << ")" << std::endl;
+    std::cout << "Chunks: " << chunks.size() << " of " << CHUNK_SIZE << "^3 ("
+              << GetUniformChunkCount() << " uniform)";
+    if (lazy && file) {
+        std::cout << ", loaded lazily (" << file->GetChunkCount() << " saved, "
+                  << file->GetSize() / 1024 << " KiB mapped), " << modifiedChunks.size() << " modified";
+    } else if (lazy) {
+        std::cout << ", generated lazily, " << modifiedChunks.size() << " modified";
+    }
+    std::cout << std::endl;
+    std::cout << "Solid Blocks: " << solidBlocks 
+              << " (" << std::fixed << std::setprecision(1) 
+              << (solidBlocks * 100.0 / totalBlocks) << "%)" << std::endl;
     std::cout << "Exposed Surface Blocks: " << exposedSurfaceCount 
               << " (" << std::fixed << std::setprecision(1) 
               << (exposedSurfaceCount * 100.0 / totalBlocks) << "% - on boundaries)" << std::endl;
@@ -194,27 +997,33 @@ void World::PrintStatistics() const {
               << (interiorBlockCount * 100.0 / totalBlocks) << "% - not on boundaries)" << std::endl;
     
     std::cout << "\n----- Overall Distribution -----" << std::endl;
-    for (const auto& [type, count] : counts) {
-        double percentage = (count * 100.0) / totalBlocks;
-        std::cout << std::setw(10) << Block::GetTypeName(type) << ": " 
-                  << std::setw(5) << count << " (" 
-                  << std::fixed << std::setprecision(1) << percentage << "%)" << std::endl;
-    }
+    printDistribution(stats.counts, totalBlocks, true);
     
     std::cout << "\n----- Exposed Surface Distribution (80/20 Soil/Stone) -----" << std::endl;
-    for (const auto& [type, count] : surfaceCounts) {
-        double percentage = (count * 100.0) / exposedSurfaceCount;
-        std::cout << std::setw(10) << Block::GetTypeName(type) << ": " 
-                  << std::setw(5) << count << " (" 
-                  << std::fixed << std::setprecision(1) << percentage << "%)" << std::endl;
-    }
+    printDistribution(stats.shellCounts, exposedSurfaceCount, false);
     
     std::cout << "\n----- Interior Block Distribution (70/20/10 Stone/Gold/Silver) -----" << std::endl;
-    for (const auto& [type, count] : interiorCounts) {
-        double percentage = (count * 100.0) / interiorBlockCount;
-        std::cout << std::setw(10) << Block::GetTypeName(type) << ": " 
-                  << std::setw(5) << count << " (" 
-                  << std::fixed << std::setprecision(1) << percentage << "%)" << std::endl;
+    printDistribution(stats.interiorCounts, interiorBlockCount, false);
+    
+    // Memory: palette index width per chunk and bytes per voxel
+    int chunksByBits[9] = {};
+    for (const auto& [coord, chunk] : chunks) {
+        chunksByBits[chunk.GetBitsPerVoxel()]++;
+    }
+    size_t memory = GetMemoryUsage();
+    
+    std::cout << "\n----- Memory (palette-compressed chunks) -----" << std::endl;
+    std::cout << "Chunk Data: " << memory << " bytes ("
+              << std::fixed << std::setprecision(3) << (memory * 1.0 / totalBlocks)
+              << " bytes/voxel, dense would be " << sizeof(BlockType) << ")" << std::endl;
+    std::cout << "Chunks by Index Width: uniform " << chunksByBits[0]
+              << ", 1-bit " << chunksByBits[1] << ", 2-bit " << chunksByBits[2]
+              << ", 4-bit " << chunksByBits[4] << ", 8-bit " << chunksByBits[8] << std::endl;
+    if (columnRuns) {
+        std::cout << "Column Run Index: " << GetColumnRunIndexMemoryUsage() << " bytes ("
+                  << columnRuns->GetRunCount() << " runs, "
+                  << std::fixed << std::setprecision(1) << (totalBlocks * 1.0 / columnRuns->GetRunCount())
+                  << " voxels/run)" << std::endl;
     }
     
     std::cout << "\n============================" << std::endl;
@@ -2,34 +2,245 @@
 #define WORLD_H
 
 #include "Block.hpp"
+#include "BlockSampler.hpp"
+#include "BlockStats.hpp"
+#include "Chunk.hpp"
+#include "ColumnStore.hpp"
+#include "Random.hpp"
+#include "Terrain.hpp"
+#include "VoxelOctree.hpp"
+#include "WorldFile.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <random>
 
 namespace World {
 
-// World dimensions (3D: Width x Height x Depth)
+// Default world dimensions (3D: Width x Height x Depth)
 constexpr int WORLD_WIDTH = 36;   // X-axis
 constexpr int WORLD_HEIGHT = 36;  // Y-axis (vertical)
 constexpr int WORLD_DEPTH = 36;   // Z-axis
 constexpr int SURFACE_LAYER_COUNT = 4;
 
+// Lowest and highest column height over some columns (-1: no solid block)
+struct HeightRange {
+    int lowest = -1;
+    int highest = -1;
+};
+
+// Half-open x-range [begin, end) within one row of voxels
+struct RowSpan {
+    int begin = 0;
+    int end = 0;
+
+    bool IsEmpty() const { return begin >= end; }
+    bool Contains(int x) const { return x >= begin && x < end; }
+    int Size() const { return IsEmpty() ? 0 : end - begin; }
+};
+
+class World;
+
+// An immutable view of what a save writes, taken by World::CaptureSave on
+// the world's thread and written by World::WriteSnapshot on any thread.
+// Chunks are copy-on-write copies (see Chunk), so the world can keep
+// editing the originals while the snapshot is written.
+struct SaveSnapshot {
+    struct SavedChunk {
+        ChunkCoord coord;
+        Chunk chunk;
+        bool modified;
+    };
+    
+    WorldFileInfo info;
+    SaveMode mode = SaveMode::Delta;
+    bool incremental = false;               // chunks holds only what changed since the save file
+    std::shared_ptr<const World> source;    // generator and save file (CopySource)
+    std::vector<SavedChunk> chunks;         // written from the snapshot
+    std::vector<ChunkCoord> replaced;       // not carried over from the save file
+    uint64_t epoch = 0;                     // which capture this is (see World::CompleteSave)
+};
+
+// What one save did
+struct SaveStats {
+    FileStatus status = FileStatus::Ok;
+    bool incremental = false;   // only chunks changed since the previous save were captured
+    size_t chunksCaptured = 0;  // copied from the world when the save started
+    size_t chunksWritten = 0;   // encoded into the file
+    size_t chunksCarried = 0;   // carried over from the previous file as they were
+    uint64_t bytesWritten = 0;  // size of the file
+    double captureMs = 0.0;     // taking the snapshot (the only part on the world's thread)
+    double writeMs = 0.0;       // encoding and writing the file
+    double wallMs = 0.0;        // from the capture to the file being in place
+};
+
 // Class representing the entire world grid
 class World {
 public:
-    // Constructor
-    World();
+    // Constructor (bounds are runtime values; defaults give the 36^3 cube).
+    // The seed decides every generated block; without one a random seed is
+    // picked (GetSeed() tells which, to reproduce the world later).
+    World(int width = WORLD_WIDTH, int height = WORLD_HEIGHT, int depth = WORLD_DEPTH,
+          uint64_t seed = RandomSeed());
     
     // Destructor
     ~World() = default;
     
-    // Generate the world with the specified rules
+    // Generate the world with the specified rules from the world's seed
     void Generate();
     
+    // Switch to a new seed and generate from it
+    void Generate(uint64_t seed);
+    
+    // Same, splitting the chunks across the given number of threads. Every
+    // block is a function of the seed and its coordinates, so the result
+    // does not depend on the thread count.
+    void Generate(uint64_t seed, int threads);
+    
+    // Start over as a lazy world: no chunk is generated up front. A chunk
+    // becomes resident when LoadChunk or SetBlock first touches it; until
+    // then GetBlock/GetBlockType answer straight from the generator. Cost is
+    // independent of the world size.
+    void GenerateLazily();
+    void GenerateLazily(uint64_t seed);
+    
+    // True if missing chunks stand for generated (or saved) terrain rather
+    // than air
+    bool IsLazy() const { return lazy; }
+    
+    // Write the world to a file (see WorldFile): bounds, seed, generator
+    // and chunks. Delta stores the seed and, per modified chunk, only the
+    // voxels that differ from the generated chunk (in full once that is
+    // smaller), so the file grows with the edits rather than the world; it
+    // needs every unmodified chunk to be what the seed generates, so a
+    // world that is neither lazy nor fully generated is saved as Snapshot.
+    // Snapshot stores whole chunks: a lazy world only its modified ones.
+    // The file is replaced only once complete.
+    FileStatus Save(const std::string& path, SaveMode mode = SaveMode::Delta) const;
+    
+    // Snapshot what Save would write, for writing elsewhere (see
+    // AutoSaver), and start counting unsaved chunks afresh. When the save
+    // file holds everything up to the previous capture (CompleteSave
+    // adopted it, or it was loaded) only the chunks changed since are
+    // copied, so the cost is O(unsaved chunks); otherwise, or while an
+    // earlier capture is not completed, every modified chunk is (every
+    // resident one for a Snapshot of an eager world).
+    std::shared_ptr<const SaveSnapshot> CaptureSave(SaveMode mode = SaveMode::Delta);
+    
+    // Write a snapshot to a file; safe on any thread. stats (if given)
+    // gets the chunk and byte counts and the write time.
+    static FileStatus WriteSnapshot(const SaveSnapshot& snapshot, const std::string& path,
+                                    SaveStats* stats = nullptr);
+    
+    // Report how writing a captured snapshot ended. On success written
+    // (the file as written) becomes the world's save file, which reads the
+    // same as the chunks it replaces, so the next capture can be
+    // incremental; on failure (nullptr) the captured chunks count as
+    // unsaved again. Ignored if the world was generated, loaded or cleared
+    // since the capture.
+    void CompleteSave(const SaveSnapshot& snapshot, std::shared_ptr<const WorldFile> written);
+    
+    // Chunks changed (SetBlock, RegenerateChunk) since the last capture,
+    // load or generation
+    size_t GetUnsavedChunkCount() const { return unsavedChunks.size(); }
+    
+    // Replace the world with one written by Save. The file is memory-mapped
+    // and nothing is decoded up front: the loaded world is lazy, and a
+    // missing chunk reads from the file if it is stored there (otherwise it
+    // is generated, or air if the saved world was not lazy). verifyChunks
+    // checks every chunk's checksum first; without it a damaged chunk is
+    // found when first read, and reads as air. On failure the world is
+    // left as it was.
+    FileStatus Load(const std::string& path, bool verifyChunks = false);
+    
+    // File the world was loaded from (or last saved to, see
+    // CompleteSave), or nullptr
+    const WorldFile* GetSaveFile() const { return file.get(); }
+    
+    // A world without resident chunks that reads what this world's missing
+    // chunks stand for (same bounds, seed, generator and save file), for
+    // other threads to read while this world changes (see ChunkPipeline)
+    std::shared_ptr<const World> CopySource() const;
+    
+    // Make a chunk resident, generating it if needed (lazy worlds; in an
+    // eager world this is just GetChunk). nullptr outside the world.
+    const Chunk* LoadChunk(const ChunkCoord& coord);
+    
+    // Same, with the chunk's contents already read from CopySource (e.g. on
+    // a worker thread); they must be what the missing chunk stands for
+    const Chunk* LoadChunk(const ChunkCoord& coord, const BlockType* generated);
+    
+    // Drop a resident chunk of a lazy world back to the generator. Chunks
+    // with edits (see IsChunkModified) are kept; returns true if dropped.
+    bool UnloadChunk(const ChunkCoord& coord);
+    
+    // True if SetBlock changed the chunk since it was generated
+    bool IsChunkModified(const ChunkCoord& coord) const;
+    
+    // Coordinates of every resident chunk, in no particular order
+    void GetLoadedChunks(std::vector<ChunkCoord>& out) const;
+    
+    // Changes whenever chunks are allocated or dropped (not when their
+    // contents change)
+    uint64_t GetChunkLayoutRevision() const { return layoutRevision; }
+    
+    // Seed the world generates from
+    uint64_t GetSeed() const { return seed; }
+    
+    // Generator used from now on by GenerateBlock/GenerateChunkTypes (and
+    // so lazy chunks not generated yet); chunks already generated keep
+    // their blocks until the world is generated again
+    void SetGeneratorMode(GeneratorMode mode);
+    GeneratorMode GetGeneratorMode() const { return generatorMode; }
+    
+    // Layer rules for GeneratorMode::Terrain; applied like SetGeneratorMode
+    void SetTerrainRules(const TerrainRules& rules);
+    const TerrainRules& GetTerrainRules() const { return terrainRules; }
+    
+    // Column run index: a cached copy of every block (lazy chunks as they
+    // would generate) as runs per (x, z) column, used only by
+    // ComputeStatistics and CountVisibleFaces, which then walk runs instead
+    // of chunks. Blocks are still read and written through the chunks; the
+    // index is built on first use and kept in step by SetBlock and
+    // RegenerateChunk, at the cost of its own memory. Worlds taller than
+    // ColumnStore::MAX_HEIGHT never use it.
+    void SetColumnRunIndex(bool enabled);
+    bool HasColumnRunIndex() const { return columnRunIndex; }
+    
+    // A fresh seed from std::random_device
+    static uint64_t RandomSeed();
+    
+    // Threads Generate() uses (one per hardware thread)
+    static int DefaultThreadCount();
+    
+    // The block the seed puts at (x, y, z). Pure: reads nothing but the
+    // seed and bounds, so any block can be produced without generating the
+    // rest of the world (Air outside the world).
+    BlockType GenerateBlock(int x, int y, int z) const;
+    
+    // Fill buffer (CHUNK_VOLUME types in LocalIndex order) with what the seed
+    // puts in one chunk; voxels outside the world are Air
+    void GenerateChunkTypes(const ChunkCoord& coord, BlockType* out) const;
+    
+    // Distributions generated blocks are drawn from: the shell (80% Soil,
+    // 20% Stone) and the interior (70% Stone, 20% Gold, 10% Silver)
+    static const BlockSampler& GetSurfaceSampler();
+    static const BlockSampler& GetUndergroundSampler();
+    
+    // Put one block or one chunk back to what the seed generates, undoing
+    // edits there. Revisions change as for SetBlock.
+    void RegenerateBlock(int x, int y, int z);
+    void RegenerateChunk(const ChunkCoord& coord);
+    
     // Get a block at a specific position (x, y, z)
-    const Block& GetBlock(int x, int y, int z) const;
+    Block GetBlock(int x, int y, int z) const;
     
-    // Get a mutable reference to a block
-    Block& GetBlockMutable(int x, int y, int z);
+    // Get only the type of a block (what the chunks actually store)
+    BlockType GetBlockType(int x, int y, int z) const;
     
     // Set a block at a specific position
     void SetBlock(int x, int y, int z, const Block& block);
@@ -42,39 +253,249 @@ public:
     
     // Check if a block is an exposed surface
     bool IsExposedSurface(int x, int y, int z) const;
+    
+    // The interior voxels of the row at (y, z): IsExposedSurface is false
+    // exactly for x inside the span, so the row splits into shell, interior,
+    // shell without testing each voxel. Empty when the whole row is shell.
+    RowSpan GetInteriorSpan(int y, int z) const;
 
-	int GetSurfaceLevel(int x, int z) const;
+    // y of the highest solid block in a column (0 if it has none). O(1):
+    // see GetColumnHeight.
+    int GetSurfaceLevel(int x, int z) const;
+    
+    // y of the highest solid block in a column, or -1 if it has none or is
+    // outside the world. Heights are kept per chunk column: built on first
+    // use (each chunk of the column decoded once; ungenerated chunks of a
+    // lazy world ask the generator) and kept up to date by SetBlock.
+    int GetColumnHeight(int x, int z) const;
+    
+    // Lowest and highest GetColumnHeight over the columns of chunk column
+    // (cx, cz); both -1 outside the world
+    HeightRange GetChunkColumnHeights(int cx, int cz) const;
+    
+    // Whether the resident blocks of a box hold air, solid blocks or both
+    // (RegionContents bits), from the resident chunk region index: a sparse
+    // voxel octree copy of the resident chunks (see VoxelOctree), built on
+    // first use and kept up to date as chunks change, so the cost follows
+    // the box's boundary rather than its volume. Blocks are still read and
+    // written through the chunks. Missing chunks count as air, which they are in an eager
+    // world; a lazy world's are not known until they are loaded.
+    uint8_t GetResidentContents(const VoxelBox& box) const;
+    
+    // True if a chunk is all air: a resident chunk by the region index, a
+    // missing one only in an eager world
+    bool IsChunkEmpty(const ChunkCoord& coord) const;
+    
+    // True if no block of a chunk has a face open to air, so there is
+    // nothing to mesh: the chunk is empty, or it and the one-voxel border
+    // around it are solid and inside the world. Conservative: false when a
+    // neighbour is a missing chunk of a lazy world.
+    bool IsChunkHidden(const ChunkCoord& coord) const;
 
-    // Check if a block is air (always false in solid world)
+    // Check if a block is air
     bool IsAir(int x, int y, int z) const;
     
     // Get world dimensions
-    int GetWidth() const { return WORLD_WIDTH; }
-    int GetHeight() const { return WORLD_HEIGHT; }
-    int GetDepth() const { return WORLD_DEPTH; }
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int GetDepth() const { return depth; }
+    
+    // Number of chunks along each axis
+    int GetChunksX() const { return (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT; }
+    int GetChunksY() const { return (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT; }
+    int GetChunksZ() const { return (depth + CHUNK_SIZE - 1) >> CHUNK_SHIFT; }
+    
+    // Chunk at a chunk coordinate, or nullptr if it is not resident (all
+    // air, or in a lazy world, not generated yet)
+    const Chunk* GetChunk(const ChunkCoord& coord) const;
+    
+    // Fill buffer (CHUNK_VOLUME types in LocalIndex order) with a chunk's
+    // blocks, whether resident or not
+    void GetChunkTypes(const ChunkCoord& coord, BlockType* out) const;
+    
+    // True if the chunk coordinate is inside the world
+    bool IsValidChunk(const ChunkCoord& coord) const;
+    
+    // Revision of a chunk; changes whenever its blocks, or blocks on the border
+    // of a neighbouring chunk, change. 0 for chunks that were never allocated.
+    uint64_t GetChunkRevision(const ChunkCoord& coord) const;
+    
+    // Number of allocated chunks, and how many of them are a single value
+    size_t GetChunkCount() const { return chunks.size(); }
+    size_t GetUniformChunkCount() const;
+    
+    // Heap bytes held by chunk voxel data
+    size_t GetMemoryUsage() const;
+    
+    // Heap bytes held by the column run index (0 until it is built)
+    size_t GetColumnRunIndexMemoryUsage() const;
+    
+    // Per-type, shell/interior and per-layer block counts in one pass over
+    // the chunks, counted with SIMD (level for benchmarks; lowered to what
+    // the CPU supports). Lazy worlds count what they would generate.
+    // With the column run index they come from run lengths instead,
+    // O(runs + height).
+    BlockStatistics ComputeStatistics(SimdLevel level = DetectSimdLevel()) const;
+    
+    // Faces of solid blocks that touch air (or the world's edge), the
+    // count the mesher culls down to, summed over the world: chunk by
+    // chunk through the mesher's culling, or with the column run index
+    // from overlapping runs, O(runs). Lazy worlds count what they would
+    // generate.
+    size_t CountVisibleFaces() const;
     
     // Print world statistics (for debugging)
     void PrintStatistics() const;
     
-    // Clear the world
+    // Clear the world (every block becomes air; the world is no longer lazy)
     void Clear();
 
 private:
-    // The grid of blocks (organized as [y][z][x] for layer-major access)
-    // Y = height (vertical layers), Z = depth, X = width
-    std::vector<std::vector<std::vector<Block>>> grid;
+    // World bounds
+    int width;
+    int height;
+    int depth;
+    
+    // Allocated chunks keyed by chunk coordinate; missing chunks are air
+    std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash> chunks;
+    
+    // Source of chunk revisions (never reused, so a rebuilt chunk never
+    // matches a revision cached from before)
+    uint64_t revisionCounter = 0;
+    
+    // Seed every generated block derives from
+    uint64_t seed;
+    
+    // Missing chunks are ungenerated terrain (GenerateLazily) rather than air
+    bool lazy = false;
+    
+    // Generator selection; terrain is built for the current seed in
+    // Terrain mode and shared (read-only) between copies of the world
+    GeneratorMode generatorMode = GeneratorMode::SolidCube;
+    TerrainRules terrainRules;
+    std::shared_ptr<const TerrainGenerator> terrain;
+    
+    // Save file missing chunks are read from first (Load), shared
+    // (read-only) between copies of the world
+    std::shared_ptr<const WorldFile> file;
+    
+    // Top solid block of every (x, z) column, per chunk column
+    struct ColumnHeights {
+        std::array<int16_t, CHUNK_SIZE * CHUNK_SIZE> heights{};  // [lz * CHUNK_SIZE + lx]
+        HeightRange range;
+    };
+    
+    // Chunk columns queried so far, keyed by ColumnIndex. Built on demand
+    // by const queries, hence mutable (queries are not safe to run
+    // concurrently with each other).
+    mutable std::unordered_map<size_t, ColumnHeights> columnHeights;
+    
+    // Resident chunk region index (missing chunks are air), built by
+    // GetRegions on first use; mutable like columnHeights
+    mutable VoxelOctree regions;
+    mutable bool regionsBuilt = false;
+    
+    // Column run index (SetColumnRunIndex), built by GetColumnRuns on
+    // first use; mutable like columnHeights
+    bool columnRunIndex = false;
+    mutable std::optional<ColumnStore> columnRuns;
+    
+    // Chunks SetBlock changed since they were generated
+    std::unordered_set<ChunkCoord, ChunkCoordHash> modifiedChunks;
+    
+    // Chunks changed since the last CaptureSave (or since the world was
+    // generated, loaded or cleared)
+    std::unordered_set<ChunkCoord, ChunkCoordHash> unsavedChunks;
+    
+    // Number of the latest capture; also bumped whenever the world is
+    // generated, loaded or cleared, which voids saves captured before
+    uint64_t saveEpoch = 0;
+    
+    // A capture has not been completed yet
+    bool savePending = false;
+    
+    // Bumped when the set of allocated chunks changes
+    uint64_t layoutRevision = 0;
+    
+    // Give a chunk a new revision if it exists
+    void TouchChunk(const ChunkCoord& coord);
+    
+    // Rebuild the terrain generator after the seed, mode or rules changed
+    void UpdateTerrain();
+    
+    // Drop cached column heights: all, or one chunk column's
+    void InvalidateHeights();
+    void InvalidateHeights(int cx, int cz);
+    
+    // Drop the region index (rebuilt on first use)
+    void InvalidateRegions();
+    
+    // The region index, building it if needed
+    const VoxelOctree& GetRegions() const;
+    
+    // The column run index, building it if needed; null unless it is
+    // enabled and the world is no taller than ColumnStore::MAX_HEIGHT
+    const ColumnStore* GetColumnRuns() const;
+    
+    // Cached heights of a chunk column, building them if needed
+    const ColumnHeights& GetColumnHeights(int cx, int cz) const;
+    void BuildColumnHeights(int cx, int cz, ColumnHeights& column) const;
+    void UpdateColumnRange(int cx, int cz, ColumnHeights& column) const;
+    
+    // Keep a built column's height right after SetBlock put type at (x, y, z)
+    void UpdateColumnHeight(int x, int y, int z, BlockType type);
+    
+    // Highest y the generator can put a solid block at in a column
+    int GeneratedTop(int x, int z) const;
+    
+    // What a missing chunk of a lazy world reads as: its saved copy if the
+    // save file has one, else the generator's blocks (or air)
+    BlockType GetSourceBlock(int x, int y, int z) const;
+    void GetSourceChunkTypes(const ChunkCoord& coord, BlockType* out) const;
+    
+    // Directory index of a chunk in the save file, or WorldFile::NOT_FOUND
+    size_t FindSavedChunk(const ChunkCoord& coord) const;
+    
+    // Missing chunks without a saved copy are generated (not air)
+    bool GeneratesMissingChunks() const { return lazy && (!file || file->GetInfo().lazy); }
+    
+    // Snapshot for Save and CaptureSave; incremental only takes the
+    // unsaved chunks
+    std::shared_ptr<SaveSnapshot> Capture(SaveMode mode, bool incremental) const;
+    
+    // Forget unsaved chunks and void captured saves (the world was replaced)
+    void ResetSaveState();
     
-    // Random number generator
-    std::mt19937 rng;
+    size_t ColumnIndex(int cx, int cz) const { return static_cast<size_t>(cz) * GetChunksX() + cx; }
     
-    // Generate a surface layer block (80% Soil, 20% Stone)
-    Block GenerateSurfaceBlock();
+    // Resident chunk at coord, generating it (lazy, unless generated is
+    // given) or allocating it as air (eager) if missing
+    Chunk& MaterializeChunk(const ChunkCoord& coord, const BlockType* generated = nullptr);
     
-    // Generate an underground layer block (Stone, Gold, or Silver)
-    Block GenerateUndergroundBlock();
+    // Visit every in-bounds voxel of one chunk in storage order:
+    // fn(x, y, z, localIndex) with world coordinates
+    template <typename Fn>
+    void ForEachVoxelInChunk(const ChunkCoord& coord, Fn&& fn) const {
+        int baseX = coord.x << CHUNK_SHIFT;
+        int baseY = coord.y << CHUNK_SHIFT;
+        int baseZ = coord.z << CHUNK_SHIFT;
+        ForEachInLayout<GRID_LAYOUT>(CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE,
+            [&](int lx, int ly, int lz, size_t index) {
+                int x = baseX + lx, y = baseY + ly, z = baseZ + lz;
+                if (x < width && y < height && z < depth) {
+                    fn(x, y, z, index);
+                }
+            });
+    }
     
-    // Initialize the grid with default blocks
-    void InitializeGrid();
+    // Visit every chunk coordinate inside the world bounds
+    template <typename Fn>
+    void ForEachChunkCoord(Fn&& fn) const {
+        for (int cy = 0; cy < GetChunksY(); ++cy)
+            for (int cz = 0; cz < GetChunksZ(); ++cz)
+                for (int cx = 0; cx < GetChunksX(); ++cx)
+                    fn(ChunkCoord{ cx, cy, cz });
+    }
 };
 
 } // namespace World
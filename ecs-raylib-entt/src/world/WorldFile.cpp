@@ -0,0 +1,726 @@
+#include "WorldFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace World {
+
+namespace {
+
+constexpr char MAGIC[4] = { 'V', 'X', 'W', 'F' };
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t ENTRY_SIZE = 32;
+constexpr size_t RULES_BASE_SIZE = 36;
+constexpr size_t ORE_RULE_SIZE = 16;
+constexpr uint32_t FLAG_LAZY = 1;
+constexpr uint32_t FLAG_MODIFIED = 1;
+
+// Header fields by offset
+constexpr size_t HEADER_VERSION = 4;
+constexpr size_t HEADER_CHUNK_SIZE = 8;
+constexpr size_t HEADER_WIDTH = 12;
+constexpr size_t HEADER_HEIGHT = 16;
+constexpr size_t HEADER_DEPTH = 20;
+constexpr size_t HEADER_SEED = 24;
+constexpr size_t HEADER_FLAGS = 32;
+constexpr size_t HEADER_GENERATOR = 36;
+constexpr size_t HEADER_CHUNK_COUNT = 40;
+constexpr size_t HEADER_DIRECTORY = 48;
+constexpr size_t HEADER_RULES_SIZE = 56;
+constexpr size_t HEADER_CHECKSUM = 60;
+
+// Directory entry fields by offset
+constexpr size_t ENTRY_X = 0;
+constexpr size_t ENTRY_Y = 4;
+constexpr size_t ENTRY_Z = 8;
+constexpr size_t ENTRY_FLAGS = 12;
+constexpr size_t ENTRY_OFFSET = 16;
+constexpr size_t ENTRY_SIZE_FIELD = 24;
+constexpr size_t ENTRY_CHECKSUM = 28;
+
+// Payload encodings
+enum Encoding : uint8_t {
+    ENCODING_UNIFORM = 0,
+    ENCODING_PACKED = 1,
+    ENCODING_RUNS = 2,
+    ENCODING_DELTA = 3
+};
+
+// Run ends and change slots are voxel slots in [0, CHUNK_VOLUME]
+constexpr size_t RUN_END_BYTES = CHUNK_VOLUME < 65536 ? 2 : 4;
+
+void Put8(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void Put16(std::vector<uint8_t>& out, uint32_t value) {
+    Put8(out, value);
+    Put8(out, value >> 8);
+}
+
+void Put32(std::vector<uint8_t>& out, uint32_t value) {
+    Put16(out, value);
+    Put16(out, value >> 16);
+}
+
+void Put64(std::vector<uint8_t>& out, uint64_t value) {
+    Put32(out, static_cast<uint32_t>(value));
+    Put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void PutFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Put32(out, bits);
+}
+
+uint32_t Get16(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8;
+}
+
+uint32_t Get32(const uint8_t* p) {
+    return Get16(p) | Get16(p + 2) << 16;
+}
+
+uint64_t Get64(const uint8_t* p) {
+    return static_cast<uint64_t>(Get32(p)) | static_cast<uint64_t>(Get32(p + 4)) << 32;
+}
+
+int32_t GetInt(const uint8_t* p) {
+    return static_cast<int32_t>(Get32(p));
+}
+
+float GetFloat(const uint8_t* p) {
+    uint32_t bits = Get32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void PutRunEnd(std::vector<uint8_t>& out, uint32_t end) {
+    if (RUN_END_BYTES == 2) Put16(out, end); else Put32(out, end);
+}
+
+uint32_t GetRunEnd(const uint8_t* ends, size_t run) {
+    return RUN_END_BYTES == 2 ? Get16(ends + run * 2) : Get32(ends + run * 4);
+}
+
+// FNV-1a; chained by passing the previous result as hash
+uint32_t Checksum(const uint8_t* bytes, size_t n, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < n; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Slot of a local position in the file's voxel order (YZX: x fastest)
+constexpr size_t FileSlot(int lx, int ly, int lz) {
+    return (static_cast<size_t>(ly) * CHUNK_SIZE + lz) * CHUNK_SIZE + lx;
+}
+
+// LocalIndex of a slot in the file's voxel order
+constexpr size_t LocalIndexOfSlot(size_t slot) {
+    return LocalIndex(static_cast<int>(slot & CHUNK_MASK), static_cast<int>(slot >> (2 * CHUNK_SHIFT)),
+                      static_cast<int>((slot >> CHUNK_SHIFT) & CHUNK_MASK));
+}
+
+void PutRules(std::vector<uint8_t>& out, const TerrainRules& rules) {
+    PutFloat(out, rules.baseHeight);
+    PutFloat(out, rules.hillHeight);
+    PutFloat(out, rules.hillScale);
+    Put32(out, static_cast<uint32_t>(rules.hillOctaves));
+    Put32(out, static_cast<uint32_t>(rules.soilDepth));
+    PutFloat(out, rules.caveScale);
+    PutFloat(out, rules.caveThreshold);
+    Put32(out, static_cast<uint32_t>(rules.caveRoof));
+    Put32(out, static_cast<uint32_t>(rules.ores.size()));
+    for (const OreRule& ore : rules.ores) {
+        Put32(out, static_cast<uint32_t>(ore.type));
+        Put32(out, static_cast<uint32_t>(ore.minDepth));
+        PutFloat(out, ore.scale);
+        PutFloat(out, ore.threshold);
+    }
+}
+
+bool GetRules(const uint8_t* p, size_t size, TerrainRules& rules) {
+    if (size < RULES_BASE_SIZE) return false;
+    rules.baseHeight = GetFloat(p);
+    rules.hillHeight = GetFloat(p + 4);
+    rules.hillScale = GetFloat(p + 8);
+    rules.hillOctaves = GetInt(p + 12);
+    rules.soilDepth = GetInt(p + 16);
+    rules.caveScale = GetFloat(p + 20);
+    rules.caveThreshold = GetFloat(p + 24);
+    rules.caveRoof = GetInt(p + 28);
+    uint32_t ores = Get32(p + 32);
+    if (size != RULES_BASE_SIZE + static_cast<uint64_t>(ores) * ORE_RULE_SIZE) return false;
+    rules.ores.clear();
+    for (uint32_t i = 0; i < ores; ++i) {
+        const uint8_t* ore = p + RULES_BASE_SIZE + i * ORE_RULE_SIZE;
+        if (Get32(ore) >= static_cast<uint32_t>(BLOCK_TYPE_COUNT)) return false;
+        rules.ores.push_back({ static_cast<BlockType>(Get32(ore)), GetInt(ore + 4), GetFloat(ore + 8), GetFloat(ore + 12) });
+    }
+    return true;
+}
+
+// Encode CHUNK_VOLUME types in file order as a payload
+void EncodePayload(const BlockType* types, std::vector<uint8_t>& out) {
+    int paletteSlot[BLOCK_TYPE_COUNT];
+    std::fill(paletteSlot, paletteSlot + BLOCK_TYPE_COUNT, -1);
+    std::vector<uint8_t> palette;
+    size_t runs = 1;
+    for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+        int type = static_cast<int>(types[i]);
+        if (paletteSlot[type] < 0) {
+            paletteSlot[type] = static_cast<int>(palette.size());
+            palette.push_back(static_cast<uint8_t>(type));
+        }
+        if (i > 0 && types[i] != types[i - 1]) ++runs;
+    }
+
+    out.clear();
+    int bits = BitsForPaletteSize(palette.size());
+    size_t packedBytes = 1 + static_cast<size_t>(CHUNK_VOLUME) * bits / 8;
+    size_t runBytes = 4 + runs * (RUN_END_BYTES + 1);
+    Encoding encoding = bits == 0 ? ENCODING_UNIFORM : packedBytes <= runBytes ? ENCODING_PACKED : ENCODING_RUNS;
+    Put8(out, encoding);
+    Put8(out, static_cast<uint32_t>(palette.size()));
+    out.insert(out.end(), palette.begin(), palette.end());
+
+    if (encoding == ENCODING_PACKED) {
+        Put8(out, static_cast<uint32_t>(bits));
+        size_t start = out.size();
+        out.resize(start + packedBytes - 1, 0);
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+            size_t bit = i * bits;
+            out[start + (bit >> 3)] |= static_cast<uint8_t>(paletteSlot[static_cast<int>(types[i])] << (bit & 7));
+        }
+    } else if (encoding == ENCODING_RUNS) {
+        Put32(out, static_cast<uint32_t>(runs));
+        for (size_t i = 1; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+            if (types[i] != types[i - 1]) PutRunEnd(out, static_cast<uint32_t>(i));
+        }
+        PutRunEnd(out, CHUNK_VOLUME);
+        Put8(out, static_cast<uint32_t>(paletteSlot[static_cast<int>(types[0])]));
+        for (size_t i = 1; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+            if (types[i] != types[i - 1]) Put8(out, static_cast<uint32_t>(paletteSlot[static_cast<int>(types[i])]));
+        }
+    }
+}
+
+// Changes from generated to types (LocalIndex order) as a Delta payload
+void EncodeDelta(const BlockType* types, const BlockType* generated, std::vector<uint8_t>& out) {
+    std::vector<uint32_t> slots;
+    for (size_t slot = 0; slot < static_cast<size_t>(CHUNK_VOLUME); ++slot) {
+        size_t index = LocalIndexOfSlot(slot);
+        if (types[index] != generated[index]) slots.push_back(static_cast<uint32_t>(slot));
+    }
+    out.clear();
+    Put8(out, ENCODING_DELTA);
+    Put32(out, static_cast<uint32_t>(slots.size()));
+    for (uint32_t slot : slots) PutRunEnd(out, slot);
+    for (uint32_t slot : slots) Put8(out, static_cast<uint32_t>(types[LocalIndexOfSlot(slot)]));
+}
+
+// True if a Delta payload is well formed: slots increasing and in range
+bool CheckDelta(const uint8_t* p, size_t size) {
+    if (size < 5) return false;
+    uint32_t count = Get32(p + 1);
+    if (count > static_cast<uint32_t>(CHUNK_VOLUME) || size != 5 + count * (RUN_END_BYTES + 1)) return false;
+    const uint8_t* slots = p + 5;
+    const uint8_t* types = slots + count * RUN_END_BYTES;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t slot = GetRunEnd(slots, i);
+        if (slot >= static_cast<uint32_t>(CHUNK_VOLUME) || (i > 0 && slot <= GetRunEnd(slots, i - 1)) ||
+            types[i] >= BLOCK_TYPE_COUNT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// True if a payload is well formed: every index and run in range. Delta
+// payloads only make sense where missing chunks are generated.
+bool CheckPayload(const uint8_t* p, size_t size, bool allowDelta) {
+    if (size >= 1 && p[0] == ENCODING_DELTA) return allowDelta && CheckDelta(p, size);
+    if (size < 3) return false;
+    size_t paletteSize = p[1];
+    if (paletteSize < 1 || paletteSize > static_cast<size_t>(BLOCK_TYPE_COUNT) || size < 2 + paletteSize) {
+        return false;
+    }
+    for (size_t i = 0; i < paletteSize; ++i) {
+        if (p[2 + i] >= BLOCK_TYPE_COUNT) return false;
+    }
+    const uint8_t* body = p + 2 + paletteSize;
+    size_t rest = size - 2 - paletteSize;
+
+    switch (p[0]) {
+        case ENCODING_UNIFORM:
+            return paletteSize == 1 && rest == 0;
+        case ENCODING_PACKED: {
+            if (rest < 1) return false;
+            int bits = body[0];
+            if ((bits != 1 && bits != 2 && bits != 4 && bits != 8) || rest != 1 + static_cast<size_t>(CHUNK_VOLUME) * bits / 8) {
+                return false;
+            }
+            for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+                size_t bit = i * bits;
+                if (((body[1 + (bit >> 3)] >> (bit & 7)) & ((1u << bits) - 1)) >= paletteSize) return false;
+            }
+            return true;
+        }
+        case ENCODING_RUNS: {
+            if (rest < 4) return false;
+            uint32_t runs = Get32(body);
+            if (runs < 1 || runs > static_cast<uint32_t>(CHUNK_VOLUME) || rest != 4 + runs * (RUN_END_BYTES + 1)) {
+                return false;
+            }
+            const uint8_t* ends = body + 4;
+            const uint8_t* values = ends + runs * RUN_END_BYTES;
+            uint32_t previous = 0;
+            for (uint32_t r = 0; r < runs; ++r) {
+                uint32_t end = GetRunEnd(ends, r);
+                if (end <= previous || values[r] >= paletteSize) return false;
+                previous = end;
+            }
+            return previous == static_cast<uint32_t>(CHUNK_VOLUME);
+        }
+        default:
+            return false;
+    }
+}
+
+// Apply a checked Delta payload over a chunk in LocalIndex order
+void ApplyDelta(const uint8_t* p, BlockType* out) {
+    uint32_t count = Get32(p + 1);
+    const uint8_t* slots = p + 5;
+    const uint8_t* types = slots + count * RUN_END_BYTES;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[LocalIndexOfSlot(GetRunEnd(slots, i))] = static_cast<BlockType>(types[i]);
+    }
+}
+
+// Expand a checked (non-Delta) payload to CHUNK_VOLUME types in file order
+void DecodePayload(const uint8_t* p, BlockType* out) {
+    size_t paletteSize = p[1];
+    const BlockType* palette = reinterpret_cast<const BlockType*>(p + 2);
+    const uint8_t* body = p + 2 + paletteSize;
+    switch (p[0]) {
+        case ENCODING_UNIFORM:
+            std::fill(out, out + CHUNK_VOLUME, palette[0]);
+            return;
+        case ENCODING_PACKED: {
+            int bits = body[0];
+            uint32_t mask = (1u << bits) - 1;
+            for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+                size_t bit = i * bits;
+                out[i] = palette[(body[1 + (bit >> 3)] >> (bit & 7)) & mask];
+            }
+            return;
+        }
+        default: {
+            uint32_t runs = Get32(body);
+            const uint8_t* ends = body + 4;
+            const uint8_t* values = ends + runs * RUN_END_BYTES;
+            uint32_t begin = 0;
+            for (uint32_t r = 0; r < runs; ++r) {
+                uint32_t end = GetRunEnd(ends, r);
+                std::fill(out + begin, out + end, palette[values[r]]);
+                begin = end;
+            }
+            return;
+        }
+    }
+}
+
+// One voxel of a checked payload; base where a Delta has no change
+BlockType DecodeVoxel(const uint8_t* p, size_t slot, BlockType base) {
+    if (p[0] == ENCODING_DELTA) {
+        uint32_t count = Get32(p + 1);
+        const uint8_t* slots = p + 5;
+        uint32_t low = 0, high = count;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (GetRunEnd(slots, mid) < slot) low = mid + 1; else high = mid;
+        }
+        if (low < count && GetRunEnd(slots, low) == slot) {
+            return static_cast<BlockType>(slots[count * RUN_END_BYTES + low]);
+        }
+        return base;
+    }
+    size_t paletteSize = p[1];
+    const uint8_t* palette = p + 2;
+    const uint8_t* body = p + 2 + paletteSize;
+    switch (p[0]) {
+        case ENCODING_UNIFORM:
+            return static_cast<BlockType>(palette[0]);
+        case ENCODING_PACKED: {
+            int bits = body[0];
+            size_t bit = slot * bits;
+            return static_cast<BlockType>(palette[(body[1 + (bit >> 3)] >> (bit & 7)) & ((1u << bits) - 1)]);
+        }
+        default: {
+            // First run ending past the slot
+            uint32_t runs = Get32(body);
+            const uint8_t* ends = body + 4;
+            uint32_t low = 0, high = runs - 1;
+            while (low < high) {
+                uint32_t mid = (low + high) / 2;
+                if (GetRunEnd(ends, mid) <= slot) low = mid + 1; else high = mid;
+            }
+            return static_cast<BlockType>(palette[ends[runs * RUN_END_BYTES + low]]);
+        }
+    }
+}
+
+} // namespace
+
+const char* GetFileStatusName(FileStatus status) {
+    switch (status) {
+        case FileStatus::Ok:                 return "ok";
+        case FileStatus::OpenFailed:         return "cannot open file";
+        case FileStatus::WriteFailed:        return "cannot write file";
+        case FileStatus::NotAWorldFile:      return "not a world file";
+        case FileStatus::UnsupportedVersion: return "unsupported version";
+        case FileStatus::Incompatible:       return "different chunk size";
+        default:                             return "corrupt file";
+    }
+}
+
+WorldFile::~WorldFile() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
+
+std::shared_ptr<const WorldFile> WorldFile::Open(const std::string& path, FileStatus& status) {
+    std::shared_ptr<WorldFile> file(new WorldFile());
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        status = FileStatus::OpenFailed;
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        status = FileStatus::OpenFailed;
+        return nullptr;
+    }
+    file->size = static_cast<size_t>(st.st_size);
+    if (file->size >= HEADER_SIZE) {
+        void* view = mmap(nullptr, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            file->data = static_cast<const uint8_t*>(view);
+            file->mapped = true;
+        }
+    }
+    close(fd);
+#endif
+    if (!file->mapped) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            status = FileStatus::OpenFailed;
+            return nullptr;
+        }
+        file->buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        file->data = file->buffer.data();
+        file->size = file->buffer.size();
+    }
+
+    status = file->Parse();
+    if (status != FileStatus::Ok) {
+        return nullptr;
+    }
+    return file;
+}
+
+FileStatus WorldFile::Parse() {
+    if (size < HEADER_SIZE) {
+        return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0
+            ? FileStatus::Corrupt : FileStatus::NotAWorldFile;
+    }
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) return FileStatus::NotAWorldFile;
+    uint32_t version = Get32(data + HEADER_VERSION);
+    if (version < 1 || version > VERSION) return FileStatus::UnsupportedVersion;
+    if (Get32(data + HEADER_CHUNK_SIZE) != static_cast<uint32_t>(CHUNK_SIZE)) return FileStatus::Incompatible;
+
+    // Header, rules and directory must fit the file exactly and match
+    // their checksum
+    uint64_t count = Get64(data + HEADER_CHUNK_COUNT);
+    uint64_t directoryOffset = Get64(data + HEADER_DIRECTORY);
+    uint64_t rulesSize = Get32(data + HEADER_RULES_SIZE);
+    uint64_t payloadStart = HEADER_SIZE + rulesSize;
+    if (payloadStart > directoryOffset || directoryOffset > size ||
+        count > (size - directoryOffset) / ENTRY_SIZE || directoryOffset + count * ENTRY_SIZE != size) {
+        return FileStatus::Corrupt;
+    }
+    uint32_t checksum = Checksum(data, HEADER_CHECKSUM);
+    checksum = Checksum(data + HEADER_SIZE, rulesSize, checksum);
+    checksum = Checksum(data + directoryOffset, count * ENTRY_SIZE, checksum);
+    if (checksum != Get32(data + HEADER_CHECKSUM)) return FileStatus::Corrupt;
+
+    info.width = GetInt(data + HEADER_WIDTH);
+    info.height = GetInt(data + HEADER_HEIGHT);
+    info.depth = GetInt(data + HEADER_DEPTH);
+    info.seed = Get64(data + HEADER_SEED);
+    uint32_t flags = Get32(data + HEADER_FLAGS);
+    uint32_t generator = Get32(data + HEADER_GENERATOR);
+    info.lazy = (flags & FLAG_LAZY) != 0;
+    info.generatorMode = static_cast<GeneratorMode>(generator);
+    if (info.width <= 0 || info.height <= 0 || info.depth <= 0 || (flags & ~FLAG_LAZY) != 0 ||
+        generator > static_cast<uint32_t>(GeneratorMode::Terrain) ||
+        !GetRules(data + HEADER_SIZE, rulesSize, info.terrainRules)) {
+        return FileStatus::Corrupt;
+    }
+
+    // Directory: chunks inside the world in strictly increasing index
+    // order, payloads between the rules and the directory
+    chunkCount = static_cast<size_t>(count);
+    directory = data + directoryOffset;
+    chunksX = (info.width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    chunksZ = (info.depth + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    int chunksY = (info.height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    uint64_t previousKey = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const uint8_t* entry = directory + i * ENTRY_SIZE;
+        ChunkCoord coord = GetChunkCoord(i);
+        uint64_t offset = Get64(entry + ENTRY_OFFSET);
+        uint64_t bytes = Get32(entry + ENTRY_SIZE_FIELD);
+        if (coord.x < 0 || coord.x >= chunksX || coord.y < 0 || coord.y >= chunksY ||
+            coord.z < 0 || coord.z >= chunksZ || (i > 0 && ChunkKey(coord) <= previousKey) ||
+            (Get32(entry + ENTRY_FLAGS) & ~FLAG_MODIFIED) != 0 ||
+            offset < payloadStart || offset > directoryOffset || bytes > directoryOffset - offset) {
+            return FileStatus::Corrupt;
+        }
+        previousKey = ChunkKey(coord);
+    }
+    verdicts.reset(new std::atomic<uint8_t>[chunkCount]());
+    return FileStatus::Ok;
+}
+
+uint64_t WorldFile::ChunkKey(const ChunkCoord& coord) const {
+    return (static_cast<uint64_t>(coord.y) * chunksZ + coord.z) * chunksX + coord.x;
+}
+
+ChunkCoord WorldFile::GetChunkCoord(size_t index) const {
+    const uint8_t* entry = directory + index * ENTRY_SIZE;
+    return { GetInt(entry + ENTRY_X), GetInt(entry + ENTRY_Y), GetInt(entry + ENTRY_Z) };
+}
+
+bool WorldFile::IsChunkModified(size_t index) const {
+    return (Get32(directory + index * ENTRY_SIZE + ENTRY_FLAGS) & FLAG_MODIFIED) != 0;
+}
+
+size_t WorldFile::Find(const ChunkCoord& coord) const {
+    uint64_t key = ChunkKey(coord);
+    size_t low = 0, high = chunkCount;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (ChunkKey(GetChunkCoord(mid)) < key) low = mid + 1; else high = mid;
+    }
+    return low < chunkCount && GetChunkCoord(low) == coord ? low : NOT_FOUND;
+}
+
+const uint8_t* WorldFile::Payload(size_t index) const {
+    return data + Get64(directory + index * ENTRY_SIZE + ENTRY_OFFSET);
+}
+
+bool WorldFile::VerifyPayload(size_t index) const {
+    const uint8_t* entry = directory + index * ENTRY_SIZE;
+    size_t bytes = Get32(entry + ENTRY_SIZE_FIELD);
+    return Checksum(Payload(index), bytes) == Get32(entry + ENTRY_CHECKSUM) &&
+           CheckPayload(Payload(index), bytes, info.lazy);
+}
+
+bool WorldFile::IsChunkIntact(size_t index) const {
+    uint8_t verdict = verdicts[index].load(std::memory_order_relaxed);
+    if (verdict == 0) {
+        verdict = VerifyPayload(index) ? 1 : 2;
+        verdicts[index].store(verdict, std::memory_order_relaxed);
+    }
+    return verdict == 1;
+}
+
+size_t WorldFile::CountCorruptChunks() const {
+    size_t corrupt = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        corrupt += IsChunkIntact(i) ? 0 : 1;
+    }
+    return corrupt;
+}
+
+bool WorldFile::IsChunkDelta(size_t index) const {
+    return IsChunkIntact(index) && Payload(index)[0] == ENCODING_DELTA;
+}
+
+BlockType WorldFile::ReadBlock(size_t index, int lx, int ly, int lz, BlockType base) const {
+    if (!IsChunkIntact(index)) {
+        return BlockType::Air;
+    }
+    return DecodeVoxel(Payload(index), FileSlot(lx, ly, lz), base);
+}
+
+void WorldFile::ReadChunk(size_t index, BlockType* out) const {
+    if (!IsChunkIntact(index)) {
+        std::fill(out, out + CHUNK_VOLUME, BlockType::Air);
+        return;
+    }
+    if (Payload(index)[0] == ENCODING_DELTA) {
+        ApplyDelta(Payload(index), out);
+    } else if constexpr (GRID_LAYOUT == VoxelLayout::YZX) {
+        DecodePayload(Payload(index), out);
+    } else {
+        std::vector<BlockType> ordered(CHUNK_VOLUME);
+        DecodePayload(Payload(index), ordered.data());
+        for (int ly = 0; ly < CHUNK_SIZE; ++ly)
+            for (int lz = 0; lz < CHUNK_SIZE; ++lz)
+                for (int lx = 0; lx < CHUNK_SIZE; ++lx)
+                    out[LocalIndex(lx, ly, lz)] = ordered[FileSlot(lx, ly, lz)];
+    }
+}
+
+WorldFileWriter::WorldFileWriter(const std::string& path, const WorldFileInfo& info)
+    : path(path), temporaryPath(path + ".tmp"), info(info) {
+    PutRules(rules, info.terrainRules);
+    out.open(temporaryPath, std::ios::binary | std::ios::trunc);
+    std::vector<uint8_t> header(HEADER_SIZE, 0);  // written for real by Finish
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.write(reinterpret_cast<const char*>(rules.data()), rules.size());
+    payloadStart = offset = HEADER_SIZE + rules.size();
+}
+
+WorldFileWriter::~WorldFileWriter() {
+    if (!finished) {
+        out.close();
+        std::remove(temporaryPath.c_str());
+    }
+}
+
+void WorldFileWriter::AddChunk(const ChunkCoord& coord, const Chunk& chunk, bool modified) {
+    decoded.resize(CHUNK_VOLUME);
+    chunk.Decode(decoded.data());
+    AddChunk(coord, decoded.data(), modified);
+}
+
+void WorldFileWriter::AddChunk(const ChunkCoord& coord, const BlockType* types, bool modified) {
+    if constexpr (GRID_LAYOUT == VoxelLayout::YZX) {
+        EncodePayload(types, scratch);
+    } else {
+        std::vector<BlockType> ordered(CHUNK_VOLUME);
+        for (int ly = 0; ly < CHUNK_SIZE; ++ly)
+            for (int lz = 0; lz < CHUNK_SIZE; ++lz)
+                for (int lx = 0; lx < CHUNK_SIZE; ++lx)
+                    ordered[FileSlot(lx, ly, lz)] = types[LocalIndex(lx, ly, lz)];
+        EncodePayload(ordered.data(), scratch);
+    }
+    AddPayload(coord, modified ? FLAG_MODIFIED : 0, scratch.data(), scratch.size());
+}
+
+bool WorldFileWriter::AddChunkChanges(const ChunkCoord& coord, const BlockType* types, const BlockType* generated) {
+    if (std::equal(types, types + CHUNK_VOLUME, generated)) {
+        return false;
+    }
+    EncodeDelta(types, generated, changes);
+    if constexpr (GRID_LAYOUT == VoxelLayout::YZX) {
+        EncodePayload(types, scratch);
+    } else {
+        std::vector<BlockType> ordered(CHUNK_VOLUME);
+        for (size_t slot = 0; slot < static_cast<size_t>(CHUNK_VOLUME); ++slot) {
+            ordered[slot] = types[LocalIndexOfSlot(slot)];
+        }
+        EncodePayload(ordered.data(), scratch);
+    }
+    const std::vector<uint8_t>& payload = changes.size() < scratch.size() ? changes : scratch;
+    AddPayload(coord, FLAG_MODIFIED, payload.data(), payload.size());
+    return true;
+}
+
+void WorldFileWriter::CopyChunk(const WorldFile& file, size_t index) {
+    ChunkCoord coord = file.GetChunkCoord(index);
+    bool modified = file.IsChunkModified(index);
+    if (!file.IsChunkIntact(index)) {
+        // Keep it reading as it did (Air) rather than giving the damaged
+        // bytes a valid checksum
+        std::vector<BlockType> air(CHUNK_VOLUME, BlockType::Air);
+        AddChunk(coord, air.data(), modified);
+        return;
+    }
+    const uint8_t* entry = file.directory + index * ENTRY_SIZE;
+    AddPayload(coord, modified ? FLAG_MODIFIED : 0, file.Payload(index), Get32(entry + ENTRY_SIZE_FIELD));
+}
+
+void WorldFileWriter::AddPayload(const ChunkCoord& coord, uint32_t flags, const uint8_t* payload, size_t bytes) {
+    uint64_t chunksX = (info.width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    uint64_t chunksZ = (info.depth + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    uint64_t key = (static_cast<uint64_t>(coord.y) * chunksZ + coord.z) * chunksX + coord.x;
+    entries.push_back({ key, coord, flags, offset, static_cast<uint32_t>(bytes), Checksum(payload, bytes) });
+    out.write(reinterpret_cast<const char*>(payload), bytes);
+    offset += bytes;
+}
+
+FileStatus WorldFileWriter::Finish() {
+    // Directory in chunk index order; a chunk added twice keeps its last payload
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+    std::vector<uint8_t> directory;
+    directory.reserve(entries.size() * ENTRY_SIZE);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i + 1 < entries.size() && entries[i + 1].key == entries[i].key) continue;
+        const Entry& entry = entries[i];
+        Put32(directory, static_cast<uint32_t>(entry.coord.x));
+        Put32(directory, static_cast<uint32_t>(entry.coord.y));
+        Put32(directory, static_cast<uint32_t>(entry.coord.z));
+        Put32(directory, entry.flags);
+        Put64(directory, entry.offset);
+        Put32(directory, entry.size);
+        Put32(directory, entry.checksum);
+    }
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    Put32(header, WorldFile::VERSION);
+    Put32(header, CHUNK_SIZE);
+    Put32(header, static_cast<uint32_t>(info.width));
+    Put32(header, static_cast<uint32_t>(info.height));
+    Put32(header, static_cast<uint32_t>(info.depth));
+    Put64(header, info.seed);
+    Put32(header, info.lazy ? FLAG_LAZY : 0);
+    Put32(header, static_cast<uint32_t>(info.generatorMode));
+    Put64(header, directory.size() / ENTRY_SIZE);
+    Put64(header, offset);
+    Put32(header, static_cast<uint32_t>(rules.size()));
+    uint32_t checksum = Checksum(header.data(), header.size());
+    checksum = Checksum(rules.data(), rules.size(), checksum);
+    checksum = Checksum(directory.data(), directory.size(), checksum);
+    Put32(header, checksum);
+
+    out.write(reinterpret_cast<const char*>(directory.data()), directory.size());
+    fileSize = offset + directory.size();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.close();
+    finished = true;
+    if (!out) {
+        std::remove(temporaryPath.c_str());
+        return FileStatus::WriteFailed;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());  // rename does not replace files there
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return FileStatus::WriteFailed;
+    }
+    return FileStatus::Ok;
+}
+
+} // namespace World
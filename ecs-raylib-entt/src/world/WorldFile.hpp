@@ -0,0 +1,204 @@
+#ifndef WORLD_FILE_H
+#define WORLD_FILE_H
+
+#include "Block.hpp"
+#include "Chunk.hpp"
+#include "Terrain.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace World {
+
+// Outcome of saving or loading a world file
+enum class FileStatus {
+    Ok,
+    OpenFailed,          // missing or unreadable file
+    WriteFailed,         // could not write or replace the file
+    NotAWorldFile,       // wrong magic
+    UnsupportedVersion,  // written by a newer (or unknown) format version
+    Incompatible,        // built for another WORLD_CHUNK_SIZE
+    Corrupt              // truncated, bad checksum or inconsistent contents
+};
+
+const char* GetFileStatusName(FileStatus status);
+
+// Everything a world file records besides its chunks
+struct WorldFileInfo {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    uint64_t seed = 0;
+    GeneratorMode generatorMode = GeneratorMode::SolidCube;
+    TerrainRules terrainRules;
+    bool lazy = false;  // chunks not in the file are generated from the seed (else air)
+};
+
+// How World::Save writes chunks
+enum class SaveMode {
+    Delta,    // the seed plus the voxels SetBlock changed, per modified chunk
+    Snapshot  // every resident chunk in full
+};
+
+// A world file (World::Save/Load), opened read-only and memory-mapped.
+// Opening checks the header and the chunk directory only, so it takes the
+// same time for any amount of voxel data; chunk payloads are decoded when
+// a chunk is first read. A payload's checksum is verified the first time
+// the chunk is read, and a chunk that fails it reads as Air. Reads are
+// const and safe from any thread.
+//
+// Layout (little-endian; v2, which added Delta payloads, reads v1 too):
+//   header     64 bytes: magic "VXWF", version, chunk size, bounds, seed,
+//              flags, generator, chunk count, rules size, directory offset,
+//              checksum of header + rules + directory
+//   rules      terrain rules for the generator
+//   payloads   one per stored chunk, see below
+//   directory  one 32-byte entry per chunk (coord, flags, payload offset,
+//              size and checksum), sorted by chunk index for binary search
+//
+// A payload is its encoding byte and palette (types in first-seen order),
+// then the palette indices of the voxels in YZX order (x fastest, whatever
+// GRID_LAYOUT the build uses):
+//   Uniform  nothing more (one palette entry)
+//   Packed   index width (1, 2, 4 or 8 bits) and the bit-packed indices
+//   Runs     run count, each run's end slot, each run's index
+// The writer picks whichever of Packed and Runs is smaller, and both can be
+// read at a single voxel without decoding the rest. A Delta payload (lazy
+// files only) has no palette: it lists the voxels that differ from the
+// generated chunk, as a change count, each change's slot and its type.
+class WorldFile {
+public:
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    ~WorldFile();
+
+    WorldFile(const WorldFile&) = delete;
+    WorldFile& operator=(const WorldFile&) = delete;
+
+    // Map and check a file; nullptr (and why in status) if it cannot be used
+    static std::shared_ptr<const WorldFile> Open(const std::string& path, FileStatus& status);
+
+    const WorldFileInfo& GetInfo() const { return info; }
+    size_t GetSize() const { return size; }
+
+    // Stored chunks, by directory index (sorted by chunk index)
+    size_t GetChunkCount() const { return chunkCount; }
+    ChunkCoord GetChunkCoord(size_t index) const;
+    bool IsChunkModified(size_t index) const;
+
+    // Directory index of a chunk, or NOT_FOUND. O(log chunks).
+    size_t Find(const ChunkCoord& coord) const;
+
+    // True if the chunk is stored as its changes over the generated chunk
+    bool IsChunkDelta(size_t index) const;
+
+    // One voxel of a stored chunk (local coordinates), without decoding
+    // the rest: O(1) for Packed, O(log runs) for Runs, O(log changes) for
+    // Delta, where voxels without a change give base (the generated block)
+    BlockType ReadBlock(size_t index, int lx, int ly, int lz, BlockType base = BlockType::Air) const;
+
+    // A whole stored chunk, CHUNK_VOLUME types in LocalIndex order. A Delta
+    // chunk applies its changes over out, which must hold the generated chunk.
+    void ReadChunk(size_t index, BlockType* out) const;
+
+    // Verify a chunk's payload now (once per chunk; later calls are free)
+    bool IsChunkIntact(size_t index) const;
+
+    // Verify every payload; returns how many fail
+    size_t CountCorruptChunks() const;
+
+private:
+    friend class WorldFileWriter;  // copies payloads as they are
+
+    WorldFile() = default;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> buffer;  // file contents where mapping is unavailable
+
+    WorldFileInfo info;
+    size_t chunkCount = 0;
+    const uint8_t* directory = nullptr;
+    int chunksX = 0, chunksZ = 0;
+
+    // Per chunk: 0 not verified yet, 1 intact, 2 corrupt
+    std::unique_ptr<std::atomic<uint8_t>[]> verdicts;
+
+    FileStatus Parse();
+    const uint8_t* Payload(size_t index) const;
+    bool VerifyPayload(size_t index) const;
+    uint64_t ChunkKey(const ChunkCoord& coord) const;
+};
+
+// Writes a world file. Chunks can be added in any order; the file goes to
+// a temporary next to path and replaces path only when Finish succeeds,
+// so an interrupted save never leaves a half-written world (and a world
+// mapped from path keeps reading the old contents).
+class WorldFileWriter {
+public:
+    WorldFileWriter(const std::string& path, const WorldFileInfo& info);
+    ~WorldFileWriter();
+
+    WorldFileWriter(const WorldFileWriter&) = delete;
+    WorldFileWriter& operator=(const WorldFileWriter&) = delete;
+
+    // Encode a chunk; modified marks chunks edited since generation
+    void AddChunk(const ChunkCoord& coord, const Chunk& chunk, bool modified);
+
+    // Same from CHUNK_VOLUME types in LocalIndex order
+    void AddChunk(const ChunkCoord& coord, const BlockType* types, bool modified);
+
+    // Store a modified chunk of a lazy file as its changes over generated
+    // (both in LocalIndex order), or in full once that is smaller (heavily
+    // edited chunks are compacted into snapshots). Nothing is stored, and
+    // false returned, when the two are the same.
+    bool AddChunkChanges(const ChunkCoord& coord, const BlockType* types, const BlockType* generated);
+
+    // Copy a chunk's payload from another file as is
+    void CopyChunk(const WorldFile& file, size_t index);
+
+    // Write the directory and header and move the file into place
+    FileStatus Finish();
+
+    // Payload bytes written so far
+    uint64_t GetPayloadBytes() const { return offset - payloadStart; }
+
+    // Size of the whole file once Finish has written it
+    uint64_t GetFileSize() const { return fileSize; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        ChunkCoord coord;
+        uint32_t flags;
+        uint64_t offset;
+        uint32_t size;
+        uint32_t checksum;
+    };
+
+    std::string path;
+    std::string temporaryPath;
+    WorldFileInfo info;
+    std::ofstream out;
+    std::vector<uint8_t> rules;
+    std::vector<Entry> entries;
+    std::vector<uint8_t> scratch;
+    std::vector<uint8_t> changes;
+    std::vector<BlockType> decoded;
+    uint64_t payloadStart = 0;
+    uint64_t offset = 0;
+    uint64_t fileSize = 0;
+    bool finished = false;
+
+    void AddPayload(const ChunkCoord& coord, uint32_t flags, const uint8_t* payload, size_t bytes);
+};
+
+} // namespace World
+
+#endif // WORLD_FILE_H
@@ -0,0 +1,237 @@
+#include "../src/world/World.hpp"
+#include "../src/world/Frustum.hpp"
+#include "../src/world/ChunkBVH.hpp"
+#include <raymath.h>
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Camera at (0, 0, 10) looking down -Z with a 90 degree field of view
+Camera3D MakeTestCamera() {
+    Camera3D camera = {};
+    camera.position = Vector3{ 0.0f, 0.0f, 10.0f };
+    camera.target = Vector3{ 0.0f, 0.0f, 0.0f };
+    camera.up = Vector3{ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 90.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return camera;
+}
+
+bool Near(float a, float b, float tolerance = 1e-4f) {
+    return std::fabs(a - b) < tolerance;
+}
+
+// Test plane extraction on a camera whose frustum is known
+void TestPlaneExtraction() {
+    std::cout << "Testing Plane Extraction..." << std::endl;
+
+    World::Frustum frustum = World::ExtractFrustum(World::CameraViewProjection(MakeTestCamera(), 1.0f, 1.0f, 100.0f));
+
+    // All normals are unit length
+    for (const World::Plane& plane : frustum.planes) {
+        assert(Near(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c, 1.0f));
+    }
+
+    // Near plane one unit in front of the camera, facing -Z; far plane at 100
+    const World::Plane& nearPlane = frustum.planes[World::Frustum::Near];
+    assert(Near(nearPlane.c, -1.0f));
+    assert(Near(nearPlane.Distance({ 0.0f, 0.0f, 9.0f }), 0.0f));
+    // (the far plane comes out of a difference of large terms, so less precise)
+    assert(Near(frustum.planes[World::Frustum::Far].Distance({ 0.0f, 0.0f, -90.0f }), 0.0f, 1e-3f));
+
+    // 90 degrees: at depth 10 the view is 10 units to each side
+    assert(World::ContainsPoint(frustum, { 0.0f, 0.0f, 0.0f }));
+    assert(World::ContainsPoint(frustum, { 9.5f, 0.0f, 0.0f }));
+    assert(!World::ContainsPoint(frustum, { 10.5f, 0.0f, 0.0f }));
+    assert(!World::ContainsPoint(frustum, { 0.0f, -10.5f, 0.0f }));
+    assert(!World::ContainsPoint(frustum, { 0.0f, 0.0f, 9.5f }));    // before the near plane
+    assert(!World::ContainsPoint(frustum, { 0.0f, 0.0f, -95.0f }));  // past the far plane
+
+    std::cout << "✓ Planes match the camera's frustum" << std::endl;
+}
+
+// Test that the planes agree with clipping through the matrix itself
+void TestPlanesMatchClipSpace() {
+    std::cout << "Testing Planes Against Clip Space..." << std::endl;
+
+    Camera3D camera = {};
+    camera.position = Vector3{ 20.0f, 15.0f, -8.0f };
+    camera.target = Vector3{ 3.0f, 1.0f, 12.0f };
+    camera.up = Vector3{ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    Matrix m = World::CameraViewProjection(camera, 16.0f / 9.0f, 0.5f, 200.0f);
+    World::Frustum frustum = World::ExtractFrustum(m);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-60.0f, 60.0f);
+    int inside = 0;
+    for (int i = 0; i < 20000; ++i) {
+        Vector3 p = { dist(rng), dist(rng), dist(rng) };
+        float cx = m.m0 * p.x + m.m4 * p.y + m.m8 * p.z + m.m12;
+        float cy = m.m1 * p.x + m.m5 * p.y + m.m9 * p.z + m.m13;
+        float cz = m.m2 * p.x + m.m6 * p.y + m.m10 * p.z + m.m14;
+        float cw = m.m3 * p.x + m.m7 * p.y + m.m11 * p.z + m.m15;
+
+        // Skip points too close to a boundary for float comparison
+        float margin = std::min({ cw - std::fabs(cx), cw - std::fabs(cy), cw - std::fabs(cz) });
+        if (std::fabs(margin) < 1e-2f) continue;
+
+        bool clipped = margin < 0.0f;
+        assert(World::ContainsPoint(frustum, p) == !clipped);
+        inside += clipped ? 0 : 1;
+    }
+    assert(inside > 0);
+
+    std::cout << "✓ Plane tests agree with -w <= x, y, z <= w (" << inside << " points inside)" << std::endl;
+}
+
+// Test box classification
+void TestClassifyAABB() {
+    std::cout << "Testing AABB Classification..." << std::endl;
+
+    World::Frustum frustum = World::ExtractFrustum(World::CameraViewProjection(MakeTestCamera(), 1.0f, 1.0f, 100.0f));
+
+    BoundingBox inside = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+    BoundingBox behind = { { -1.0f, -1.0f, 12.0f }, { 1.0f, 1.0f, 14.0f } };
+    BoundingBox straddling = { { 8.0f, -1.0f, -1.0f }, { 12.0f, 1.0f, 1.0f } };
+    BoundingBox enclosing = { { -500.0f, -500.0f, -500.0f }, { 500.0f, 500.0f, 500.0f } };
+
+    assert(World::ClassifyAABB(frustum, inside) == World::Containment::Inside);
+    assert(World::ClassifyAABB(frustum, behind) == World::Containment::Outside);
+    assert(World::ClassifyAABB(frustum, straddling) == World::Containment::Intersecting);
+    assert(World::ClassifyAABB(frustum, enclosing) == World::Containment::Intersecting);
+    assert(!World::IntersectsAABB(frustum, behind));
+
+    // Orthographic cameras cut a box, not a pyramid
+    Camera3D ortho = MakeTestCamera();
+    ortho.projection = CAMERA_ORTHOGRAPHIC;
+    ortho.fovy = 10.0f;  // 10 units tall
+    World::Frustum box = World::ExtractFrustum(World::CameraViewProjection(ortho, 1.0f, 1.0f, 100.0f));
+    assert(World::ContainsPoint(box, { 4.5f, 4.5f, -50.0f }));
+    assert(!World::ContainsPoint(box, { 5.5f, 0.0f, -50.0f }));
+
+    std::cout << "✓ Boxes classify as inside, outside or intersecting" << std::endl;
+}
+
+// Sorted copy of chunk coordinates for comparisons
+std::vector<World::ChunkCoord> Sorted(std::vector<World::ChunkCoord> coords) {
+    std::sort(coords.begin(), coords.end(), [](const World::ChunkCoord& a, const World::ChunkCoord& b) {
+        return a.y != b.y ? a.y < b.y : a.z != b.z ? a.z < b.z : a.x < b.x;
+    });
+    return coords;
+}
+
+// Test that the BVH returns exactly what testing every chunk would
+void TestChunkBVH() {
+    std::cout << "Testing Chunk BVH..." << std::endl;
+
+    int cs = World::CHUNK_SIZE;
+    World::World world(8 * cs, 2 * cs, 8 * cs);
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx)
+                world.SetBlock(cx * cs, cy * cs, cz * cs, World::Block(World::BlockType::Stone));
+
+    World::ChunkBVH bvh;
+    bvh.Build(world);
+    assert(bvh.GetChunkCount() == 128);
+    assert(bvh.IsBuiltFor(world));
+
+    // Chunk boxes follow block centres and stop at the world bounds
+    BoundingBox first = World::ChunkBVH::ChunkBounds({ 0, 0, 0 }, 10, 10, 10);
+    assert(first.min.x == -0.5f && first.max.x == std::min(cs, 10) - 0.5f);
+
+    // Camera inside the world, looking along +X from one corner
+    Camera3D camera = {};
+    camera.position = Vector3{ 1.0f, (float)cs, 1.0f };
+    camera.target = Vector3{ 100.0f, (float)cs, 1.0f };
+    camera.up = Vector3{ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    World::Frustum frustum = World::ExtractFrustum(World::CameraViewProjection(camera, 16.0f / 9.0f));
+
+    std::vector<World::ChunkCoord> fromTree;
+    World::ChunkCullStats stats;
+    bvh.Query(frustum, fromTree, &stats);
+
+    std::vector<World::ChunkCoord> bruteForce;
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                BoundingBox box = World::ChunkBVH::ChunkBounds({ cx, cy, cz }, world.GetWidth(), world.GetHeight(), world.GetDepth());
+                if (World::IntersectsAABB(frustum, box)) bruteForce.push_back({ cx, cy, cz });
+            }
+
+    std::vector<World::ChunkCoord> a = Sorted(fromTree), b = Sorted(bruteForce);
+    assert(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); ++i) assert(a[i] == b[i]);
+    assert(stats.chunksSubmitted == (int)fromTree.size());
+    assert(stats.chunksTotal == 128);
+    assert(stats.chunksSubmitted > 0 && stats.chunksSubmitted < stats.chunksTotal);
+    std::cout << "  Corner view: " << stats.chunksSubmitted << " of " << stats.chunksTotal
+              << " chunks, " << stats.nodesVisited << " nodes visited" << std::endl;
+
+    // Looking away from the world: nothing survives
+    camera.position = Vector3{ -5.0f, 5.0f, -5.0f };
+    camera.target = Vector3{ -50.0f, 5.0f, -50.0f };
+    std::vector<World::ChunkCoord> none;
+    bvh.Query(World::ExtractFrustum(World::CameraViewProjection(camera, 1.0f)), none, &stats);
+    assert(none.empty());
+    assert(stats.nodesVisited == 1);
+
+    // Far away and looking at the centre: everything, accepted high in the tree
+    camera.position = Vector3{ 64.0f * cs, 40.0f * cs, 64.0f * cs };
+    camera.target = Vector3{ 4.0f * cs, (float)cs, 4.0f * cs };
+    std::vector<World::ChunkCoord> all;
+    bvh.Query(World::ExtractFrustum(World::CameraViewProjection(camera, 1.0f, 0.01f, 100000.0f)), all, &stats);
+    assert(all.size() == 128);
+    assert(stats.chunksTested == 0);
+
+    // Allocating a new chunk invalidates the tree; regenerating does not
+    World::World grown(4 * cs, cs, cs);
+    grown.SetBlock(0, 0, 0, World::Block(World::BlockType::Stone));
+    bvh.Build(grown);
+    grown.SetBlock(3 * cs, 0, 0, World::Block(World::BlockType::Stone));
+    assert(!bvh.IsBuiltFor(grown));
+    grown.Generate();
+    bvh.Build(grown);
+    grown.Generate();
+    assert(bvh.IsBuiltFor(grown));
+
+    std::cout << "✓ BVH query matches testing every chunk" << std::endl;
+}
+
+int main() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "      FRUSTUM CULLING TEST SUITE" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    try {
+        TestPlaneExtraction();
+        std::cout << std::endl;
+
+        TestPlanesMatchClipSpace();
+        std::cout << std::endl;
+
+        TestClassifyAABB();
+        std::cout << std::endl;
+
+        TestChunkBVH();
+        std::cout << std::endl;
+
+        std::cout << "========================================" << std::endl;
+        std::cout << "  ✓ ALL TESTS PASSED SUCCESSFULLY!" << std::endl;
+        std::cout << "========================================" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "\n✗ TEST FAILED: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
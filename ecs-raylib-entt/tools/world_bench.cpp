@@ -0,0 +1,1095 @@
+#include "../src/world/World.hpp"
+#include "../src/world/ChunkBVH.hpp"
+#include "../src/world/Frustum.hpp"
+#include "../src/world/ChunkPipeline.hpp"
+#include "../src/world/AutoSaver.hpp"
+#include "../src/world/ColumnStore.hpp"
+#include "../src/world/VoxelOctree.hpp"
+#include "../src/ecs/systems/WorldSystem.hpp"
+#include "../src/ecs/systems/RenderSystem.hpp"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Simple wall-clock timer returning milliseconds
+class Timer {
+public:
+    Timer() : start(std::chrono::steady_clock::now()) {}
+
+    double ElapsedMs() const {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(now - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Keeps the optimizer from discarding benchmark results
+static volatile long long g_sink = 0;
+
+// Print one result row
+void Report(const char* name, double ms, long long ops) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10) << ms << " ms"
+              << std::setw(10) << std::setprecision(2) << (ms * 1e6 / ops) << " ns/op" << std::endl;
+}
+
+// ============================================================================
+// Grid layouts: the old nested vectors and the flat buffer in each layout
+// ============================================================================
+
+// The old 8-byte voxel (int-sized enum plus a stored Color)
+struct LegacyBlock {
+    int type;
+    Color color;
+
+    LegacyBlock() : type(0), color(WHITE) {}
+    LegacyBlock(World::BlockType t) : type(static_cast<int>(t)), color(World::Block::GetColorFromType(t)) {}
+};
+
+// The pre-flattening representation ([y][z][x], one heap block per row)
+struct NestedGrid {
+    std::vector<std::vector<std::vector<LegacyBlock>>> cells;
+
+    NestedGrid(int w, int h, int d) {
+        cells.resize(h);
+        for (int y = 0; y < h; ++y) {
+            cells[y].resize(d);
+            for (int z = 0; z < d; ++z) {
+                cells[y][z].resize(w);
+            }
+        }
+    }
+
+    int Get(int x, int y, int z) const { return cells[y][z][x].type; }
+    LegacyBlock& At(int x, int y, int z) { return cells[y][z][x]; }
+};
+
+template <World::VoxelLayout L>
+struct FlatGrid {
+    int width, height, depth;
+    std::vector<World::BlockType> cells;
+
+    FlatGrid(int w, int h, int d)
+        : width(w), height(h), depth(d), cells(World::LayoutCapacity<L>(w, h, d)) {}
+
+    size_t Index(int x, int y, int z) const {
+        return World::LinearIndex<L>(x, y, z, width, height, depth);
+    }
+
+    int Get(int x, int y, int z) const { return static_cast<int>(cells[Index(x, y, z)]); }
+    World::BlockType& At(int x, int y, int z) { return cells[Index(x, y, z)]; }
+};
+
+struct Coord { int x, y, z; };
+
+// Fill a grid with a deterministic pattern so reads have something to sum
+template <typename Grid>
+void FillGrid(Grid& grid, int size) {
+    for (int y = 0; y < size; ++y)
+        for (int z = 0; z < size; ++z)
+            for (int x = 0; x < size; ++x)
+                grid.At(x, y, z) = static_cast<World::BlockType>((x + y + z) % 4);
+}
+
+template <typename Grid>
+long long RandomAccess(const Grid& grid, const std::vector<Coord>& coords) {
+    long long sum = 0;
+    for (const Coord& c : coords) {
+        sum += grid.Get(c.x, c.y, c.z);
+    }
+    return sum;
+}
+
+// Sweep with the old y/z/x loop order
+template <typename Grid>
+long long CoordinateSweep(const Grid& grid, int size) {
+    long long sum = 0;
+    for (int y = 0; y < size; ++y)
+        for (int z = 0; z < size; ++z)
+            for (int x = 0; x < size; ++x)
+                sum += grid.Get(x, y, z);
+    return sum;
+}
+
+// Sweep in the layout's own storage order
+template <World::VoxelLayout L>
+long long StorageSweep(const FlatGrid<L>& grid) {
+    long long sum = 0;
+    World::ForEachInLayout<L>(grid.width, grid.height, grid.depth,
+        [&](int, int, int, size_t index) {
+            sum += static_cast<int>(grid.cells[index]);
+        });
+    return sum;
+}
+
+template <typename Grid>
+void BenchGrid(const char* name, Grid& grid, int size, const std::vector<Coord>& coords, int sweeps,
+               size_t bytesPerVoxel) {
+    FillGrid(grid, size);
+
+    Timer random;
+    g_sink += RandomAccess(grid, coords);
+    double randomMs = random.ElapsedMs();
+
+    Timer sweep;
+    for (int i = 0; i < sweeps; ++i) g_sink += CoordinateSweep(grid, size);
+    double sweepMs = sweep.ElapsedMs();
+
+    std::cout << name << " (" << bytesPerVoxel << " B/voxel)" << std::endl;
+    Report("random access", randomMs, static_cast<long long>(coords.size()));
+    Report("y/z/x sweep", sweepMs, static_cast<long long>(sweeps) * size * size * size);
+}
+
+template <World::VoxelLayout L>
+void BenchFlat(const char* name, int size, const std::vector<Coord>& coords, int sweeps) {
+    FlatGrid<L> grid(size, size, size);
+    BenchGrid(name, grid, size, coords, sweeps, sizeof(World::BlockType));
+
+    Timer sweep;
+    for (int i = 0; i < sweeps; ++i) g_sink += StorageSweep(grid);
+    Report("storage-order sweep", sweep.ElapsedMs(), static_cast<long long>(sweeps) * size * size * size);
+}
+
+void BenchLayouts(int size) {
+    const int accessCount = 4000000;
+    const int sweeps = std::max(1, (64 * 1024 * 1024) / (size * size * size));
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> dist(0, size - 1);
+    std::vector<Coord> coords(accessCount);
+    for (Coord& c : coords) {
+        c = { dist(rng), dist(rng), dist(rng) };
+    }
+
+    std::cout << "\n----- Layouts at " << size << "^3 (" << sweeps << " sweeps) -----" << std::endl;
+
+    {
+        NestedGrid nested(size, size, size);
+        BenchGrid("Nested vector [y][z][x]", nested, size, coords, sweeps, sizeof(LegacyBlock));
+    }
+    BenchFlat<World::VoxelLayout::YZX>("Flat YZX", size, coords, sweeps);
+    BenchFlat<World::VoxelLayout::XZY>("Flat XZY", size, coords, sweeps);
+    BenchFlat<World::VoxelLayout::Morton>("Flat Morton", size, coords, sweeps);
+}
+
+// ============================================================================
+// World-level operations
+// ============================================================================
+
+void BenchWorld() {
+    std::cout << "\n----- World (" << World::WORLD_WIDTH << "^3) -----" << std::endl;
+
+    const int runs = 20;
+    World::World world;
+
+    Timer generate;
+    for (int i = 0; i < runs; ++i) world.Generate();
+    Report("Generate()", generate.ElapsedMs() / runs, 1LL * World::WORLD_WIDTH * World::WORLD_HEIGHT * World::WORLD_DEPTH);
+
+    // Seeded generation on 1..N threads (identical output) at a larger size
+    World::World big(128, 128, 128);
+    long long bigBlocks = 128LL * 128 * 128;
+    for (int threads : { 1, 2, 4, 8 }) {
+        Timer timer;
+        for (int i = 0; i < 5; ++i) big.Generate(7, threads);
+        std::string name = "Generate(seed, " + std::to_string(threads) + ") 128^3";
+        Report(name.c_str(), timer.ElapsedMs() / 5, bigBlocks);
+    }
+
+    // Chunk generation alone (no encoding): row spans vs a block at a time
+    std::vector<World::BlockType> types(World::CHUNK_VOLUME);
+    std::vector<World::ChunkCoord> bigChunks;
+    for (int cy = 0; cy < big.GetChunksY(); ++cy)
+        for (int cz = 0; cz < big.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < big.GetChunksX(); ++cx) bigChunks.push_back({ cx, cy, cz });
+    Timer perBlock;
+    for (const World::ChunkCoord& coord : bigChunks) {
+        int baseX = coord.x << World::CHUNK_SHIFT, baseY = coord.y << World::CHUNK_SHIFT, baseZ = coord.z << World::CHUNK_SHIFT;
+        for (int ly = 0; ly < World::CHUNK_SIZE; ++ly)
+            for (int lz = 0; lz < World::CHUNK_SIZE; ++lz)
+                for (int lx = 0; lx < World::CHUNK_SIZE; ++lx)
+                    types[World::LocalIndex(lx, ly, lz)] = big.GenerateBlock(baseX + lx, baseY + ly, baseZ + lz);
+        g_sink += static_cast<long long>(types[coord.x]);
+    }
+    Report("GenerateBlock per voxel 128^3", perBlock.ElapsedMs(), bigBlocks);
+    Timer rows;
+    for (const World::ChunkCoord& coord : bigChunks) {
+        big.GenerateChunkTypes(coord, types.data());
+        g_sink += static_cast<long long>(types[coord.x]);
+    }
+    Report("GenerateChunkTypes rows 128^3", rows.ElapsedMs(), bigBlocks);
+
+    Timer clear;
+    for (int i = 0; i < runs; ++i) world.Clear();
+    Report("Clear()", clear.ElapsedMs() / runs, 1LL * World::WORLD_WIDTH * World::WORLD_HEIGHT * World::WORLD_DEPTH);
+}
+
+// ============================================================================
+// Frustum culling: chunks submitted vs culled, BVH vs testing every chunk
+// ============================================================================
+
+void BenchFrustum(int chunksX, int chunksY, int chunksZ) {
+    int cs = World::CHUNK_SIZE;
+    World::World world(chunksX * cs, chunksY * cs, chunksZ * cs);
+    for (int cy = 0; cy < chunksY; ++cy)
+        for (int cz = 0; cz < chunksZ; ++cz)
+            for (int cx = 0; cx < chunksX; ++cx)
+                world.SetBlock(cx * cs, cy * cs, cz * cs, World::Block(World::BlockType::Stone));
+
+    std::cout << "\n----- Frustum culling (" << world.GetChunkCount() << " chunks, "
+              << world.GetWidth() << "x" << world.GetHeight() << "x" << world.GetDepth() << ") -----" << std::endl;
+
+    Timer build;
+    World::ChunkBVH bvh;
+    bvh.Build(world);
+    Report("BVH build", build.ElapsedMs(), static_cast<long long>(bvh.GetChunkCount()));
+
+    // Cameras orbiting inside the world at eye height, looking outwards
+    const int views = 256;
+    std::vector<World::Frustum> frustums;
+    Vector3 center = { world.GetWidth() * 0.5f, 10.0f, world.GetDepth() * 0.5f };
+    for (int i = 0; i < views; ++i) {
+        float angle = 2.0f * PI * i / views;
+        Camera3D camera = {};
+        camera.position = Vector3{ center.x + std::cos(angle) * center.x * 0.5f, center.y, center.z + std::sin(angle) * center.z * 0.5f };
+        camera.target = Vector3{ camera.position.x + std::cos(angle * 3.0f), center.y - 0.3f, camera.position.z + std::sin(angle * 3.0f) };
+        camera.up = Vector3{ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 45.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+        frustums.push_back(World::ExtractFrustum(World::CameraViewProjection(camera, 16.0f / 9.0f)));
+    }
+
+    const int rounds = 20;
+    std::vector<World::ChunkCoord> visible;
+    long long submitted = 0, tested = 0, nodes = 0;
+    Timer tree;
+    for (int r = 0; r < rounds; ++r) {
+        for (const World::Frustum& frustum : frustums) {
+            visible.clear();
+            World::ChunkCullStats stats;
+            bvh.Query(frustum, visible, &stats);
+            submitted += stats.chunksSubmitted;
+            tested += stats.chunksTested;
+            nodes += stats.nodesVisited;
+        }
+    }
+    double treeMs = tree.ElapsedMs();
+
+    // Baseline: test every chunk box
+    std::vector<BoundingBox> boxes;
+    for (int cy = 0; cy < chunksY; ++cy)
+        for (int cz = 0; cz < chunksZ; ++cz)
+            for (int cx = 0; cx < chunksX; ++cx)
+                boxes.push_back(World::ChunkBVH::ChunkBounds({ cx, cy, cz }, world.GetWidth(), world.GetHeight(), world.GetDepth()));
+    long long bruteSubmitted = 0;
+    Timer brute;
+    for (int r = 0; r < rounds; ++r) {
+        for (const World::Frustum& frustum : frustums) {
+            for (const BoundingBox& box : boxes) {
+                bruteSubmitted += World::IntersectsAABB(frustum, box) ? 1 : 0;
+            }
+        }
+    }
+    double bruteMs = brute.ElapsedMs();
+    g_sink += bruteSubmitted + static_cast<long long>(visible.size());
+
+    long long queries = static_cast<long long>(rounds) * views;
+    Report("BVH query", treeMs, queries);
+    Report("test every chunk", bruteMs, queries);
+
+    double total = static_cast<double>(bvh.GetChunkCount());
+    double avgSubmitted = static_cast<double>(submitted) / queries;
+    std::cout << "  submitted " << std::fixed << std::setprecision(1) << avgSubmitted << " / " << total
+              << " chunks per view (" << (100.0 * (1.0 - avgSubmitted / total)) << "% culled)" << std::endl;
+    std::cout << "  per query: " << static_cast<double>(nodes) / queries << " nodes, "
+              << static_cast<double>(tested) / queries << " chunk boxes tested (vs " << total << ")" << std::endl;
+}
+
+// ============================================================================
+// ECS terrain models: one entity per block vs the hybrid VoxelWorld grid
+// ============================================================================
+
+// Heap bytes held by one component pool (packed entities and values plus
+// the sparse array; empty tag types store no values)
+template <typename T>
+size_t PoolBytes(entt::registry& registry) {
+    auto& pool = registry.storage<T>();
+    size_t valueSize = std::is_empty_v<T> ? 0 : sizeof(T);
+    return pool.capacity() * (sizeof(entt::entity) + valueSize) + pool.extent() * sizeof(entt::entity);
+}
+
+// Heap bytes held by the block entities and their indices in a registry
+size_t BlockEntityBytes(entt::registry& registry) {
+    size_t bytes = PoolBytes<entt::entity>(registry);
+    bytes += PoolBytes<ECS::Position>(registry) + PoolBytes<ECS::BlockData>(registry);
+    bytes += PoolBytes<ECS::Surface>(registry) + PoolBytes<ECS::Renderable>(registry);
+    bytes += PoolBytes<ECS::Mineable>(registry) + PoolBytes<ECS::VisibleFaces>(registry);
+    bytes += PoolBytes<ECS::SoilTag>(registry) + PoolBytes<ECS::StoneTag>(registry);
+    bytes += PoolBytes<ECS::GoldTag>(registry) + PoolBytes<ECS::SilverTag>(registry);
+    if (const ECS::BlockGrid* grid = registry.ctx().find<ECS::BlockGrid>()) {
+        bytes += grid->cells.capacity() * sizeof(entt::entity);
+    }
+    if (const ECS::ShellLayers* shell = registry.ctx().find<ECS::ShellLayers>()) {
+        for (const auto& layer : shell->layers) bytes += layer.capacity() * sizeof(entt::entity);
+    }
+    return bytes;
+}
+
+// The former PopulateFromWorld: clear the registry, then create and emplace
+// block by block; the grid and visible faces as before
+void PopulateOneByOne(entt::registry& registry, const World::World& world) {
+    registry.clear();
+    ECS::BlockGrid grid;
+    grid.Reset(world.GetWidth(), world.GetHeight(), world.GetDepth());
+    for (int y = 0; y < world.GetHeight(); ++y) {
+        for (int z = 0; z < world.GetDepth(); ++z) {
+            for (int x = 0; x < world.GetWidth(); ++x) {
+                World::BlockType type = world.GetBlockType(x, y, z);
+                if (type == World::BlockType::Air) continue;
+
+                const World::BlockProperties& props = World::GetBlockProperties(type);
+                auto entity = registry.create();
+                registry.emplace<ECS::Position>(entity, x, y, z);
+                registry.emplace<ECS::BlockData>(entity, type, props.color);
+                registry.emplace<ECS::Surface>(entity, world.IsExposedSurface(x, y, z));
+                registry.emplace<ECS::Renderable>(entity, true);
+                registry.emplace<ECS::Mineable>(entity, true, props.value, props.hardness);
+                switch (type) {
+                    case World::BlockType::Soil: registry.emplace<ECS::SoilTag>(entity); break;
+                    case World::BlockType::Stone: registry.emplace<ECS::StoneTag>(entity); break;
+                    case World::BlockType::Gold: registry.emplace<ECS::GoldTag>(entity); break;
+                    case World::BlockType::Silver: registry.emplace<ECS::SilverTag>(entity); break;
+                    default: break;
+                }
+                grid.cells[grid.Index(x, y, z)] = entity;
+            }
+        }
+    }
+    registry.ctx().insert_or_assign(std::move(grid));
+    ECS::CubeTopologySystem().Build(registry);
+}
+
+void BenchPopulate(int size) {
+    std::cout << "\n----- PopulateFromWorld (" << size << "^3) -----" << std::endl;
+
+    World::World world(size, size, size);
+    world.Generate();
+    long long blocks = 1LL * size * size * size;
+    const int runs = 10;
+
+    // Block by block
+    double oneByOneMs = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        entt::registry registry;
+        Timer timer;
+        PopulateOneByOne(registry, world);
+        oneByOneMs += timer.ElapsedMs();
+        g_sink += static_cast<long long>(registry.view<ECS::Position>().size());
+    }
+
+    // Same registry again, as when regenerating: clear() then one by one
+    entt::registry repeated;
+    PopulateOneByOne(repeated, world);
+    Timer repeatedTimer;
+    for (int i = 0; i < runs; ++i) PopulateOneByOne(repeated, world);
+    double repeatedMs = repeatedTimer.ElapsedMs();
+
+    // Bulk path: fresh, then reused entities and pools
+    ECS::WorldSystem worldSystem;
+    double bulkFreshMs = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        entt::registry registry;
+        worldSystem.PopulateFromWorld(registry, world);
+        bulkFreshMs += worldSystem.GetLastPopulateMs();
+    }
+    entt::registry reused;
+    worldSystem.PopulateFromWorld(reused, world);
+    double bulkReusedMs = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        worldSystem.PopulateFromWorld(reused, world);
+        bulkReusedMs += worldSystem.GetLastPopulateMs();
+    }
+    g_sink += static_cast<long long>(reused.view<ECS::Position>().size());
+
+    Report("one by one, new registry", oneByOneMs / runs, blocks);
+    Report("one by one, repopulate", repeatedMs / runs, blocks);
+    Report("bulk, new registry", bulkFreshMs / runs, blocks);
+    Report("bulk, repopulate", bulkReusedMs / runs, blocks);
+}
+
+void BenchEcsModes(int size) {
+    std::cout << "\n----- ECS terrain models (" << size << "^3) -----" << std::endl;
+
+    World::World world(size, size, size);
+    world.Generate();
+    long long blocks = 1LL * size * size * size;
+    ECS::WorldSystem worldSystem;
+    ECS::RenderSystem renderSystem;
+    const int runs = 5;
+
+    // Entity per block: a fresh registry per run, as after pressing R
+    double populateMs = 0.0;
+    size_t entityBytes = 0, entityCount = 0, entitySlab = 0;
+    for (int i = 0; i < runs; ++i) {
+        entt::registry registry;
+        Timer populate;
+        worldSystem.PopulateFromWorld(registry, world);
+        populateMs += populate.ElapsedMs();
+        entityBytes = BlockEntityBytes(registry);
+        entityCount = registry.storage<entt::entity>().free_list();
+        entitySlab = renderSystem.CollectSlabFaces(registry, 3, INT_MAX);
+    }
+
+    entt::registry registry;
+    worldSystem.PopulateFromWorld(registry, world);
+    Timer entitySlabTimer;
+    for (int i = 0; i < runs; ++i) g_sink += renderSystem.CollectSlabFaces(registry, 3, INT_MAX);
+    double entitySlabMs = entitySlabTimer.ElapsedMs() / runs;
+
+    // Hybrid: the registry only learns where the grid is
+    entt::registry hybrid;
+    Timer attach;
+    for (int i = 0; i < runs; ++i) worldSystem.AttachWorld(hybrid, world);
+    double attachMs = attach.ElapsedMs() / runs;
+    size_t hybridBytes = BlockEntityBytes(hybrid);
+    size_t hybridCount = hybrid.storage<entt::entity>().free_list();
+
+    // (first call fills the per-chunk shell cache, as the first frame would)
+    size_t hybridSlab = renderSystem.CollectSlabFaces(hybrid, 3, INT_MAX);
+    Timer hybridSlabTimer;
+    for (int i = 0; i < runs; ++i) hybridSlab = renderSystem.CollectSlabFaces(hybrid, 3, INT_MAX);
+    double hybridSlabMs = hybridSlabTimer.ElapsedMs() / runs;
+    g_sink += static_cast<long long>(entitySlab == hybridSlab);
+
+    Report("entity/block: populate", populateMs / runs, blocks);
+    Report("hybrid: attach grid", attachMs, blocks);
+    Report("entity/block: underground", entitySlabMs, blocks);
+    Report("hybrid: underground", hybridSlabMs, blocks);
+    std::cout << "  entity/block: " << entityCount << " entities, " << entityBytes / 1024 << " KiB in pools and indices" << std::endl;
+    std::cout << "  hybrid:       " << hybridCount << " entities, " << hybridBytes / 1024 << " KiB in pools and indices" << std::endl;
+    std::cout << "  (terrain itself: " << world.GetMemoryUsage() / 1024 << " KiB of chunk data in both models; "
+              << entitySlab << " underground faces in both)" << std::endl;
+}
+
+// ============================================================================
+// Rebuilding a lazy world: everything in one frame vs the worker pipeline
+// drained under a per-frame budget
+// ============================================================================
+
+void BenchPipeline(int size, double budgetMs) {
+    std::cout << "\n----- Chunk pipeline rebuild (" << size << "^3, "
+              << budgetMs << " ms drain budget) -----" << std::endl;
+
+    World::World world(size, size, size, 3);
+    std::vector<World::ChunkCoord> coords;
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx)
+                coords.push_back({ cx, cy, cz });
+    long long chunks = static_cast<long long>(coords.size());
+
+    // Main thread does it all (the frame pressing R used to take)
+    world.GenerateLazily();
+    World::ChunkMeshData mesh;
+    Timer inlineTimer;
+    for (const World::ChunkCoord& coord : coords) {
+        world.LoadChunk(coord);
+        World::BuildChunkMesh(world, coord, mesh);
+        g_sink += mesh.GetVertexCount();
+    }
+    double inlineMs = inlineTimer.ElapsedMs();
+
+    // Pipeline: the main thread only requests and drains
+    world.GenerateLazily(4);
+    World::ChunkPipeline pipeline;
+    pipeline.Reset(world);
+    Timer total;
+    double worstFrameMs = 0.0;
+    int frames = 0;
+    Timer request;
+    for (const World::ChunkCoord& coord : coords) pipeline.Request(coord);
+    worstFrameMs = request.ElapsedMs();
+    while (!pipeline.IsIdle()) {
+        Timer frame;
+        pipeline.Drain(world, budgetMs, [&](const World::ChunkCoord&, const World::ChunkMeshData& data) {
+            g_sink += data.GetVertexCount();
+        });
+        worstFrameMs = std::max(worstFrameMs, frame.ElapsedMs());
+        ++frames;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));  // rest of the frame
+    }
+    double totalMs = total.ElapsedMs();
+    World::PipelineStats stats = pipeline.GetStats();
+
+    Report("main thread, one frame", inlineMs, chunks);
+    Report("pipeline, wall clock", totalMs, chunks);
+    Report("pipeline, worst frame", worstFrameMs, 1);
+    std::cout << "  " << pipeline.GetWorkerCount() << " workers, " << frames << " drain calls; per chunk: wait "
+              << std::setprecision(3) << stats.wait.averageMs << " ms, generate " << stats.generate.averageMs
+              << " ms, cull " << stats.cull.averageMs << " ms, mesh " << stats.mesh.averageMs
+              << " ms; drain " << stats.drain.averageMs << " ms/call (max " << stats.drain.maxMs << ")" << std::endl;
+}
+
+// ============================================================================
+// Statistics: the old per-voxel map counting vs the SIMD histogram pass
+// ============================================================================
+
+// What PrintStatistics used to do: three std::map counters and the
+// six-branch IsExposedSurface per voxel
+long long LegacyStatistics(const World::World& world) {
+    std::map<World::BlockType, int> counts;
+    std::map<World::BlockType, int> surfaceCounts;
+    std::map<World::BlockType, int> interiorCounts;
+    std::vector<World::BlockType> data(World::CHUNK_VOLUME);
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, data.data());
+                World::ForEachInLayout<World::GRID_LAYOUT>(World::CHUNK_SIZE, World::CHUNK_SIZE, World::CHUNK_SIZE,
+                    [&](int lx, int ly, int lz, size_t index) {
+                        int x = (cx << World::CHUNK_SHIFT) + lx;
+                        int y = (cy << World::CHUNK_SHIFT) + ly;
+                        int z = (cz << World::CHUNK_SHIFT) + lz;
+                        if (!world.IsValidPosition(x, y, z)) return;
+                        World::BlockType type = data[index];
+                        counts[type]++;
+                        if (type == World::BlockType::Air) return;
+                        if (world.IsExposedSurface(x, y, z)) {
+                            surfaceCounts[type]++;
+                        } else {
+                            interiorCounts[type]++;
+                        }
+                    });
+            }
+    return counts[World::BlockType::Gold] + surfaceCounts[World::BlockType::Soil] + interiorCounts[World::BlockType::Silver];
+}
+
+void BenchStatistics(int size) {
+    std::cout << "\n----- Statistics (" << size << "^3) -----" << std::endl;
+
+    World::World world(size, size, size, 9);
+    world.Generate();
+    long long blocks = 1LL * size * size * size;
+    const int runs = 5;
+
+    Timer legacy;
+    for (int i = 0; i < runs; ++i) g_sink += LegacyStatistics(world);
+    Report("maps + IsExposedSurface", legacy.ElapsedMs() / runs, blocks);
+
+    for (World::SimdLevel level : { World::SimdLevel::Scalar, World::SimdLevel::SSE2, World::SimdLevel::AVX2 }) {
+        if (level > World::DetectSimdLevel()) continue;
+        Timer timer;
+        for (int i = 0; i < runs; ++i) {
+            World::BlockStatistics stats = world.ComputeStatistics(level);
+            g_sink += static_cast<long long>(stats.counts[static_cast<int>(World::BlockType::Gold)]);
+        }
+        std::string name = std::string("ComputeStatistics ") + World::GetSimdLevelName(level);
+        Report(name.c_str(), timer.ElapsedMs() / runs, blocks);
+    }
+
+    // The kernel alone over a decoded buffer
+    std::vector<World::BlockType> flat(static_cast<size_t>(blocks));
+    for (size_t i = 0; i < flat.size(); ++i) flat[i] = static_cast<World::BlockType>(i % 7 % World::BLOCK_TYPE_COUNT);
+    for (World::SimdLevel level : { World::SimdLevel::Scalar, World::SimdLevel::SSE2, World::SimdLevel::AVX2 }) {
+        if (level > World::DetectSimdLevel()) continue;
+        uint64_t counts[World::BLOCK_TYPE_COUNT] = {};
+        Timer timer;
+        for (int i = 0; i < runs; ++i) World::CountBlockTypes(flat.data(), flat.size(), counts, level);
+        g_sink += static_cast<long long>(counts[0]);
+        std::string name = std::string("CountBlockTypes ") + World::GetSimdLevelName(level);
+        Report(name.c_str(), timer.ElapsedMs() / runs, blocks);
+    }
+}
+
+// ============================================================================
+// Block sampling: voxel-at-a-time draws vs batched rows per SIMD level
+// ============================================================================
+
+void BenchSampler(int size) {
+    std::cout << "\n----- Block sampling (" << size << "^3) -----" << std::endl;
+
+    const World::BlockSampler& sampler = World::World::GetUndergroundSampler();
+    long long voxels = 1LL * size * size * size;
+    std::vector<World::BlockType> row(size);
+    auto reportRate = [&](const char* name, double ms) {
+        Report(name, ms, voxels);
+        std::cout << "  " << std::left << std::setw(28) << "" << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << (voxels / (ms * 1e-3) / 1e6) << " Mvoxels/s" << std::endl;
+    };
+
+    // The old draw: three SplitMix64 rounds per voxel and a chain of compares
+    Timer voxel;
+    World::VoxelRandom random(1);
+    for (int y = 0; y < size; ++y)
+        for (int z = 0; z < size; ++z) {
+            for (int x = 0; x < size; ++x) {
+                uint32_t roll = random.Below(x, y, z, 100);
+                row[x] = roll < 70 ? World::BlockType::Stone : roll < 90 ? World::BlockType::Gold : World::BlockType::Silver;
+            }
+            g_sink += static_cast<long long>(row[z % size]);
+        }
+    reportRate("VoxelRandom per voxel", voxel.ElapsedMs());
+
+    Timer single;
+    for (int y = 0; y < size; ++y)
+        for (int z = 0; z < size; ++z) {
+            World::RowRandom rowRandom(1, y, z);
+            for (int x = 0; x < size; ++x) row[x] = sampler.Sample(rowRandom, x);
+            g_sink += static_cast<long long>(row[z % size]);
+        }
+    reportRate("Sample per voxel", single.ElapsedMs());
+
+    for (World::SimdLevel level : { World::SimdLevel::Scalar, World::SimdLevel::SSE2, World::SimdLevel::AVX2 }) {
+        if (level > World::DetectSimdLevel()) continue;
+        Timer timer;
+        for (int y = 0; y < size; ++y)
+            for (int z = 0; z < size; ++z) {
+                sampler.SampleRow(World::RowRandom(1, y, z), 0, size, row.data(), level);
+                g_sink += static_cast<long long>(row[z % size]);
+            }
+        std::string name = std::string("SampleRow ") + World::GetSimdLevelName(level);
+        reportRate(name.c_str(), timer.ElapsedMs());
+    }
+}
+
+// ============================================================================
+// Noise terrain: eager generation at large sizes, per thread count
+// ============================================================================
+
+void BenchTerrain(int size) {
+    std::cout << "\n----- Terrain (" << size << "^3) -----" << std::endl;
+
+    World::World world(size, size, size);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    long long blocks = 1LL * size * size * size;
+    for (int threads : { 1, 4 }) {
+        Timer timer;
+        world.Generate(5, threads);
+        std::string name = "Generate(seed, " + std::to_string(threads) + ")";
+        Report(name.c_str(), timer.ElapsedMs(), blocks);
+    }
+
+    World::World cube(size, size, size);
+    Timer timer;
+    cube.Generate(5);
+    Report("solid cube Generate()", timer.ElapsedMs(), blocks);
+
+    World::BlockStatistics stats = world.ComputeStatistics();
+    std::cout << "  " << stats.GetSolid() * 100 / blocks << "% solid, "
+              << stats.counts[static_cast<int>(World::BlockType::Gold)] << " gold, "
+              << stats.counts[static_cast<int>(World::BlockType::Silver)] << " silver" << std::endl;
+}
+
+void BenchHeights(int size) {
+    std::cout << "\n----- Column heights (" << size << "^3 terrain) -----" << std::endl;
+
+    World::World world(size, size, size);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate(5);
+    long long columns = 1LL * size * size;
+
+    // What GetSurfaceLevel used to do: walk each column down from the top
+    Timer scanTimer;
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            int y = size - 1;
+            while (y >= 0 && world.GetBlockType(x, y, z) == World::BlockType::Air) --y;
+            g_sink += y;
+        }
+    }
+    Report("top-down scan", scanTimer.ElapsedMs(), columns);
+
+    Timer buildTimer;
+    for (int z = 0; z < size; ++z)
+        for (int x = 0; x < size; ++x) g_sink += world.GetSurfaceLevel(x, z);
+    Report("GetSurfaceLevel (first, builds)", buildTimer.ElapsedMs(), columns);
+
+    Timer cachedTimer;
+    for (int pass = 0; pass < 10; ++pass)
+        for (int z = 0; z < size; ++z)
+            for (int x = 0; x < size; ++x) g_sink += world.GetSurfaceLevel(x, z);
+    Report("GetSurfaceLevel (cached)", cachedTimer.ElapsedMs(), columns * 10);
+
+    // Mining the top block and putting it back: each SetBlock keeps the
+    // column current
+    Timer editTimer;
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            int top = world.GetSurfaceLevel(x, z);
+            World::BlockType type = world.GetBlockType(x, top, z);
+            world.SetBlock(x, top, z, World::Block(World::BlockType::Air));
+            world.SetBlock(x, top, z, World::Block(type));
+        }
+    }
+    Report("SetBlock dig + refill", editTimer.ElapsedMs(), columns * 2);
+
+    Timer rangeTimer;
+    for (int pass = 0; pass < 100; ++pass)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) g_sink += world.GetChunkColumnHeights(cx, cz).highest;
+    Report("GetChunkColumnHeights", rangeTimer.ElapsedMs(), 100LL * world.GetChunksX() * world.GetChunksZ());
+}
+
+void BenchSaveLoad(int size) {
+    std::cout << "\n----- Save/Load (" << size << "^3) -----" << std::endl;
+    std::string path = (std::filesystem::temp_directory_path() / "world_bench.vxw").string();
+
+    for (World::GeneratorMode mode : { World::GeneratorMode::Terrain, World::GeneratorMode::SolidCube }) {
+        const char* label = mode == World::GeneratorMode::Terrain ? "terrain" : "solid cube";
+        World::World world(size, size, size);
+        world.SetGeneratorMode(mode);
+        Timer generateTimer;
+        world.Generate(5);
+        double generateMs = generateTimer.ElapsedMs();
+        long long chunks = static_cast<long long>(world.GetChunkCount());
+
+        Timer saveTimer;
+        world.Save(path, World::SaveMode::Snapshot);
+        Report((std::string(label) + " Save").c_str(), saveTimer.ElapsedMs(), chunks);
+
+        World::World loaded;
+        Timer loadTimer;
+        loaded.Load(path);
+        Report((std::string(label) + " Load (map only)").c_str(), loadTimer.ElapsedMs(), chunks);
+
+        // Scattered single blocks straight from the file, then every chunk
+        // decoded, against generating them
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> coord(0, size - 1);
+        const int reads = 200000;
+        Timer readTimer;
+        for (int i = 0; i < reads; ++i) {
+            g_sink += static_cast<uint64_t>(loaded.GetBlockType(coord(rng), coord(rng), coord(rng)));
+        }
+        Report((std::string(label) + " GetBlockType").c_str(), readTimer.ElapsedMs(), reads);
+
+        Timer decodeTimer;
+        for (int cy = 0; cy < loaded.GetChunksY(); ++cy)
+            for (int cz = 0; cz < loaded.GetChunksZ(); ++cz)
+                for (int cx = 0; cx < loaded.GetChunksX(); ++cx) loaded.LoadChunk({ cx, cy, cz });
+        Report((std::string(label) + " LoadChunk all").c_str(), decodeTimer.ElapsedMs(), chunks);
+        Report((std::string(label) + " Generate (for scale)").c_str(), generateMs, chunks);
+
+        size_t bytes = loaded.GetSaveFile()->GetSize();
+        std::cout << "  " << label << " file: " << bytes / 1024 << " KiB, " << std::setprecision(3)
+                  << bytes * 1.0 / (1LL * size * size * size) << " bytes/voxel, in memory "
+                  << world.GetMemoryUsage() / 1024 << " KiB" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+void BenchDeltaSave(int size) {
+    std::cout << "\n----- Delta vs Snapshot Save (" << size << "^3 terrain) -----" << std::endl;
+    std::string path = (std::filesystem::temp_directory_path() / "world_bench_delta.vxw").string();
+    World::World world(size, size, size);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate(5);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    const World::BlockType placed[] = { World::BlockType::Air, World::BlockType::Gold, World::BlockType::Stone };
+
+    // Save time and size as edits pile up, scattered over the world
+    int edits = 0;
+    for (int target : { 10, 100, 1000, 10000 }) {
+        for (; edits < target; ++edits) {
+            world.SetBlock(coord(rng), coord(rng), coord(rng), World::Block(placed[edits % 3]));
+        }
+        Timer deltaTimer;
+        world.Save(path);
+        double deltaMs = deltaTimer.ElapsedMs();
+        size_t deltaBytes = std::filesystem::file_size(path);
+        Timer snapshotTimer;
+        world.Save(path, World::SaveMode::Snapshot);
+        double snapshotMs = snapshotTimer.ElapsedMs();
+        size_t snapshotBytes = std::filesystem::file_size(path);
+        std::cout << "  " << std::setw(5) << edits << " edits: delta " << std::fixed << std::setprecision(2)
+                  << deltaMs << " ms, " << deltaBytes / 1024.0 << " KiB; snapshot " << snapshotMs << " ms, "
+                  << snapshotBytes / 1024.0 << " KiB" << std::endl;
+    }
+
+    // Loading the delta file and decoding every chunk: generation plus the
+    // changes, against decoding full payloads
+    long long chunks = static_cast<long long>(world.GetChunkCount());
+    for (World::SaveMode mode : { World::SaveMode::Delta, World::SaveMode::Snapshot }) {
+        const char* label = mode == World::SaveMode::Delta ? "delta" : "snapshot";
+        world.Save(path, mode);
+        World::World loaded;
+        loaded.Load(path);
+        Timer decodeTimer;
+        for (int cy = 0; cy < loaded.GetChunksY(); ++cy)
+            for (int cz = 0; cz < loaded.GetChunksZ(); ++cz)
+                for (int cx = 0; cx < loaded.GetChunksX(); ++cx) loaded.LoadChunk({ cx, cy, cz });
+        Report((std::string(label) + " LoadChunk all").c_str(), decodeTimer.ElapsedMs(), chunks);
+    }
+    std::remove(path.c_str());
+}
+
+void BenchAutoSave(int size) {
+    std::cout << "\n----- Background Save (" << size << "^3 terrain) -----" << std::endl;
+    std::string path = (std::filesystem::temp_directory_path() / "world_bench_autosave.vxw").string();
+    World::World world(size, size, size);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate(5);
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    auto edit = [&](int count) {
+        for (int i = 0; i < count; ++i) {
+            world.SetBlock(coord(rng), coord(rng), coord(rng), World::Block(i % 2 ? World::BlockType::Gold : World::BlockType::Air));
+        }
+    };
+
+    // A blocking save of the whole world, for scale
+    edit(2000);
+    Timer blockingTimer;
+    world.Save(path, World::SaveMode::Snapshot);
+    Report("blocking Save (snapshot)", blockingTimer.ElapsedMs(), static_cast<long long>(world.GetChunkCount()));
+
+    // Rounds of edits, each followed by a background save: the frame pays
+    // for the capture only, and the writer for the chunks changed since
+    // the previous round
+    for (World::SaveMode mode : { World::SaveMode::Snapshot, World::SaveMode::Delta }) {
+        World::AutoSaver saver(path, mode);
+        World::SaveStats stats;
+        saver.Save(world);
+        saver.Finish(world, stats);
+        std::cout << "  " << (mode == World::SaveMode::Delta ? "delta" : "snapshot") << " first save: "
+                  << stats.chunksWritten << " chunks, capture " << std::fixed << std::setprecision(3) << stats.captureMs
+                  << " ms, write " << stats.writeMs << " ms" << std::endl;
+        for (int edits : { 10, 100, 1000 }) {
+            edit(edits);
+            size_t unsaved = world.GetUnsavedChunkCount();
+            saver.Save(world);
+            edit(edits);  // the world keeps changing while the file is written
+            saver.Finish(world, stats);
+            std::cout << "  " << std::setw(5) << unsaved << " unsaved chunks: capture " << stats.captureMs
+                      << " ms, write " << stats.writeMs << " ms (" << stats.chunksWritten << " written, "
+                      << stats.chunksCarried << " carried), " << stats.bytesWritten / 1024 << " KiB" << std::endl;
+        }
+    }
+    std::remove(path.c_str());
+}
+
+void BenchColumnStore(int size) {
+    std::cout << "\n----- Column Runs vs Chunks vs Dense (" << size << "^3) -----" << std::endl;
+    long long voxels = 1LL * size * size * size;
+    for (World::GeneratorMode mode : { World::GeneratorMode::Terrain, World::GeneratorMode::SolidCube }) {
+        std::string label = mode == World::GeneratorMode::Terrain ? "terrain" : "solid cube";
+        World::World world(size, size, size);
+        world.SetGeneratorMode(mode);
+        world.Generate(5);
+
+        Timer buildTimer;
+        World::ColumnStore runs = World::ColumnStore::FromWorld(world);
+        Report((label + " build runs").c_str(), buildTimer.ElapsedMs(), voxels);
+
+        // One byte per voxel in x-fastest order, the dense baseline
+        std::vector<World::BlockType> dense(static_cast<size_t>(voxels));
+        runs.ForEachRun([&](int x, int z, const World::BlockRun& run) {
+            for (int y = run.begin; y < run.end; ++y) {
+                dense[(static_cast<size_t>(y) * size + z) * size + x] = run.type;
+            }
+        });
+        std::cout << "  " << label << ": " << runs.GetRunCount() << " runs (" << std::fixed << std::setprecision(1)
+                  << voxels * 1.0 / runs.GetRunCount() << " voxels/run); memory runs "
+                  << runs.GetMemoryUsage() / 1024 << " KiB, chunks " << world.GetMemoryUsage() / 1024
+                  << " KiB, dense " << dense.size() / 1024 << " KiB" << std::endl;
+
+        // Whole-world scans: block histogram and visible faces
+        Timer denseStatsTimer;
+        World::TypeCounts counts{};
+        World::CountBlockTypes(dense.data(), dense.size(), counts.data());
+        g_sink += counts[0];
+        Report((label + " histogram dense").c_str(), denseStatsTimer.ElapsedMs(), voxels);
+        Timer chunkStatsTimer;
+        g_sink += world.ComputeStatistics().GetSolid();
+        Report((label + " statistics chunks").c_str(), chunkStatsTimer.ElapsedMs(), voxels);
+        Timer runStatsTimer;
+        g_sink += runs.ComputeStatistics().GetSolid();
+        Report((label + " statistics runs").c_str(), runStatsTimer.ElapsedMs(), voxels);
+
+        Timer denseFacesTimer;
+        size_t denseFaces = 0;
+        auto solid = [&](int x, int y, int z) {
+            return x >= 0 && x < size && y >= 0 && y < size && z >= 0 && z < size &&
+                   dense[(static_cast<size_t>(y) * size + z) * size + x] != World::BlockType::Air;
+        };
+        for (int y = 0; y < size; ++y)
+            for (int z = 0; z < size; ++z)
+                for (int x = 0; x < size; ++x) {
+                    if (!solid(x, y, z)) continue;
+                    denseFaces += !solid(x - 1, y, z) + !solid(x + 1, y, z) + !solid(x, y - 1, z) +
+                                  !solid(x, y + 1, z) + !solid(x, y, z - 1) + !solid(x, y, z + 1);
+                }
+        Report((label + " faces dense").c_str(), denseFacesTimer.ElapsedMs(), voxels);
+        Timer runFacesTimer;
+        size_t runFaces = runs.CountVisibleFaces();
+        Report((label + " faces runs").c_str(), runFacesTimer.ElapsedMs(), voxels);
+        if (runFaces != denseFaces) std::cout << "  face count mismatch!" << std::endl;
+
+        // Random access
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> coord(0, size - 1);
+        const int ops = 1000000;
+        std::vector<int> positions(ops * 3);
+        for (int& p : positions) p = coord(rng);
+        Timer chunkGetTimer;
+        for (int i = 0; i < ops; ++i) {
+            g_sink += static_cast<uint64_t>(world.GetBlockType(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]));
+        }
+        Report((label + " GetBlockType chunks").c_str(), chunkGetTimer.ElapsedMs(), ops);
+        Timer runGetTimer;
+        for (int i = 0; i < ops; ++i) {
+            g_sink += static_cast<uint64_t>(runs.GetBlockType(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]));
+        }
+        Report((label + " GetBlockType runs").c_str(), runGetTimer.ElapsedMs(), ops);
+
+        const int writes = 200000;
+        Timer chunkSetTimer;
+        for (int i = 0; i < writes; ++i) {
+            world.SetBlock(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2], World::Block(World::BlockType::Gold));
+        }
+        Report((label + " SetBlock chunks").c_str(), chunkSetTimer.ElapsedMs(), writes);
+        Timer runSetTimer;
+        for (int i = 0; i < writes; ++i) {
+            runs.SetBlock(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2], World::BlockType::Gold);
+        }
+        Report((label + " SetBlock runs").c_str(), runSetTimer.ElapsedMs(), writes);
+    }
+}
+
+void BenchVoxelOctree(int size, int hugeSize) {
+    std::cout << "\n----- Voxel Octree vs Chunks (" << size << "^3 terrain, " << hugeSize << " x 256 x " << hugeSize
+              << " layers) -----" << std::endl;
+    long long voxels = 1LL * size * size * size;
+    World::World world(size, size, size);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate(5);
+
+    Timer buildTimer;
+    World::VoxelOctree tree = World::VoxelOctree::FromWorld(world);
+    Report("terrain build octree", buildTimer.ElapsedMs(), voxels);
+    std::cout << "  terrain: " << tree.GetNodeCount() << " nodes; memory octree " << tree.GetMemoryUsage() / 1024
+              << " KiB, chunks " << world.GetMemoryUsage() / 1024 << " KiB, dense " << voxels / 1024 << " KiB"
+              << std::endl;
+
+    // Chunks a mesher could skip: all air, or solid with solid neighbours
+    Timer skipTimer;
+    int skipped = 0, chunks = 0;
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                World::VoxelBox box = World::VoxelBox::OfChunk({ cx, cy, cz });
+                World::VoxelBox around = { box.minX - 1, box.minY - 1, box.minZ - 1, box.maxX + 1, box.maxY + 1, box.maxZ + 1 };
+                ++chunks;
+                skipped += tree.IsRegionAir(box) || tree.IsRegionSolid(around);
+            }
+    Report("terrain chunk skip checks", skipTimer.ElapsedMs(), chunks);
+    std::cout << "  " << skipped << " of " << chunks << " chunks need no mesh" << std::endl;
+
+    // Random access
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    const int ops = 1000000;
+    std::vector<int> positions(ops * 3);
+    for (int& p : positions) p = coord(rng);
+    Timer chunkGetTimer;
+    for (int i = 0; i < ops; ++i) {
+        g_sink += static_cast<uint64_t>(world.GetBlockType(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]));
+    }
+    Report("terrain GetBlockType chunks", chunkGetTimer.ElapsedMs(), ops);
+    Timer treeGetTimer;
+    for (int i = 0; i < ops; ++i) {
+        g_sink += static_cast<uint64_t>(tree.GetBlockType(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]));
+    }
+    Report("terrain GetBlockType octree", treeGetTimer.ElapsedMs(), ops);
+
+    const int writes = 200000;
+    Timer chunkSetTimer;
+    for (int i = 0; i < writes; ++i) {
+        world.SetBlock(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2], World::Block(World::BlockType::Gold));
+    }
+    Report("terrain SetBlock chunks", chunkSetTimer.ElapsedMs(), writes);
+    Timer treeSetTimer;
+    for (int i = 0; i < writes; ++i) {
+        tree.SetBlock(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2], World::BlockType::Gold);
+    }
+    Report("terrain SetBlock octree", treeSetTimer.ElapsedMs(), writes);
+
+    // A world too big to hold as chunks: rock, dirt and sky layers with a
+    // few thousand edits and carved rooms
+    long long hugeVoxels = 256LL * hugeSize * hugeSize;
+    Timer hugeTimer;
+    World::VoxelOctree huge(hugeSize, 256, hugeSize);
+    huge.FillRegion({ 0, 0, 0, hugeSize, 96, hugeSize }, World::BlockType::Stone);
+    huge.FillRegion({ 0, 96, 0, hugeSize, 100, hugeSize }, World::BlockType::Gold);
+    std::uniform_int_distribution<int> hugeCoord(0, hugeSize - 1);
+    for (int i = 0; i < 1000; ++i) {
+        int x = hugeCoord(rng), z = hugeCoord(rng);
+        huge.FillRegion({ x, 40, z, x + 9, 47, z + 13 }, World::BlockType::Air);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        huge.SetBlock(hugeCoord(rng), 100 + static_cast<int>(rng() % 8), hugeCoord(rng), World::BlockType::Silver);
+    }
+    Report("huge fill and edit", hugeTimer.ElapsedMs(), 11000);
+    std::cout << "  huge: " << huge.GetNodeCount() << " nodes, " << huge.GetMemoryUsage() / 1024 << " KiB for "
+              << hugeVoxels / (1024 * 1024) << " M voxels (dense " << hugeVoxels / (1024 * 1024) << " MiB)" << std::endl;
+
+    Timer hugeGetTimer;
+    std::uniform_int_distribution<int> hugeY(0, 255);
+    for (int i = 0; i < ops; ++i) {
+        g_sink += static_cast<uint64_t>(huge.GetBlockType(hugeCoord(rng), hugeY(rng), hugeCoord(rng)));
+    }
+    Report("huge GetBlockType", hugeGetTimer.ElapsedMs(), ops);
+
+    Timer regionTimer;
+    long long regions = 0;
+    huge.ForEachRegion({ 0, 0, 0, hugeSize, 256, hugeSize }, [&](const World::VoxelBox& box, World::BlockType type) {
+        regions += type != World::BlockType::Air;
+        g_sink += static_cast<uint64_t>(box.GetVolume());
+    });
+    Report("huge region walk", regionTimer.ElapsedMs(), hugeVoxels);
+    std::cout << "  " << regions << " solid regions" << std::endl;
+}
+
+int main() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "      WORLD STORAGE BENCHMARKS" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    BenchLayouts(36);
+    BenchLayouts(128);
+    BenchWorld();
+    BenchFrustum(3, 3, 3);
+    BenchFrustum(32, 4, 32);
+    BenchPopulate(36);
+    BenchPopulate(64);
+    BenchEcsModes(36);
+    BenchEcsModes(64);
+    BenchPipeline(128, 4.0);
+    BenchStatistics(36);
+    BenchStatistics(128);
+    BenchSampler(128);
+    BenchTerrain(128);
+    BenchTerrain(256);
+    BenchHeights(256);
+    BenchSaveLoad(256);
+    BenchDeltaSave(256);
+    BenchAutoSave(256);
+    BenchColumnStore(256);
+    BenchVoxelOctree(256, 4096);
+
+    std::cout << "\n(checksum " << g_sink << ")" << std::endl;
+    return 0;
+}
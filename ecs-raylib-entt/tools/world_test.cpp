@@ -1,17 +1,49 @@
 #include "../src/world/World.hpp"
+#include "../src/world/AutoSaver.hpp"
+#include "../src/world/ChunkMesher.hpp"
+#include "../src/world/ColumnStore.hpp"
+#include "../src/world/MpscQueue.hpp"
+#include "../src/world/VoxelOctree.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
-// Test that surface layers contain only Soil and Stone
+// Check the solid cube's rule: shell blocks (within SURFACE_LAYER_COUNT of
+// any face) are Soil or Stone, interior blocks never Soil
+void CheckShellRule(const World::World& world) {
+    for (int y = 0; y < world.GetHeight(); ++y) {
+        for (int z = 0; z < world.GetDepth(); ++z) {
+            for (int x = 0; x < world.GetWidth(); ++x) {
+                World::BlockType type = world.GetBlockType(x, y, z);
+                if (world.IsExposedSurface(x, y, z)) {
+                    assert(type == World::BlockType::Soil || type == World::BlockType::Stone);
+                } else {
+                    assert(type == World::BlockType::Stone || type == World::BlockType::Gold ||
+                           type == World::BlockType::Silver);
+                }
+            }
+        }
+    }
+}
+
+// Test that the surface shell contains only Soil and Stone
 void TestSurfaceLayers() {
     std::cout << "Testing Surface Layers..." << std::endl;
     
     World::World world;
     world.Generate();
     
-    for (int y = 0; y < 3; ++y) {
+    for (int y = 0; y < world.GetHeight(); ++y) {
         for (int z = 0; z < world.GetDepth(); ++z) {
             for (int x = 0; x < world.GetWidth(); ++x) {
+                if (!world.IsExposedSurface(x, y, z)) continue;
                 const World::Block& block = world.GetBlock(x, y, z);
                 assert(block.type == World::BlockType::Soil || 
                        block.type == World::BlockType::Stone);
@@ -22,26 +54,31 @@ void TestSurfaceLayers() {
     std::cout << "✓ Surface layers contain only Soil and Stone" << std::endl;
 }
 
-// Test that underground layers contain no Soil
+// Test that the interior below the shell contains no Soil
 void TestUndergroundLayers() {
     std::cout << "Testing Underground Layers..." << std::endl;
     
     World::World world;
     world.Generate();
     
-    for (int y = 3; y < world.GetHeight(); ++y) {
+    int interior = 0;
+    for (int y = 0; y < world.GetHeight(); ++y) {
         for (int z = 0; z < world.GetDepth(); ++z) {
             for (int x = 0; x < world.GetWidth(); ++x) {
+                if (world.IsExposedSurface(x, y, z)) continue;
                 const World::Block& block = world.GetBlock(x, y, z);
                 assert(block.type != World::BlockType::Soil);
+                ++interior;
             }
         }
     }
+    int inner = world.GetWidth() - 2 * World::SURFACE_LAYER_COUNT;
+    assert(interior == inner * inner * inner);
     
     std::cout << "✓ Underground layers contain no Soil" << std::endl;
 }
 
-// Test surface layer distribution (should be approximately 80/20)
+// Test surface shell distribution (should be approximately 80/20)
 void TestSurfaceDistribution() {
     std::cout << "Testing Surface Distribution..." << std::endl;
     
@@ -50,11 +87,13 @@ void TestSurfaceDistribution() {
     
     int soilCount = 0;
     int stoneCount = 0;
-    int surfaceBlocks = world.GetWidth() * world.GetDepth() * 3;
+    int surfaceBlocks = 0;
     
-    for (int y = 0; y < 3; ++y) {
+    for (int y = 0; y < world.GetHeight(); ++y) {
         for (int z = 0; z < world.GetDepth(); ++z) {
             for (int x = 0; x < world.GetWidth(); ++x) {
+                if (!world.IsExposedSurface(x, y, z)) continue;
+                ++surfaceBlocks;
                 const World::Block& block = world.GetBlock(x, y, z);
                 if (block.type == World::BlockType::Soil) {
                     soilCount++;
@@ -64,6 +103,7 @@ void TestSurfaceDistribution() {
             }
         }
     }
+    assert(soilCount + stoneCount == surfaceBlocks);
     
     double soilPercentage = (soilCount * 100.0) / surfaceBlocks;
     double stonePercentage = (stoneCount * 100.0) / surfaceBlocks;
@@ -107,16 +147,27 @@ void TestLayerIdentification() {
     std::cout << "Testing Layer Identification..." << std::endl;
     
     World::World world;
+    const int layers = World::SURFACE_LAYER_COUNT;
+    const int last = world.GetHeight() - 1;
     
     // Surface layers
-    assert(world.IsSurfaceLayer(0));
-    assert(world.IsSurfaceLayer(1));
-    assert(world.IsSurfaceLayer(2));
+    for (int y = 0; y < layers; ++y) {
+        assert(world.IsSurfaceLayer(y));
+    }
     
     // Underground layers
-    assert(!world.IsSurfaceLayer(3));
+    assert(!world.IsSurfaceLayer(layers));
     assert(!world.IsSurfaceLayer(10));
-    assert(!world.IsSurfaceLayer(35));
+    assert(!world.IsSurfaceLayer(last));
+    
+    // The shell is SURFACE_LAYER_COUNT deep on all six faces
+    int mid = world.GetWidth() / 2;
+    assert(world.IsExposedSurface(mid, layers - 1, mid) && !world.IsExposedSurface(mid, layers, mid));
+    assert(world.IsExposedSurface(mid, last - layers + 1, mid) && !world.IsExposedSurface(mid, last - layers, mid));
+    assert(world.IsExposedSurface(layers - 1, mid, mid) && !world.IsExposedSurface(layers, mid, mid));
+    assert(world.IsExposedSurface(last - layers + 1, mid, mid) && !world.IsExposedSurface(last - layers, mid, mid));
+    assert(world.IsExposedSurface(mid, mid, layers - 1) && !world.IsExposedSurface(mid, mid, layers));
+    assert(world.IsExposedSurface(mid, mid, last - layers + 1) && !world.IsExposedSurface(mid, mid, last - layers));
     
     std::cout << "✓ Layer identification working correctly" << std::endl;
 }
@@ -133,6 +184,13 @@ void TestBlockColors() {
     assert(soil.color.r == BROWN.r && soil.color.g == BROWN.g && soil.color.b == BROWN.b);
     assert(stone.color.r == GRAY.r && stone.color.g == GRAY.g && stone.color.b == GRAY.b);
     assert(gold.color.r == GOLD.r && gold.color.g == GOLD.g && gold.color.b == GOLD.b);
+    assert(silver.color.r == 192 && silver.color.g == 192 && silver.color.b == 192);
+    
+    // Names and colors resolve through the properties table without allocating
+    assert(std::string(soil.GetName()) == "Soil");
+    assert(std::string(World::Block::GetTypeName(World::BlockType::Silver)) == "Silver");
+    static_assert(sizeof(World::BlockType) == 1, "grid stores one byte per voxel");
+    static_assert(World::Block::GetColorFromType(World::BlockType::Gold).r == GOLD.r, "constexpr lookup");
     
     std::cout << "✓ Block colors match their types" << std::endl;
 }
@@ -150,6 +208,138 @@ void TestWorldDimensions() {
     std::cout << "✓ World dimensions are correct (36x36x36)" << std::endl;
 }
 
+// Test chunked storage with a non-default, non-chunk-aligned world size
+void TestChunkedStorage() {
+    std::cout << "Testing Chunked Storage..." << std::endl;
+    
+    World::World world(100, 20, 70);
+    assert(world.GetWidth() == 100 && world.GetHeight() == 20 && world.GetDepth() == 70);
+    assert(world.IsValidPosition(99, 19, 69));
+    assert(!world.IsValidPosition(100, 0, 0));
+    assert(!world.IsValidPosition(0, 20, 0));
+    
+    // A fresh world allocates nothing and reads as air
+    assert(world.GetChunkCount() == 0);
+    assert(world.GetBlock(50, 10, 30).type == World::BlockType::Air);
+    assert(world.IsAir(50, 10, 30));
+    
+    // Writing air into empty space does not allocate
+    world.SetBlock(5, 5, 5, World::Block(World::BlockType::Air));
+    assert(world.GetChunkCount() == 0);
+    
+    // Writes on both sides of a chunk boundary land in different chunks
+    int edge = World::CHUNK_SIZE;
+    world.SetBlock(edge - 1, 3, 3, World::Block(World::BlockType::Gold));
+    world.SetBlock(edge, 3, 3, World::Block(World::BlockType::Silver));
+    assert(world.GetBlock(edge - 1, 3, 3).type == World::BlockType::Gold);
+    assert(world.GetBlock(edge, 3, 3).type == World::BlockType::Silver);
+    assert(world.GetBlock(edge + 1, 3, 3).type == World::BlockType::Air);
+    assert(world.GetChunkCount() == 2);
+    
+    // Out-of-bounds writes are ignored
+    world.SetBlock(-1, 0, 0, World::Block(World::BlockType::Gold));
+    world.SetBlock(100, 0, 0, World::Block(World::BlockType::Gold));
+    assert(world.GetChunkCount() == 2);
+    
+    // Generation covers the partial chunks at the far edges
+    world.Generate();
+    for (int y = 0; y < world.GetHeight(); ++y) {
+        for (int z = 0; z < world.GetDepth(); ++z) {
+            for (int x = 0; x < world.GetWidth(); ++x) {
+                assert(!world.IsAir(x, y, z));
+            }
+        }
+    }
+    
+    world.Clear();
+    assert(world.GetChunkCount() == 0);
+    
+    std::cout << "✓ Chunked storage handles bounds, sparse chunks and chunk edges" << std::endl;
+}
+
+// Test that single-type chunks are stored as one value
+void TestUniformChunks() {
+    std::cout << "Testing Uniform Chunks..." << std::endl;
+    
+    World::Chunk chunk(World::BlockType::Stone);
+    assert(chunk.IsUniform());
+    assert(chunk.GetBitsPerVoxel() == 0);
+    assert(chunk.Get(1, 1, 1) == World::BlockType::Stone);
+    
+    // Writing the same type keeps it uniform
+    chunk.Set(1, 1, 1, World::BlockType::Stone);
+    assert(chunk.IsUniform());
+    
+    // A different type expands it
+    chunk.Set(1, 1, 1, World::BlockType::Gold);
+    assert(!chunk.IsUniform());
+    assert(chunk.Get(1, 1, 1) == World::BlockType::Gold);
+    assert(chunk.Get(0, 0, 0) == World::BlockType::Stone);
+    assert(!chunk.Compact());
+    
+    // Restoring it lets Compact() collapse the chunk again
+    chunk.Set(1, 1, 1, World::BlockType::Stone);
+    assert(chunk.Compact());
+    assert(chunk.IsUniform());
+    assert(chunk.GetUniformType() == World::BlockType::Stone);
+    
+    std::cout << "✓ Uniform chunks store a single value" << std::endl;
+}
+
+// Test that palette indices widen 1 -> 2 -> 4 -> 8 bits as types arrive
+void TestPaletteCompression() {
+    std::cout << "Testing Palette Compression..." << std::endl;
+    
+    World::Chunk chunk(World::BlockType::Air);
+    std::vector<World::BlockType> expected(World::CHUNK_VOLUME, World::BlockType::Air);
+    
+    // Write up to 40 distinct type values (the chunk only sees bytes), one
+    // per voxel, as many as the chunk holds next to one air voxel
+    const int S = World::CHUNK_SIZE;
+    const int typeCount = std::min(40, World::CHUNK_VOLUME - 1);
+    auto widthFor = [](int paletteSize) { return paletteSize <= 2 ? 1 : paletteSize <= 4 ? 2 : paletteSize <= 16 ? 4 : 8; };
+    auto at = [&](int t) { return std::array<int, 3>{ t % S, t / S % S, t / (S * S) }; };
+    for (int t = 1; t <= typeCount; ++t) {
+        auto type = static_cast<World::BlockType>(t + 10);
+        auto [lx, ly, lz] = at(t);
+        chunk.Set(lx, ly, lz, type);
+        expected[World::LocalIndex(lx, ly, lz)] = type;
+        
+        assert(chunk.GetPaletteSize() == t + 1);
+        assert(chunk.GetBitsPerVoxel() == widthFor(t + 1));
+    }
+    
+    // Every voxel survived each repack
+    std::vector<World::BlockType> decoded(World::CHUNK_VOLUME);
+    chunk.Decode(decoded.data());
+    assert(decoded == expected);
+    
+    // Overwriting most types and compacting narrows the index width again
+    for (int t = 3; t <= typeCount; ++t) {
+        auto [lx, ly, lz] = at(t);
+        chunk.Set(lx, ly, lz, World::BlockType::Air);
+    }
+    assert(chunk.GetBitsPerVoxel() == widthFor(typeCount + 1));
+    chunk.Compact();
+    assert(chunk.GetPaletteSize() == 3);
+    assert(chunk.GetBitsPerVoxel() == 2);
+    auto get = [&](int t) { auto [lx, ly, lz] = at(t); return chunk.Get(lx, ly, lz); };
+    assert(get(1) == static_cast<World::BlockType>(11));
+    assert(get(2) == static_cast<World::BlockType>(12));
+    assert(get(3) == World::BlockType::Air);
+    
+    // A generated world keeps its blocks and uses well under a byte per voxel,
+    // plus each chunk's bookkeeping (which dominates in tiny chunks)
+    World::World world(64, 64, 64);
+    world.Generate();
+    double bytesPerVoxel = world.GetMemoryUsage() * 1.0 / (64 * 64 * 64);
+    double chunkOverhead = 2.0 * (sizeof(World::ChunkCoord) + sizeof(World::Chunk)) / World::CHUNK_VOLUME;
+    std::cout << "  Generated world: " << bytesPerVoxel << " bytes/voxel" << std::endl;
+    assert(bytesPerVoxel < 0.5 + chunkOverhead);
+    
+    std::cout << "✓ Palette widens and compacts without losing blocks" << std::endl;
+}
+
 // Run multiple generations to test consistency
 void TestMultipleGenerations() {
     std::cout << "Testing Multiple Generations..." << std::endl;
@@ -160,27 +350,1248 @@ void TestMultipleGenerations() {
         world.Generate();
         
         // Verify rules still hold
-        for (int y = 0; y < 3; ++y) {
-            for (int z = 0; z < world.GetDepth(); ++z) {
-                for (int x = 0; x < world.GetWidth(); ++x) {
-                    const World::Block& block = world.GetBlock(x, y, z);
-                    assert(block.type == World::BlockType::Soil || 
-                           block.type == World::BlockType::Stone);
-                }
+        CheckShellRule(world);
+    }
+    
+    std::cout << "✓ Multiple generations maintain rule consistency" << std::endl;
+}
+
+// Test that a seed gives the same world whatever the thread count
+void TestDeterministicGeneration() {
+    std::cout << "Testing Deterministic Generation..." << std::endl;
+    
+    // Bounds that leave partial chunks on every axis
+    int w = 2 * World::CHUNK_SIZE + 5, h = World::CHUNK_SIZE + 3, d = 3 * World::CHUNK_SIZE - 1;
+    World::World single(w, h, d);
+    single.Generate(42, 1);
+    assert(single.GetSeed() == 42);
+    
+    auto sameBlocks = [&](const World::World& a, const World::World& b) {
+        for (int y = 0; y < h; ++y)
+            for (int z = 0; z < d; ++z)
+                for (int x = 0; x < w; ++x)
+                    if (a.GetBlockType(x, y, z) != b.GetBlockType(x, y, z)) return false;
+        return true;
+    };
+    
+    for (int threads : { 2, 3, 8, 64 }) {
+        World::World parallel(w, h, d);
+        parallel.Generate(42, threads);
+        assert(sameBlocks(single, parallel));
+        assert(parallel.GetChunkCount() == single.GetChunkCount());
+    }
+    
+    // Regenerating with the same seed repeats the world; another seed does not
+    World::World other(w, h, d);
+    other.Generate(43, 4);
+    assert(!sameBlocks(single, other));
+    other.Generate(42, 4);
+    assert(sameBlocks(single, other));
+    
+    std::cout << "✓ Same seed, same world with 1 to 64 threads" << std::endl;
+}
+
+// Test that the seed alone reproduces any block or chunk
+void TestSeededRegeneration() {
+    std::cout << "Testing Seeded Regeneration..." << std::endl;
+    
+    int w = 2 * World::CHUNK_SIZE + 5, h = World::CHUNK_SIZE + 3, d = 2 * World::CHUNK_SIZE;
+    World::World world(w, h, d, 1234);
+    assert(world.GetSeed() == 1234);
+    world.Generate();
+    
+    // The constructor seed and Generate(seed) agree
+    World::World same(w, h, d);
+    same.Generate(1234);
+    assert(same.GetSeed() == 1234);
+    
+    // Every block is what GenerateBlock says, without generating anything
+    World::World empty(w, h, d, 1234);
+    for (int y = 0; y < h; ++y)
+        for (int z = 0; z < d; ++z)
+            for (int x = 0; x < w; ++x) {
+                assert(world.GetBlockType(x, y, z) == empty.GenerateBlock(x, y, z));
+                assert(same.GetBlockType(x, y, z) == world.GetBlockType(x, y, z));
+            }
+    assert(empty.GetChunkCount() == 0);
+    assert(empty.GenerateBlock(-1, 0, 0) == World::BlockType::Air);
+    
+    // One chunk on demand
+    World::ChunkCoord coord = { 1, 0, 1 };
+    empty.RegenerateChunk(coord);
+    assert(empty.GetChunkCount() == 1);
+    for (int y = 0; y < World::CHUNK_SIZE; ++y)
+        for (int z = 0; z < World::CHUNK_SIZE; ++z)
+            for (int x = 0; x < World::CHUNK_SIZE; ++x) {
+                int wx = World::CHUNK_SIZE + x, wz = World::CHUNK_SIZE + z;
+                assert(empty.GetBlockType(wx, y, wz) == world.GetBlockType(wx, y, wz));
+            }
+    
+    // Regenerating undoes edits and moves revisions on, neighbours included
+    world.SetBlock(3, 2, 1, World::Block(World::BlockType::Air));
+    world.RegenerateBlock(3, 2, 1);
+    assert(world.GetBlockType(3, 2, 1) == empty.GenerateBlock(3, 2, 1));
+    
+    // A row across chunk (1, 0, 0)
+    int cx = World::CHUNK_SIZE;
+    for (int x = cx; x < 2 * cx; ++x) world.SetBlock(x, 1, 1, World::Block(World::BlockType::Air));
+    uint64_t before = world.GetChunkRevision(coord);
+    uint64_t neighbourBefore = world.GetChunkRevision({ 0, 0, 1 });
+    world.RegenerateChunk({ 1, 0, 0 });
+    world.RegenerateChunk(coord);
+    assert(world.GetChunkRevision(coord) != before);
+    assert(world.GetChunkRevision({ 0, 0, 1 }) != neighbourBefore);
+    for (int x = cx; x < 2 * cx; ++x) assert(world.GetBlockType(x, 1, 1) == empty.GenerateBlock(x, 1, 1));
+    
+    // Without a seed, each world gets its own
+    World::World a, b;
+    assert(a.GetSeed() != b.GetSeed());
+    
+    std::cout << "✓ Blocks and chunks regenerate from (seed, coordinates)" << std::endl;
+}
+
+// Test that a lazy world reads like a generated one and only keeps the
+// chunks it was asked for
+void TestLazyGeneration() {
+    std::cout << "Testing Lazy Generation..." << std::endl;
+    
+    // Huge worlds cost nothing up front
+    World::World huge(1 << 16, 64, 1 << 16, 99);
+    huge.GenerateLazily();
+    assert(huge.IsLazy() && huge.GetChunkCount() == 0);
+    assert(huge.GetSurfaceLevel(40000, 50000) == 63);
+    assert(huge.GetBlockType(40000, 10, 50000) == huge.GenerateBlock(40000, 10, 50000));
+    assert(huge.GetChunkCount() == 0);
+    
+    int cs = World::CHUNK_SIZE;
+    int w = 3 * cs, h = 2 * cs, d = 3 * cs;
+    World::World eager(w, h, d, 7);
+    eager.Generate();
+    World::World lazy(w, h, d, 7);
+    lazy.GenerateLazily();
+    for (int y = 0; y < h; ++y)
+        for (int z = 0; z < d; ++z)
+            for (int x = 0; x < w; ++x)
+                assert(lazy.GetBlockType(x, y, z) == eager.GetBlockType(x, y, z));
+    assert(lazy.GetChunkCount() == 0);
+    
+    // Loading materialises exactly one chunk
+    uint64_t layout = lazy.GetChunkLayoutRevision();
+    const World::Chunk* chunk = lazy.LoadChunk({ 1, 1, 2 });
+    assert(chunk && lazy.GetChunkCount() == 1);
+    assert(lazy.GetChunkLayoutRevision() != layout);
+    assert(lazy.LoadChunk({ 1, 1, 2 }) == chunk);
+    assert(lazy.LoadChunk({ 3, 0, 0 }) == nullptr);
+    std::vector<World::BlockType> a(World::CHUNK_VOLUME), b(World::CHUNK_VOLUME);
+    chunk->Decode(a.data());
+    eager.GetChunk({ 1, 1, 2 })->Decode(b.data());
+    assert(a == b);
+    
+    // Edits load their chunk and pin it; clean chunks go back to the generator
+    lazy.SetBlock(1, 1, 1, World::Block(World::BlockType::Air));
+    assert(lazy.GetChunkCount() == 2 && lazy.IsChunkModified({ 0, 0, 0 }));
+    assert(!lazy.UnloadChunk({ 0, 0, 0 }));
+    assert(lazy.UnloadChunk({ 1, 1, 2 }));
+    assert(!lazy.UnloadChunk({ 1, 1, 2 }));
+    assert(lazy.GetChunkCount() == 1);
+    assert(lazy.IsAir(1, 1, 1));
+    assert(lazy.GetBlockType(cs + 3, cs + 3, 2 * cs + 3) == eager.GetBlockType(cs + 3, cs + 3, 2 * cs + 3));
+    
+    // Regenerating a chunk makes it clean again
+    lazy.RegenerateChunk({ 0, 0, 0 });
+    assert(!lazy.IsChunkModified({ 0, 0, 0 }));
+    assert(lazy.UnloadChunk({ 0, 0, 0 }));
+    assert(lazy.GetChunkCount() == 0);
+    
+    // Eager worlds never drop chunks
+    assert(!eager.IsLazy() && !eager.UnloadChunk({ 0, 0, 0 }));
+    assert(eager.LoadChunk({ 0, 0, 0 }) == eager.GetChunk({ 0, 0, 0 }));
+    
+    std::cout << "✓ Lazy chunks match eager generation; only edited chunks stay pinned" << std::endl;
+}
+
+// Test that the MPSC queue delivers every push once, in order per producer
+void TestMpscQueue() {
+    std::cout << "Testing MPSC Queue..." << std::endl;
+    
+    World::MpscQueue<std::pair<int, int>> queue;
+    std::pair<int, int> item;
+    assert(!queue.TryPop(item) && queue.Size() == 0);
+    
+    const int producers = 4, perProducer = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < perProducer; ++i) queue.Push({ p, i });
+        });
+    }
+    
+    // Consume while the producers run
+    std::vector<int> next(producers, 0);
+    int popped = 0;
+    while (popped < producers * perProducer) {
+        if (!queue.TryPop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        assert(item.second == next[item.first]);
+        ++next[item.first];
+        ++popped;
+    }
+    for (std::thread& thread : threads) thread.join();
+    assert(!queue.TryPop(item) && queue.Size() == 0);
+    
+    // Items left behind are freed with the queue
+    World::MpscQueue<std::vector<int>> leftover;
+    leftover.Push(std::vector<int>(100, 1));
+    assert(leftover.Size() == 1);
+    
+    std::cout << "✓ " << popped << " items from " << producers << " producers, in order per producer" << std::endl;
+}
+
+// Test that the SIMD statistics match counting block by block
+void TestBlockStatistics() {
+    std::cout << "Testing Block Statistics..." << std::endl;
+    
+    const World::SimdLevel levels[] = { World::SimdLevel::Scalar, World::SimdLevel::SSE2, World::SimdLevel::AVX2 };
+    
+    // Kernels: every length and alignment around the vector widths, and
+    // runs long enough to fold the byte accumulators
+    World::VoxelRandom random(3);
+    std::vector<World::BlockType> types(20000);
+    for (size_t i = 0; i < types.size(); ++i) {
+        types[i] = static_cast<World::BlockType>(random.Below(static_cast<int>(i), 0, 0, World::BLOCK_TYPE_COUNT));
+    }
+    std::vector<size_t> lengths;
+    for (size_t n = 0; n <= 70; ++n) lengths.push_back(n);
+    lengths.push_back(255 * 32 + 17);
+    lengths.push_back(19000);
+    for (size_t offset = 0; offset < 3; ++offset) {
+        for (size_t n : lengths) {
+            uint64_t expected[World::BLOCK_TYPE_COUNT] = {};
+            for (size_t i = 0; i < n; ++i) expected[static_cast<int>(types[offset + i])]++;
+            for (World::SimdLevel level : levels) {
+                uint64_t counts[World::BLOCK_TYPE_COUNT] = {};
+                World::CountBlockTypes(types.data() + offset, n, counts, level);
+                for (int t = 0; t < World::BLOCK_TYPE_COUNT; ++t) assert(counts[t] == expected[t]);
             }
         }
+    }
+    
+    // Whole world with ragged chunk edges and some air
+    World::World world(37, 21, 40, 8);
+    world.Generate();
+    for (int i = 0; i < 30; ++i) world.SetBlock(i, 10, i, World::Block(World::BlockType::Air));
+    
+    World::TypeCounts counts{}, shell{}, interior{};
+    std::vector<World::TypeCounts> layers(world.GetHeight());
+    for (int y = 0; y < world.GetHeight(); ++y)
+        for (int z = 0; z < world.GetDepth(); ++z)
+            for (int x = 0; x < world.GetWidth(); ++x) {
+                int t = static_cast<int>(world.GetBlockType(x, y, z));
+                counts[t]++;
+                layers[y][t]++;
+                (world.IsExposedSurface(x, y, z) ? shell : interior)[t]++;
+            }
+    
+    for (World::SimdLevel level : levels) {
+        World::BlockStatistics stats = world.ComputeStatistics(level);
+        assert(stats.counts == counts && stats.shellCounts == shell && stats.interiorCounts == interior);
+        assert(stats.layerCounts == layers);
+        assert(stats.GetTotal() == 37u * 21u * 40u);
+        assert(stats.GetSolid() + counts[static_cast<int>(World::BlockType::Air)] == stats.GetTotal());
+    }
+    
+    // Lazy worlds count what they would generate
+    World::World lazy(37, 21, 40, 8);
+    lazy.GenerateLazily();
+    World::World eager(37, 21, 40, 8);
+    eager.Generate();
+    assert(lazy.ComputeStatistics().layerCounts == eager.ComputeStatistics().layerCounts);
+    assert(lazy.GetChunkCount() == 0);
+    
+    std::cout << "✓ Scalar, SSE2 and AVX2 counts match (running "
+              << World::GetSimdLevelName(World::DetectSimdLevel()) << ")" << std::endl;
+}
+
+// Test that row spans give the same shell as the six face distances
+void TestInteriorSpans() {
+    std::cout << "Testing Interior Spans..." << std::endl;
+    
+    auto inShell = [](const World::World& world, int x, int y, int z) {
+        int n = World::SURFACE_LAYER_COUNT;
+        return x < n || y < n || z < n ||
+               x >= world.GetWidth() - n || y >= world.GetHeight() - n || z >= world.GetDepth() - n;
+    };
+    
+    // Thin worlds have no interior at all; ragged ones split rows mid-chunk
+    int sizes[][3] = { { 5, 5, 5 }, { 8, 9, 8 }, { 9, 9, 9 }, { 37, 21, 40 }, { 16, 16, 16 } };
+    for (auto& size : sizes) {
+        World::World world(size[0], size[1], size[2], 11);
+        for (int y = -1; y <= world.GetHeight(); ++y)
+            for (int z = -1; z <= world.GetDepth(); ++z) {
+                World::RowSpan interior = world.GetInteriorSpan(y, z);
+                int count = 0;
+                for (int x = -1; x <= world.GetWidth(); ++x) {
+                    assert(interior.Contains(x) == !inShell(world, x, y, z));
+                    assert(world.IsExposedSurface(x, y, z) == inShell(world, x, y, z));
+                    count += interior.Contains(x);
+                }
+                assert(interior.Size() == count);
+            }
         
-        for (int y = 3; y < world.GetHeight(); ++y) {
-            for (int z = 0; z < world.GetDepth(); ++z) {
-                for (int x = 0; x < world.GetWidth(); ++x) {
-                    const World::Block& block = world.GetBlock(x, y, z);
-                    assert(block.type != World::BlockType::Soil);
+        // Row-filled chunks match the per-block generator
+        std::vector<World::BlockType> types(World::CHUNK_VOLUME);
+        for (int cy = 0; cy < world.GetChunksY(); ++cy)
+            for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+                for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                    world.GenerateChunkTypes({ cx, cy, cz }, types.data());
+                    for (int ly = 0; ly < World::CHUNK_SIZE; ++ly)
+                        for (int lz = 0; lz < World::CHUNK_SIZE; ++lz)
+                            for (int lx = 0; lx < World::CHUNK_SIZE; ++lx) {
+                                int x = (cx << World::CHUNK_SHIFT) + lx;
+                                int y = (cy << World::CHUNK_SHIFT) + ly;
+                                int z = (cz << World::CHUNK_SHIFT) + lz;
+                                assert(types[World::LocalIndex(lx, ly, lz)] == world.GenerateBlock(x, y, z));
+                            }
+                }
+    }
+    
+    std::cout << "✓ Row spans match the shell and generate the same blocks" << std::endl;
+}
+
+// Test that batched row sampling matches drawing one voxel at a time
+void TestBlockSampler() {
+    std::cout << "Testing Block Sampler..." << std::endl;
+    
+    const World::BlockSampler& surface = World::World::GetSurfaceSampler();
+    const World::BlockSampler& underground = World::World::GetUndergroundSampler();
+    assert(surface.GetRange() == 100 && underground.GetRange() == 100);
+    assert(surface.FromRoll(79) == World::BlockType::Soil && surface.FromRoll(80) == World::BlockType::Stone);
+    assert(underground.FromRoll(69) == World::BlockType::Stone && underground.FromRoll(70) == World::BlockType::Gold);
+    assert(underground.FromRoll(89) == World::BlockType::Gold && underground.FromRoll(90) == World::BlockType::Silver);
+    
+    // Every level, odd starts (negative too) and lengths around the batch
+    // and vector widths
+    const World::SimdLevel levels[] = { World::SimdLevel::Scalar, World::SimdLevel::SSE2, World::SimdLevel::AVX2 };
+    std::vector<World::BlockType> row(300);
+    for (uint64_t seed : { 0ull, 5ull, 0xFFFFFFFFFFFFull }) {
+        World::RowRandom random(seed, 7, -3);
+        for (int begin : { -20, 0, 3 }) {
+            for (int length : { 0, 1, 3, 4, 7, 8, 9, 16, 63, 64, 65, 200 }) {
+                for (World::SimdLevel level : levels) {
+                    underground.SampleRow(random, begin, begin + length, row.data(), level);
+                    for (int i = 0; i < length; ++i) assert(row[i] == underground.Sample(random, begin + i));
                 }
             }
         }
     }
     
-    std::cout << "✓ Multiple generations maintain rule consistency" << std::endl;
+    // Counts follow the weights over many rows
+    int counts[World::BLOCK_TYPE_COUNT] = {};
+    const int rows = 2000, width = 100;
+    for (int z = 0; z < rows; ++z) {
+        surface.SampleRow(World::RowRandom(9, 0, z), 0, width, row.data());
+        for (int x = 0; x < width; ++x) counts[static_cast<int>(row[x])]++;
+    }
+    double soil = 100.0 * counts[static_cast<int>(World::BlockType::Soil)] / (rows * width);
+    assert(soil > 79.0 && soil < 81.0);
+    
+    std::cout << "✓ Batched rows match single draws (soil " << soil << "%)" << std::endl;
+}
+
+// Test noise terrain: layering, caves and ores, rules, and that every path
+// (single blocks, chunks, lazy, threads) generates the same world
+void TestTerrainGeneration() {
+    std::cout << "Testing Terrain Generation..." << std::endl;
+    
+    World::World cube(20, 20, 20, 1);
+    assert(cube.GetGeneratorMode() == World::GeneratorMode::SolidCube);
+    
+    // Ragged bounds so chunks are cut on every axis
+    int w = 70, h = 60, d = 50;
+    World::World world(w, h, d, 31);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate(31, 1);
+    const World::TerrainRules& rules = world.GetTerrainRules();
+    
+    // Chunks match single blocks, and threads and lazy loading change nothing
+    for (int y = 0; y < h; ++y)
+        for (int z = 0; z < d; ++z)
+            for (int x = 0; x < w; ++x)
+                assert(world.GetBlockType(x, y, z) == world.GenerateBlock(x, y, z));
+    World::World parallel(w, h, d);
+    parallel.SetGeneratorMode(World::GeneratorMode::Terrain);
+    parallel.Generate(31, 4);
+    World::World lazy(w, h, d, 31);
+    lazy.SetGeneratorMode(World::GeneratorMode::Terrain);
+    lazy.GenerateLazily();
+    for (int y = 0; y < h; ++y)
+        for (int z = 0; z < d; ++z)
+            for (int x = 0; x < w; ++x) {
+                assert(parallel.GetBlockType(x, y, z) == world.GetBlockType(x, y, z));
+                assert(lazy.GetBlockType(x, y, z) == world.GetBlockType(x, y, z));
+            }
+    
+    // Columns: air above the surface, then soil, then stone with caves
+    // and ores; the surface varies across the world
+    int lowest = h, highest = 0;
+    size_t caveAir = 0;
+    for (int z = 0; z < d; ++z) {
+        for (int x = 0; x < w; ++x) {
+            int surface = world.GetSurfaceLevel(x, z);
+            lowest = std::min(lowest, surface);
+            highest = std::max(highest, surface);
+            for (int y = surface + 1; y < h; ++y) assert(world.GetBlockType(x, y, z) == World::BlockType::Air);
+            for (int y = surface; y >= 0; --y) {
+                World::BlockType type = world.GetBlockType(x, y, z);
+                int depth = surface - y;
+                if (depth < rules.soilDepth) {
+                    assert(type == World::BlockType::Soil);
+                } else {
+                    assert(type != World::BlockType::Soil);
+                    if (type == World::BlockType::Air) {
+                        assert(depth >= rules.caveRoof);
+                        ++caveAir;
+                    }
+                }
+            }
+        }
+    }
+    assert(highest - lowest >= 5);
+    World::BlockStatistics stats = world.ComputeStatistics();
+    assert(caveAir > 0);
+    assert(stats.counts[static_cast<int>(World::BlockType::Gold)] > 0);
+    assert(stats.counts[static_cast<int>(World::BlockType::Silver)] > 0);
+    
+    // Rules: no caves and no ores leaves plain soil over stone
+    World::TerrainRules plain = rules;
+    plain.caveThreshold = 1.0f;
+    plain.ores.clear();
+    world.SetTerrainRules(plain);
+    world.Generate();
+    stats = world.ComputeStatistics();
+    assert(stats.counts[static_cast<int>(World::BlockType::Gold)] == 0);
+    assert(stats.counts[static_cast<int>(World::BlockType::Silver)] == 0);
+    for (int z = 0; z < d; ++z)
+        for (int x = 0; x < w; ++x)
+            for (int y = world.GetSurfaceLevel(x, z); y >= 0; --y) assert(!world.IsAir(x, y, z));
+    
+    // Back to the solid cube
+    world.SetGeneratorMode(World::GeneratorMode::SolidCube);
+    world.Generate();
+    assert(world.GetSurfaceLevel(5, 5) == h - 1);
+    
+    std::cout << "✓ Terrain from " << lowest << " to " << highest << ", "
+              << caveAir << " blocks of caves, same world on every path" << std::endl;
+}
+
+// Top solid block of a column by scanning it, for checking the cache
+int ScanColumnHeight(const World::World& world, int x, int z) {
+    for (int y = world.GetHeight() - 1; y >= 0; --y) {
+        if (!world.IsAir(x, y, z)) return y;
+    }
+    return -1;
+}
+
+// Every cached height and chunk column range matches a full scan
+void CheckColumnHeights(const World::World& world) {
+    for (int cz = 0; cz < world.GetChunksZ(); ++cz) {
+        for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+            World::HeightRange expected{ world.GetHeight(), -1 };
+            for (int z = cz * World::CHUNK_SIZE; z < std::min((cz + 1) * World::CHUNK_SIZE, world.GetDepth()); ++z) {
+                for (int x = cx * World::CHUNK_SIZE; x < std::min((cx + 1) * World::CHUNK_SIZE, world.GetWidth()); ++x) {
+                    int top = ScanColumnHeight(world, x, z);
+                    assert(world.GetColumnHeight(x, z) == top);
+                    assert(world.GetSurfaceLevel(x, z) == std::max(top, 0));
+                    expected.lowest = std::min(expected.lowest, top);
+                    expected.highest = std::max(expected.highest, top);
+                }
+            }
+            World::HeightRange range = world.GetChunkColumnHeights(cx, cz);
+            assert(range.lowest == expected.lowest && range.highest == expected.highest);
+        }
+    }
+}
+
+void TestColumnHeights() {
+    std::cout << "Testing Column Heights..." << std::endl;
+    
+    // Solid cube, eager terrain and lazy terrain (ungenerated chunks come
+    // from the generator without being made resident)
+    int w = 70, h = 60, d = 50;
+    World::World cube(w, h, d, 5);
+    cube.Generate();
+    CheckColumnHeights(cube);
+    assert(cube.GetChunkColumnHeights(0, 0).lowest == h - 1);
+    World::World world(w, h, d, 31);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.Generate();
+    CheckColumnHeights(world);
+    World::World lazy(w, h, d, 31);
+    lazy.SetGeneratorMode(World::GeneratorMode::Terrain);
+    lazy.GenerateLazily();
+    CheckColumnHeights(lazy);
+    assert(lazy.GetChunkCount() == 0);
+    
+    // Out of bounds
+    assert(world.GetColumnHeight(-1, 0) == -1 && world.GetColumnHeight(0, d) == -1);
+    assert(world.GetChunkColumnHeights(-1, 0).highest == -1);
+    assert(world.GetChunkColumnHeights(world.GetChunksX(), 0).lowest == -1);
+    
+    // Edits: building up, taking off the top, digging a column out
+    int x = 20, z = 17;
+    int top = world.GetColumnHeight(x, z);
+    world.SetBlock(x, top + 5, z, World::Block(World::BlockType::Stone));
+    assert(world.GetColumnHeight(x, z) == top + 5);
+    world.SetBlock(x, top + 2, z, World::Block(World::BlockType::Stone));
+    assert(world.GetColumnHeight(x, z) == top + 5);
+    world.SetBlock(x, top + 5, z, World::Block(World::BlockType::Air));
+    assert(world.GetColumnHeight(x, z) == top + 2);
+    world.SetBlock(x, top + 2, z, World::Block(World::BlockType::Air));
+    assert(world.GetColumnHeight(x, z) == ScanColumnHeight(world, x, z));
+    for (int y = 0; y < h; ++y) world.SetBlock(x, y, z, World::Block(World::BlockType::Air));
+    assert(world.GetColumnHeight(x, z) == -1 && world.GetSurfaceLevel(x, z) == 0);
+    assert(world.GetChunkColumnHeights(x >> World::CHUNK_SHIFT, z >> World::CHUNK_SHIFT).lowest == -1);
+    world.SetBlock(x, h - 1, z, World::Block(World::BlockType::Gold));
+    assert(world.GetChunkColumnHeights(x >> World::CHUNK_SHIFT, z >> World::CHUNK_SHIFT).highest == h - 1);
+    CheckColumnHeights(world);
+    
+    // Random edits, on the eager world and on the lazy one (where they
+    // make chunks resident)
+    World::VoxelRandom random(77);
+    for (World::World* edited : { &world, &lazy }) {
+        for (int i = 0; i < 3000; ++i) {
+            int ex = static_cast<int>(random.Below(i, 0, 0, w));
+            int ez = static_cast<int>(random.Below(i, 1, 0, d));
+            int ey = edited->GetColumnHeight(ex, ez) + static_cast<int>(random.Below(i, 2, 0, 6)) - 3;
+            World::BlockType type = random.Below(i, 3, 0, 2) ? World::BlockType::Air : World::BlockType::Stone;
+            edited->SetBlock(ex, std::clamp(ey, 0, h - 1), ez, World::Block(type));
+        }
+        CheckColumnHeights(*edited);
+    }
+    
+    // Regenerating a chunk, regenerating the world and clearing it
+    world.RegenerateChunk({ 1, 3, 1 });
+    world.RegenerateChunk({ 1, 2, 1 });
+    CheckColumnHeights(world);
+    world.Generate(9);
+    CheckColumnHeights(world);
+    world.Clear();
+    assert(world.GetColumnHeight(x, z) == -1);
+    assert(world.GetChunkColumnHeights(0, 0).highest == -1);
+    
+    std::cout << "✓ Cached heights match full column scans through edits" << std::endl;
+}
+
+// Scratch file for save tests
+std::string SavePath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<char> ReadFileBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void WriteFileBytes(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+// Same bounds and the same block everywhere
+bool SameBlocks(const World::World& a, const World::World& b) {
+    if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() || a.GetDepth() != b.GetDepth()) return false;
+    for (int y = 0; y < a.GetHeight(); ++y)
+        for (int z = 0; z < a.GetDepth(); ++z)
+            for (int x = 0; x < a.GetWidth(); ++x)
+                if (a.GetBlockType(x, y, z) != b.GetBlockType(x, y, z)) return false;
+    return true;
+}
+
+void TestSaveLoad() {
+    std::cout << "Testing Save/Load..." << std::endl;
+    std::string path = SavePath("world_test_save.vxw");
+    
+    // Eager solid cube with edits, as a snapshot: every chunk is saved,
+    // none is decoded by Load, and reads (per block, per chunk, resident)
+    // match
+    World::World cube(40, 35, 30, 3);
+    cube.Generate();
+    cube.SetBlock(5, 34, 5, World::Block(World::BlockType::Air));
+    cube.SetBlock(20, 20, 20, World::Block(World::BlockType::Air));
+    assert(cube.Save(path, World::SaveMode::Snapshot) == World::FileStatus::Ok);
+    World::World loaded(8, 8, 8, 1);
+    assert(loaded.Load(path) == World::FileStatus::Ok);
+    assert(loaded.GetChunkCount() == 0 && loaded.IsLazy());
+    assert(loaded.GetSeed() == 3 && loaded.GetGeneratorMode() == World::GeneratorMode::SolidCube);
+    assert(loaded.GetSaveFile()->GetChunkCount() == cube.GetChunkCount());
+    assert(SameBlocks(cube, loaded));
+    std::vector<World::BlockType> expected(World::CHUNK_VOLUME), actual(World::CHUNK_VOLUME);
+    for (int cy = 0; cy < cube.GetChunksY(); ++cy)
+        for (int cz = 0; cz < cube.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < cube.GetChunksX(); ++cx) {
+                World::ChunkCoord coord{ cx, cy, cz };
+                assert(loaded.IsChunkModified(coord) == cube.IsChunkModified(coord));
+                cube.GetChunkTypes(coord, expected.data());
+                loaded.GetChunkTypes(coord, actual.data());
+                assert(expected == actual);
+                assert(loaded.LoadChunk(coord));
+            }
+    assert(loaded.GetChunkCount() == cube.GetChunkCount());
+    assert(SameBlocks(cube, loaded));
+    CheckColumnHeights(loaded);
+    
+    // Lazy terrain with custom rules: only edited chunks are written, the
+    // rest comes back from the seed
+    World::TerrainRules rules;
+    rules.caveThreshold = 0.25f;
+    rules.ores = { { World::BlockType::Silver, 2, 8.0f, 0.3f } };
+    World::World lazy(70, 60, 50, 31);
+    lazy.SetTerrainRules(rules);
+    lazy.SetGeneratorMode(World::GeneratorMode::Terrain);
+    lazy.GenerateLazily();
+    lazy.LoadChunk({ 0, 0, 0 });
+    lazy.LoadChunk({ 1, 1, 1 });
+    for (int x = 10; x < 30; ++x) {
+        lazy.SetBlock(x, lazy.GetSurfaceLevel(x, 12), 12, World::Block(World::BlockType::Gold));
+    }
+    lazy.SetBlock(69, 59, 49, World::Block(World::BlockType::Stone));
+    assert(lazy.Save(path) == World::FileStatus::Ok);
+    World::World reloaded;
+    assert(reloaded.Load(path) == World::FileStatus::Ok);
+    size_t modified = 0;
+    for (int cy = 0; cy < lazy.GetChunksY(); ++cy)
+        for (int cz = 0; cz < lazy.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < lazy.GetChunksX(); ++cx) {
+                modified += lazy.IsChunkModified({ cx, cy, cz }) ? 1 : 0;
+            }
+    assert(reloaded.GetSaveFile()->GetChunkCount() == modified);
+    assert(reloaded.GetGeneratorMode() == World::GeneratorMode::Terrain);
+    assert(reloaded.GetTerrainRules().caveThreshold == 0.25f && reloaded.GetTerrainRules().ores.size() == 1);
+    assert(SameBlocks(lazy, reloaded));
+    CheckColumnHeights(reloaded);
+    
+    // Worker threads read saved chunks through the source copy
+    std::shared_ptr<const World::World> source = reloaded.CopySource();
+    World::ChunkCoord savedChunk = World::ChunkCoordOf(20, lazy.GetSurfaceLevel(20, 12), 12);
+    lazy.GetChunkTypes(savedChunk, expected.data());
+    source->GetChunkTypes(savedChunk, actual.data());
+    assert(expected == actual);
+    
+    // Saving the loaded world over its own file after more edits keeps the
+    // chunks it never touched; regenerating a saved chunk drops its edits
+    reloaded.SetBlock(1, 1, 1, World::Block(World::BlockType::Air));
+    lazy.SetBlock(1, 1, 1, World::Block(World::BlockType::Air));
+    World::ChunkCoord cornerChunk = World::ChunkCoordOf(69, 59, 49);
+    reloaded.RegenerateChunk(cornerChunk);
+    lazy.RegenerateChunk(cornerChunk);
+    assert(!reloaded.UnloadChunk(cornerChunk));  // the saved copy still has edits
+    assert(reloaded.Save(path) == World::FileStatus::Ok);
+    World::World again;
+    assert(again.Load(path, true) == World::FileStatus::Ok);
+    assert(SameBlocks(lazy, again));
+    
+    // Clearing or regenerating forgets the file
+    again.Clear();
+    assert(again.GetSaveFile() == nullptr && again.GetBlockType(1, 1, 1) == World::BlockType::Air);
+    
+    std::remove(path.c_str());
+    std::cout << "✓ Eager and lazy worlds round-trip, " << cube.GetChunkCount() << " chunks mapped without decoding" << std::endl;
+}
+
+void TestSaveFileCorruption() {
+    std::cout << "Testing Save File Corruption..." << std::endl;
+    std::string path = SavePath("world_test_corrupt.vxw");
+    std::string damaged = SavePath("world_test_damaged.vxw");
+    
+    World::World world(40, 35, 30, 8);
+    world.Generate();
+    assert(world.Save(path, World::SaveMode::Snapshot) == World::FileStatus::Ok);
+    const std::vector<char> good = ReadFileBytes(path);
+    
+    // A failed load leaves the world alone
+    World::World target(20, 20, 20, 99);
+    target.Generate();
+    auto load = [&](const std::vector<char>& bytes, bool verify = false) {
+        WriteFileBytes(damaged, bytes);
+        return target.Load(damaged, verify);
+    };
+    
+    assert(target.Load(SavePath("world_test_missing.vxw")) == World::FileStatus::OpenFailed);
+    assert(load(std::vector<char>(100, 'x')) == World::FileStatus::NotAWorldFile);
+    assert(load(std::vector<char>()) == World::FileStatus::NotAWorldFile);
+    std::vector<char> bytes = good;
+    bytes.resize(good.size() - 1);
+    assert(load(bytes) == World::FileStatus::Corrupt);
+    bytes.resize(20);
+    assert(load(bytes) == World::FileStatus::Corrupt);
+    bytes = good;
+    bytes.push_back(0);
+    assert(load(bytes) == World::FileStatus::Corrupt);
+    bytes = good;
+    bytes[4] = World::WorldFile::VERSION + 1;  // version
+    assert(load(bytes) == World::FileStatus::UnsupportedVersion);
+    bytes = good;
+    bytes[8] ^= 0x40;  // chunk size
+    assert(load(bytes) == World::FileStatus::Incompatible);
+    bytes = good;
+    bytes[24] ^= 1;  // seed
+    assert(load(bytes) == World::FileStatus::Corrupt);
+    bytes = good;
+    bytes[good.size() - 20] ^= 1;  // last directory entry
+    assert(load(bytes) == World::FileStatus::Corrupt);
+    assert(target.GetWidth() == 20 && target.GetSeed() == 99 && target.GetSaveFile() == nullptr);
+    
+    // A damaged payload is only found when read (or when verifying up
+    // front); that chunk alone reads as air. The payloads sit between the
+    // header (and rules) and the directory of 32-byte entries at the end.
+    World::World probe;
+    assert(probe.Load(path) == World::FileStatus::Ok);
+    size_t directory = good.size() - 32 * probe.GetSaveFile()->GetChunkCount();
+    bytes = good;
+    bytes[(64 + directory) / 2] ^= 0x10;
+    assert(load(bytes, true) == World::FileStatus::Corrupt);
+    assert(target.GetWidth() == 20);
+    assert(load(bytes) == World::FileStatus::Ok);
+    assert(target.GetSaveFile()->CountCorruptChunks() == 1);
+    int damagedChunks = 0;
+    std::vector<World::BlockType> expected(World::CHUNK_VOLUME), actual(World::CHUNK_VOLUME);
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, expected.data());
+                target.GetChunkTypes({ cx, cy, cz }, actual.data());
+                if (expected == actual) continue;
+                ++damagedChunks;
+                for (World::BlockType type : actual) assert(type == World::BlockType::Air);
+            }
+    assert(damagedChunks == 1);
+    
+    std::remove(path.c_str());
+    std::remove(damaged.c_str());
+    std::cout << "✓ Truncation, bad headers and damaged chunks are caught" << std::endl;
+}
+
+void TestDeltaSave() {
+    std::cout << "Testing Delta Save..." << std::endl;
+    std::string path = SavePath("world_test_delta.vxw");
+    std::string snapshotPath = SavePath("world_test_snapshot.vxw");
+    
+    // A few edits in a lazy terrain world are stored as per-chunk changes
+    // over the generated chunks (once a chunk is big enough for a list of
+    // changes to beat its full payload)
+    const bool deltasPayOff = World::CHUNK_SIZE >= 8;
+    World::World world(80, 64, 80, 17);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.GenerateLazily();
+    World::ChunkCoord edited = World::ChunkCoordOf(3, world.GetSurfaceLevel(3, 40), 40);
+    for (int x = 3; x < 40; x += 3) {
+        world.SetBlock(x, world.GetSurfaceLevel(x, 40), 40, World::Block(World::BlockType::Air));
+    }
+    world.SetBlock(70, 63, 70, World::Block(World::BlockType::Gold));
+    assert(world.Save(path) == World::FileStatus::Ok);
+    assert(world.Save(snapshotPath, World::SaveMode::Snapshot) == World::FileStatus::Ok);
+    World::World loaded;
+    assert(loaded.Load(path, true) == World::FileStatus::Ok);
+    const World::WorldFile* file = loaded.GetSaveFile();
+    assert(file->GetInfo().lazy && file->GetChunkCount() > 0);
+    for (size_t i = 0; i < file->GetChunkCount(); ++i) {
+        assert(file->IsChunkModified(i));
+        assert(file->IsChunkDelta(i) || !deltasPayOff);
+    }
+    size_t deltaSize = file->GetSize();
+    size_t snapshotSize = ReadFileBytes(snapshotPath).size();
+    assert(deltaSize * 2 < snapshotSize || !deltasPayOff);
+    assert(SameBlocks(world, loaded));
+    CheckColumnHeights(loaded);
+    
+    // Single reads, whole chunks and worker copies apply the changes too
+    std::shared_ptr<const World::World> source = loaded.CopySource();
+    assert(source->GetBlockType(70, 63, 70) == World::BlockType::Gold);
+    std::vector<World::BlockType> expected(World::CHUNK_VOLUME), actual(World::CHUNK_VOLUME);
+    world.GetChunkTypes(edited, expected.data());
+    source->GetChunkTypes(edited, actual.data());
+    assert(expected == actual);
+    
+    // A chunk filled by hand is compacted into a full snapshot, and an
+    // edit that is undone leaves its chunk out of the file
+    const int size = World::CHUNK_SIZE;
+    World::ChunkCoord filledChunk = World::ChunkCoordOf(size, 0, size);
+    for (int y = 0; y < std::min(size, 64); ++y)
+        for (int z = size; z < std::min(2 * size, 80); ++z)
+            for (int x = size; x < std::min(2 * size, 80); ++x) {
+                loaded.SetBlock(x, y, z, World::Block(World::BlockType::Gold));
+                world.SetBlock(x, y, z, World::Block(World::BlockType::Gold));
+            }
+    World::ChunkCoord undone = World::ChunkCoordOf(70, 5, 10);
+    World::BlockType original = loaded.GetBlockType(70, 5, 10);
+    loaded.SetBlock(70, 5, 10, World::Block(World::BlockType::Silver));
+    loaded.SetBlock(70, 5, 10, World::Block(original));
+    assert(loaded.IsChunkModified(undone));
+    assert(loaded.Save(path) == World::FileStatus::Ok);
+    World::World again;
+    assert(again.Load(path) == World::FileStatus::Ok);
+    file = again.GetSaveFile();
+    size_t filled = file->Find(filledChunk);
+    assert(filled != World::WorldFile::NOT_FOUND && !file->IsChunkDelta(filled) && file->IsChunkModified(filled));
+    assert(file->Find(undone) == World::WorldFile::NOT_FOUND);
+    assert(file->Find(edited) != World::WorldFile::NOT_FOUND);
+    assert(file->IsChunkDelta(file->Find(edited)) || !deltasPayOff);
+    assert(SameBlocks(world, again));
+    CheckColumnHeights(again);
+    
+    // An eager world that was generated in full saves as deltas as well;
+    // a cleared one has no seed to diff against and falls back to a
+    // snapshot
+    World::World cube(40, 35, 30, 3);
+    cube.Generate();
+    cube.SetBlock(20, 20, 20, World::Block(World::BlockType::Air));
+    assert(cube.Save(path) == World::FileStatus::Ok);
+    assert(again.Load(path) == World::FileStatus::Ok);
+    assert(again.GetSaveFile()->GetChunkCount() == 1);
+    assert(again.GetSaveFile()->IsChunkDelta(0) || !deltasPayOff);
+    assert(SameBlocks(cube, again));
+    cube.Clear();
+    cube.SetBlock(1, 2, 3, World::Block(World::BlockType::Stone));
+    assert(cube.Save(path) == World::FileStatus::Ok);
+    assert(again.Load(path) == World::FileStatus::Ok);
+    assert(!again.GetSaveFile()->GetInfo().lazy && !again.GetSaveFile()->IsChunkDelta(0));
+    assert(SameBlocks(cube, again));
+    
+    std::remove(path.c_str());
+    std::remove(snapshotPath.c_str());
+    std::cout << "✓ " << deltaSize << " byte delta vs " << snapshotSize << " byte snapshot, heavy edits compacted" << std::endl;
+}
+
+void TestAutoSave() {
+    std::cout << "Testing Auto Save..." << std::endl;
+    std::string path = SavePath("world_test_autosave.vxw");
+    
+    // Chunk copies share the index array until one is written to
+    World::Chunk original(World::BlockType::Stone);
+    original.Set(1, 1, 1, World::BlockType::Gold);
+    World::Chunk copy = original;
+    assert(original.SharesIndices() && copy.SharesIndices());
+    original.Set(1, 1, 1, World::BlockType::Silver);
+    assert(!original.SharesIndices() && !copy.SharesIndices());
+    assert(copy.Get(1, 1, 1) == World::BlockType::Gold && original.Get(1, 1, 1) == World::BlockType::Silver);
+    
+    // The first save captures the chunks edited since generation; the
+    // world keeps changing while it is written, and the file holds the
+    // world as it was at the capture
+    World::World world(80, 64, 80, 23);
+    world.SetGeneratorMode(World::GeneratorMode::Terrain);
+    world.GenerateLazily();
+    for (int x = 0; x < 80; x += 10) {
+        world.SetBlock(x, world.GetSurfaceLevel(x, 5), 5, World::Block(World::BlockType::Gold));
+    }
+    size_t edited = world.GetUnsavedChunkCount();
+    assert(edited > 0);
+    World::AutoSaver saver(path);
+    World::SaveStats stats;
+    assert(!saver.Poll(world, stats));
+    assert(saver.Save(world) && saver.IsBusy() && world.GetUnsavedChunkCount() == 0);
+    assert(!saver.Save(world));  // one save at a time
+    int surface = world.GetSurfaceLevel(0, 5);
+    world.SetBlock(0, surface, 5, World::Block(World::BlockType::Silver));
+    assert(world.GetUnsavedChunkCount() == 1);
+    assert(saver.Finish(world, stats) && !saver.IsBusy() && saver.GetSaveCount() == 1);
+    assert(stats.status == World::FileStatus::Ok && stats.incremental);
+    assert(stats.chunksCaptured == edited && stats.chunksWritten == edited && stats.chunksCarried == 0);
+    assert(stats.bytesWritten == ReadFileBytes(path).size() && stats.wallMs >= stats.captureMs);
+    World::World loaded;
+    assert(loaded.Load(path) == World::FileStatus::Ok);
+    assert(loaded.GetBlockType(0, surface, 5) == World::BlockType::Gold);
+    assert(world.GetSaveFile() != nullptr && world.GetSaveFile()->GetChunkCount() == edited);
+    
+    // The next save encodes only the chunk changed since and carries the
+    // rest over from the adopted file
+    assert(saver.Save(world));
+    assert(saver.Finish(world, stats) && stats.status == World::FileStatus::Ok);
+    assert(stats.incremental && stats.chunksWritten == 1 && stats.chunksCarried == edited - 1);
+    assert(loaded.Load(path, true) == World::FileStatus::Ok);
+    assert(SameBlocks(world, loaded));
+    
+    // A failed save counts its chunks as unsaved again
+    bool solid = world.GetBlockType(40, 30, 40) != World::BlockType::Air;
+    world.SetBlock(40, 30, 40, World::Block(solid ? World::BlockType::Air : World::BlockType::Stone));
+    World::AutoSaver failing(SavePath("world_test_missing_dir") + "/autosave.vxw");
+    assert(failing.Save(world) && world.GetUnsavedChunkCount() == 0);
+    assert(failing.Finish(world, stats) && stats.status == World::FileStatus::WriteFailed);
+    assert(world.GetUnsavedChunkCount() == 1);
+    assert(saver.Save(world) && saver.Finish(world, stats) && stats.chunksWritten == 1);
+    assert(loaded.Load(path) == World::FileStatus::Ok && SameBlocks(world, loaded));
+    
+    // An eager snapshot needs every chunk the first time, then only the
+    // changed ones
+    World::World cube(40, 35, 30, 4);
+    cube.Generate();
+    World::AutoSaver cubeSaver(path, World::SaveMode::Snapshot);
+    assert(cubeSaver.Save(cube) && cubeSaver.Finish(cube, stats));
+    assert(!stats.incremental && stats.chunksWritten == cube.GetChunkCount());
+    cube.SetBlock(3, 3, 3, World::Block(World::BlockType::Air));
+    assert(cubeSaver.Save(cube) && cubeSaver.Finish(cube, stats));
+    assert(stats.incremental && stats.chunksWritten == 1 && stats.chunksCarried == cube.GetChunkCount() - 1);
+    assert(loaded.Load(path) == World::FileStatus::Ok && SameBlocks(cube, loaded));
+    
+    // A save captured before the world was replaced is not adopted
+    cube.SetBlock(4, 4, 4, World::Block(World::BlockType::Air));
+    assert(cubeSaver.Save(cube));
+    cube.GenerateLazily();
+    assert(cubeSaver.Finish(cube, stats) && cube.GetSaveFile() == nullptr);
+    
+    std::remove(path.c_str());
+    std::cout << "✓ Background saves capture " << edited << " chunks, then only what changed since" << std::endl;
+}
+
+// Visible faces of a world, chunk by chunk through the mesher's culling
+size_t CountMesherFaces(const World::World& world) {
+    std::vector<World::BlockType> local(World::CHUNK_VOLUME), padded(World::PADDED_CHUNK_VOLUME);
+    size_t faces = 0;
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, local.data());
+                World::FillPaddedChunk(world, { cx, cy, cz }, local.data(), padded.data());
+                faces += World::CountVisibleFaces(padded.data());
+            }
+    return faces;
+}
+
+// Store matches the world block for block, in its runs, statistics,
+// faces, chunks and column tops
+void CheckColumnStore(const World::World& world, const World::ColumnStore& store) {
+    for (int z = 0; z < world.GetDepth(); ++z)
+        for (int x = 0; x < world.GetWidth(); ++x) {
+            int y = 0;
+            World::BlockType previous = World::BlockType::Air;
+            store.ForEachRun(x, z, [&](const World::BlockRun& run) {
+                assert(run.begin == y && run.Size() > 0 && (y == 0 || run.type != previous));
+                for (; y < run.end; ++y) assert(world.GetBlockType(x, y, z) == run.type);
+                previous = run.type;
+            });
+            assert(y == world.GetHeight());
+            assert(store.GetColumnTop(x, z) == world.GetColumnHeight(x, z));
+        }
+    
+    World::BlockStatistics expected = world.ComputeStatistics();
+    World::BlockStatistics actual = store.ComputeStatistics();
+    assert(actual.counts == expected.counts && actual.shellCounts == expected.shellCounts);
+    assert(actual.interiorCounts == expected.interiorCounts && actual.layerCounts == expected.layerCounts);
+    assert(store.CountVisibleFaces() == CountMesherFaces(world));
+    
+    std::vector<World::BlockType> chunk(World::CHUNK_VOLUME), fromRuns(World::CHUNK_VOLUME);
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, chunk.data());
+                store.GetChunkTypes({ cx, cy, cz }, fromRuns.data());
+                assert(chunk == fromRuns);
+            }
+}
+
+void TestColumnStore() {
+    std::cout << "Testing Column Store..." << std::endl;
+    
+    // Solid cube: blocks are drawn per voxel, so runs are short
+    World::World cube(40, 35, 30, 6);
+    cube.Generate();
+    World::ColumnStore cubeRuns = World::ColumnStore::FromWorld(cube);
+    CheckColumnStore(cube, cubeRuns);
+    
+    // Lazy terrain (chunks generated as the store reads them), then edits
+    // that split, extend and merge runs, mirrored in the world
+    World::World terrain(70, 60, 50, 41);
+    terrain.SetGeneratorMode(World::GeneratorMode::Terrain);
+    terrain.GenerateLazily();
+    World::ColumnStore runs = World::ColumnStore::FromWorld(terrain);
+    CheckColumnStore(terrain, runs);
+    size_t generatedRuns = runs.GetRunCount();
+    assert(generatedRuns * 10 < static_cast<size_t>(70) * 60 * 50);
+    
+    std::mt19937 rng(12);
+    const World::BlockType types[] = { World::BlockType::Air, World::BlockType::Stone, World::BlockType::Gold };
+    for (int i = 0; i < 4000; ++i) {
+        int x = static_cast<int>(rng() % 70), z = static_cast<int>(rng() % 50);
+        int y = static_cast<int>(rng() % 60);
+        World::BlockType type = types[rng() % 3];
+        // Vertical strokes, so neighbouring edits land in the same runs
+        for (int dy = 0; dy < 3 && y + dy < 60; ++dy) {
+            runs.SetBlock(x, y + dy, z, type);
+            terrain.SetBlock(x, y + dy, z, World::Block(type));
+        }
+    }
+    runs.SetBlock(-1, 0, 0, World::BlockType::Gold);
+    runs.SetBlock(0, 60, 0, World::BlockType::Gold);
+    assert(runs.GetBlockType(-1, 0, 0) == World::BlockType::Air && runs.GetBlockType(0, 60, 0) == World::BlockType::Air);
+    CheckColumnStore(terrain, runs);
+    
+    // Filling a column and clearing it again collapses it to one run
+    for (int y = 0; y < 60; ++y) runs.SetBlock(7, y, 7, World::BlockType::Silver);
+    assert(runs.GetRunCount(7, 7) == 1 && runs.GetColumnTop(7, 7) == 59);
+    for (int y = 59; y >= 0; --y) runs.SetBlock(7, y, 7, World::BlockType::Air);
+    assert(runs.GetRunCount(7, 7) == 1 && runs.GetColumnTop(7, 7) == -1);
+    
+    // Whole chunks spliced into the columns, mirrored in the world (as is
+    // the cleared column)
+    for (int y = 0; y < 60; ++y) terrain.SetBlock(7, y, 7, World::Block(World::BlockType::Air));
+    std::vector<World::BlockType> chunk(World::CHUNK_VOLUME);
+    for (int i = 0; i < 20; ++i) {
+        World::ChunkCoord coord = { static_cast<int>(rng() % terrain.GetChunksX()), static_cast<int>(rng() % terrain.GetChunksY()),
+                                    static_cast<int>(rng() % terrain.GetChunksZ()) };
+        for (World::BlockType& type : chunk) type = types[rng() % 3];
+        runs.SetChunkTypes(coord, chunk.data());
+        World::VoxelBox box = World::VoxelBox::OfChunk(coord).Intersect({ 0, 0, 0, 70, 60, 50 });
+        for (int y = box.minY; y < box.maxY; ++y)
+            for (int z = box.minZ; z < box.maxZ; ++z)
+                for (int x = box.minX; x < box.maxX; ++x)
+                    terrain.SetBlock(x, y, z, World::Block(chunk[World::LocalIndex(x - box.minX, y - box.minY, z - box.minZ)]));
+    }
+    CheckColumnStore(terrain, runs);
+    
+    // Run ends are 16-bit: taller stores are clamped rather than wrapping
+    World::ColumnStore tall(1, World::ColumnStore::MAX_HEIGHT + 100, 1, World::BlockType::Stone);
+    assert(tall.GetHeight() == World::ColumnStore::MAX_HEIGHT && tall.GetColumnTop(0, 0) == World::ColumnStore::MAX_HEIGHT - 1);
+    assert(tall.GetBlockType(0, World::ColumnStore::MAX_HEIGHT, 0) == World::BlockType::Air);
+    
+    // A world with the column run index counts from its runs and keeps
+    // them current through edits and regenerated chunks
+    World::World columns(70, 60, 50, 41);
+    columns.SetGeneratorMode(World::GeneratorMode::Terrain);
+    columns.GenerateLazily();
+    columns.SetColumnRunIndex(true);
+    assert(columns.GetColumnRunIndexMemoryUsage() == 0);
+    auto checkIndex = [&]() {
+        World::BlockStatistics fromRuns = columns.ComputeStatistics();
+        size_t runFaces = columns.CountVisibleFaces();
+        assert(columns.GetColumnRunIndexMemoryUsage() > 0);
+        columns.SetColumnRunIndex(false);
+        World::BlockStatistics fromChunks = columns.ComputeStatistics();
+        assert(fromRuns.counts == fromChunks.counts && fromRuns.interiorCounts == fromChunks.interiorCounts);
+        assert(fromRuns.layerCounts == fromChunks.layerCounts);
+        assert(runFaces == columns.CountVisibleFaces() && runFaces == CountMesherFaces(columns));
+        columns.SetColumnRunIndex(true);
+    };
+    checkIndex();
+    columns.ComputeStatistics();
+    for (int x = 5; x < 40; ++x) columns.SetBlock(x, 30, 20, World::Block(World::BlockType::Gold));
+    columns.SetBlock(0, 0, 0, World::Block(World::BlockType::Air));
+    columns.RegenerateChunk(World::ChunkCoordOf(20, 30, 20));
+    World::BlockStatistics edited = columns.ComputeStatistics();
+    columns.SetColumnRunIndex(false);
+    assert(edited.layerCounts == columns.ComputeStatistics().layerCounts);
+    columns.SetColumnRunIndex(true);
+    checkIndex();
+    
+    std::cout << "✓ " << cubeRuns.GetRunCount() << " runs for " << 40 * 35 * 30 << " cube voxels, "
+              << generatedRuns << " for the terrain; reads, edits, stats and faces match" << std::endl;
+}
+
+// Octree matches the world block for block and chunk for chunk
+void CheckOctree(const World::World& world, const World::VoxelOctree& tree) {
+    for (int y = 0; y < world.GetHeight(); ++y)
+        for (int z = 0; z < world.GetDepth(); ++z)
+            for (int x = 0; x < world.GetWidth(); ++x)
+                assert(tree.GetBlockType(x, y, z) == world.GetBlockType(x, y, z));
+    
+    std::vector<World::BlockType> chunk(World::CHUNK_VOLUME), fromTree(World::CHUNK_VOLUME);
+    for (int cy = 0; cy < world.GetChunksY(); ++cy)
+        for (int cz = 0; cz < world.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < world.GetChunksX(); ++cx) {
+                world.GetChunkTypes({ cx, cy, cz }, chunk.data());
+                tree.GetChunkTypes({ cx, cy, cz }, fromTree.data());
+                assert(chunk == fromTree);
+            }
+}
+
+// Region queries agree with reading the box block by block
+void CheckOctreeRegion(const World::VoxelOctree& tree, const World::VoxelBox& box) {
+    World::VoxelBox clipped = box.Intersect({ 0, 0, 0, tree.GetWidth(), tree.GetHeight(), tree.GetDepth() });
+    uint8_t contents = World::REGION_EMPTY;
+    bool uniform = true;
+    World::BlockType first = World::BlockType::Air;
+    for (int z = clipped.minZ; z < clipped.maxZ; ++z)
+        for (int y = clipped.minY; y < clipped.maxY; ++y)
+            for (int x = clipped.minX; x < clipped.maxX; ++x) {
+                World::BlockType type = tree.GetBlockType(x, y, z);
+                if (contents == World::REGION_EMPTY) first = type;
+                uniform = uniform && type == first;
+                contents |= type == World::BlockType::Air ? World::REGION_AIR : World::REGION_SOLID;
+            }
+    assert(tree.GetRegionContents(box) == contents);
+    World::BlockType type;
+    assert(tree.IsRegionUniform(box, &type) == (contents != World::REGION_EMPTY && uniform));
+    assert(!uniform || contents == World::REGION_EMPTY || type == first);
+    
+    int64_t volume = 0;
+    tree.ForEachRegion(box, [&](const World::VoxelBox& region, World::BlockType regionType) {
+        assert(!region.IsEmpty() && clipped.Contains(region));
+        volume += region.GetVolume();
+        assert(tree.GetBlockType(region.minX, region.minY, region.minZ) == regionType);
+        assert(tree.GetBlockType(region.maxX - 1, region.maxY - 1, region.maxZ - 1) == regionType);
+    });
+    assert(volume == clipped.GetVolume());
+}
+
+void TestVoxelOctree() {
+    std::cout << "Testing Voxel Octree..." << std::endl;
+    
+    // Solid cube (every voxel its own leaf) and lazy terrain
+    World::World cube(40, 35, 30, 6);
+    cube.Generate();
+    CheckOctree(cube, World::VoxelOctree::FromWorld(cube));
+    
+    // Eight chunks tall, so the top row of chunks is always above the
+    // hills (at most 0.85 of the height); edges off the chunk grid. Tiny
+    // chunks are measured in 8-block units, so the hills span enough
+    // blocks for uniform regions to form.
+    const int unit = std::max(World::CHUNK_SIZE, 8);
+    const int W = unit * 4 + 6, H = unit * 8, D = unit * 3 + 2;
+    World::World terrain(W, H, D, 41);
+    terrain.SetGeneratorMode(World::GeneratorMode::Terrain);
+    terrain.GenerateLazily();
+    World::VoxelOctree tree = World::VoxelOctree::FromWorld(terrain);
+    CheckOctree(terrain, tree);
+    size_t generatedNodes = tree.GetNodeCount();
+    int rootSize = 1;
+    while (rootSize < H) rootSize <<= 1;
+    assert(tree.GetRootSize() == rootSize && (1 << tree.GetLevels()) == rootSize);
+    assert(generatedNodes * 4 < static_cast<size_t>(W) * H * D);
+    
+    // The sky above the terrain is air; below it there is some rock
+    int top = 0;
+    for (int z = 0; z < D; ++z)
+        for (int x = 0; x < W; ++x) top = std::max(top, terrain.GetColumnHeight(x, z));
+    assert(top < H - World::CHUNK_SIZE);
+    assert(tree.IsRegionAir({ 0, top + 1, 0, W, H, D }));
+    assert(tree.GetRegionContents({ 0, 0, 0, W, top + 1, D }) != World::REGION_AIR);
+    assert(tree.GetRegionContents({ W, 0, 0, W + 20, 10, 10 }) == World::REGION_EMPTY);
+    
+    // Chunks the tree reports all air, or solid with solid neighbours, have
+    // no faces to mesh
+    std::vector<World::BlockType> local(World::CHUNK_VOLUME), padded(World::PADDED_CHUNK_VOLUME);
+    int skipped = 0;
+    for (int cy = 0; cy < terrain.GetChunksY(); ++cy)
+        for (int cz = 0; cz < terrain.GetChunksZ(); ++cz)
+            for (int cx = 0; cx < terrain.GetChunksX(); ++cx) {
+                World::VoxelBox box = World::VoxelBox::OfChunk({ cx, cy, cz });
+                World::VoxelBox around = box.Expand(1);
+                bool inside = around.minX >= 0 && around.minY >= 0 && around.minZ >= 0 &&
+                              around.maxX <= W && around.maxY <= H && around.maxZ <= D;
+                if (!tree.IsRegionAir(box) && !(inside && tree.IsRegionSolid(around))) continue;
+                terrain.GetChunkTypes({ cx, cy, cz }, local.data());
+                World::FillPaddedChunk(terrain, { cx, cy, cz }, local.data(), padded.data());
+                assert(World::CountVisibleFaces(padded.data()) == 0);
+                ++skipped;
+            }
+    assert(skipped >= terrain.GetChunksX() * terrain.GetChunksZ());  // at least the sky row
+    
+    // Edits mirrored in the world, then region queries over random boxes
+    std::mt19937 rng(25);
+    const World::BlockType types[] = { World::BlockType::Air, World::BlockType::Stone, World::BlockType::Gold };
+    for (int i = 0; i < 4000; ++i) {
+        int x = static_cast<int>(rng() % W), y = static_cast<int>(rng() % H), z = static_cast<int>(rng() % D);
+        World::BlockType type = types[rng() % 3];
+        tree.SetBlock(x, y, z, type);
+        terrain.SetBlock(x, y, z, World::Block(type));
+    }
+    tree.SetBlock(-1, 0, 0, World::BlockType::Gold);
+    tree.SetBlock(0, H, 0, World::BlockType::Gold);
+    assert(tree.GetBlockType(-1, 0, 0) == World::BlockType::Air && tree.GetBlockType(0, H, 0) == World::BlockType::Air);
+    CheckOctree(terrain, tree);
+    for (int i = 0; i < 200; ++i) {
+        int x = static_cast<int>(rng() % (W + 10)) - 5, y = static_cast<int>(rng() % (H + 10)) - 5,
+            z = static_cast<int>(rng() % (D + 10)) - 5;
+        CheckOctreeRegion(tree, { x, y, z, x + 1 + static_cast<int>(rng() % 24), y + 1 + static_cast<int>(rng() % 24),
+                                  z + 1 + static_cast<int>(rng() % 24) });
+    }
+    
+    // Fills over unaligned boxes, mirrored block by block
+    for (int i = 0; i < 30; ++i) {
+        int x = static_cast<int>(rng() % W), y = static_cast<int>(rng() % H), z = static_cast<int>(rng() % D);
+        World::VoxelBox box = { x, y, z, x + 1 + static_cast<int>(rng() % 30), y + 1 + static_cast<int>(rng() % 30),
+                                z + 1 + static_cast<int>(rng() % 30) };
+        World::BlockType type = types[rng() % 3];
+        tree.FillRegion(box, type);
+        World::VoxelBox clipped = box.Intersect({ 0, 0, 0, W, H, D });
+        for (int bz = clipped.minZ; bz < clipped.maxZ; ++bz)
+            for (int by = clipped.minY; by < clipped.maxY; ++by)
+                for (int bx = clipped.minX; bx < clipped.maxX; ++bx) terrain.SetBlock(bx, by, bz, World::Block(type));
+        assert(tree.IsRegionUniform(box) && tree.GetRegionContents(box) == (type == World::BlockType::Air ? World::REGION_AIR : World::REGION_SOLID));
+    }
+    CheckOctree(terrain, tree);
+    
+    // Filling the world with one type, block by block or at once, collapses
+    // it to the root
+    tree.FillRegion({ -10, -10, -10, W + 10, H + 10, D + 10 }, World::BlockType::Stone);
+    assert(tree.GetNodeCount() == 1 && tree.IsRegionSolid({ 0, 0, 0, W, H, D }));
+    World::VoxelOctree small(20, 20, 20);
+    for (int z = 0; z < 20; ++z)
+        for (int y = 0; y < 20; ++y)
+            for (int x = 0; x < 20; ++x) small.SetBlock(x, y, z, World::BlockType::Silver);
+    assert(small.GetNodeCount() == 1 && small.IsRegionSolid({ 0, 0, 0, 20, 20, 20 }));
+    small.FillRegion({ 0, 0, 0, 20, 20, 20 }, World::BlockType::Air);
+    assert(small.GetNodeCount() == 1 && small.IsRegionAir({ 0, 0, 0, 32, 32, 32 }));
+
+    // The world's resident chunk region index follows edits, loads and
+    // unloads; a chunk it reports hidden meshes to nothing
+    World::World indexed(World::CHUNK_SIZE * 2, World::CHUNK_SIZE * 8, World::CHUNK_SIZE * 2, 9);
+    indexed.SetGeneratorMode(World::GeneratorMode::Terrain);
+    indexed.GenerateLazily();
+    World::ChunkCoord sky = { 0, indexed.GetChunksY() - 1, 0 };
+    assert(!indexed.IsChunkEmpty(sky));  // not loaded yet, so not known
+    indexed.LoadChunk(sky);
+    assert(indexed.IsChunkEmpty(sky) && indexed.IsChunkHidden(sky));
+    int sx = 1, sy = (indexed.GetChunksY() - 1) * World::CHUNK_SIZE + 1, sz = 1;
+    indexed.SetBlock(sx, sy, sz, World::Block(World::BlockType::Gold));
+    assert(!indexed.IsChunkEmpty(sky) && !indexed.IsChunkHidden(sky));
+    assert(indexed.GetResidentContents({ sx, sy, sz, sx + 1, sy + 1, sz + 1 }) == World::REGION_SOLID);
+    World::ChunkMeshData skyMesh;
+    World::BuildChunkMesh(indexed, sky, skyMesh);
+    assert(!skyMesh.IsEmpty());
+    indexed.SetBlock(sx, sy, sz, World::Block(World::BlockType::Air));
+    assert(indexed.IsChunkEmpty(sky));
+    World::BuildChunkMesh(indexed, sky, skyMesh);
+    assert(skyMesh.IsEmpty());
+    World::ChunkCoord nextSky = { 1, sky.y, 0 };
+    indexed.LoadChunk(nextSky);
+    assert(indexed.IsChunkEmpty(nextSky) && indexed.UnloadChunk(nextSky) && !indexed.IsChunkEmpty(nextSky));
+
+    // A solid chunk is hidden only once all of its neighbours are solid too
+    World::World solid(World::CHUNK_SIZE * 3, World::CHUNK_SIZE * 3, World::CHUNK_SIZE * 3, 9);
+    solid.Generate();
+    World::ChunkCoord middle = { 1, 1, 1 };
+    assert(solid.IsChunkHidden(middle) && !solid.IsChunkHidden({ 0, 1, 1 }));
+    solid.SetBlock(World::CHUNK_SIZE * 2, World::CHUNK_SIZE + 1, World::CHUNK_SIZE + 1, World::Block(World::BlockType::Air));
+    assert(!solid.IsChunkHidden(middle));
+
+    // Frustum visits reach every solid block a camera sees, and no air
+    World::VoxelOctree scene(64, 32, 64);
+    scene.FillRegion({ 0, 0, 0, 64, 8, 64 }, World::BlockType::Stone);
+    scene.FillRegion({ 20, 8, 20, 24, 20, 24 }, World::BlockType::Gold);
+    Camera3D camera = { { 32.0f, 20.0f, -10.0f }, { 32.0f, 5.0f, 32.0f }, { 0.0f, 1.0f, 0.0f }, 60.0f, CAMERA_PERSPECTIVE };
+    World::Frustum frustum = World::ExtractFrustum(World::CameraViewProjection(camera, 16.0f / 9.0f));
+    std::vector<uint8_t> visited(64 * 32 * 64, 0);
+    size_t regions = 0;
+    scene.ForEachVisibleRegion(frustum, [&](const World::VoxelBox& region, World::BlockType type) {
+        assert(type != World::BlockType::Air);
+        ++regions;
+        for (int z = region.minZ; z < region.maxZ; ++z)
+            for (int y = region.minY; y < region.maxY; ++y)
+                for (int x = region.minX; x < region.maxX; ++x) visited[(z * 32 + y) * 64 + x] = 1;
+    });
+    for (int z = 0; z < 64; ++z)
+        for (int y = 0; y < 32; ++y)
+            for (int x = 0; x < 64; ++x) {
+                Vector3 centre = { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+                if (scene.GetBlockType(x, y, z) != World::BlockType::Air && World::ContainsPoint(frustum, centre))
+                    assert(visited[(z * 32 + y) * 64 + x]);
+            }
+    assert(regions > 0 && regions < scene.GetNodeCount());
+    
+    std::cout << "✓ " << generatedNodes << " nodes for " << W * H * D << " terrain voxels, " << skipped
+              << " chunks skipped unmeshed; reads, edits, fills and region queries match" << std::endl;
 }
 
 int main() {
@@ -213,6 +1624,60 @@ int main() {
         TestMultipleGenerations();
         std::cout << std::endl;
         
+        TestChunkedStorage();
+        std::cout << std::endl;
+        
+        TestUniformChunks();
+        std::cout << std::endl;
+        
+        TestPaletteCompression();
+        std::cout << std::endl;
+        
+        TestDeterministicGeneration();
+        std::cout << std::endl;
+        
+        TestSeededRegeneration();
+        std::cout << std::endl;
+        
+        TestLazyGeneration();
+        std::cout << std::endl;
+        
+        TestMpscQueue();
+        std::cout << std::endl;
+        
+        TestBlockStatistics();
+        std::cout << std::endl;
+        
+        TestInteriorSpans();
+        std::cout << std::endl;
+        
+        TestBlockSampler();
+        std::cout << std::endl;
+        
+        TestTerrainGeneration();
+        std::cout << std::endl;
+        
+        TestColumnHeights();
+        std::cout << std::endl;
+        
+        TestSaveLoad();
+        std::cout << std::endl;
+        
+        TestSaveFileCorruption();
+        std::cout << std::endl;
+        
+        TestDeltaSave();
+        std::cout << std::endl;
+        
+        TestAutoSave();
+        std::cout << std::endl;
+        
+        TestColumnStore();
+        std::cout << std::endl;
+        
+        TestVoxelOctree();
+        std::cout << std::endl;
+        
         std::cout << "========================================" << std::endl;
         std::cout << "  ✓ ALL TESTS PASSED SUCCESSFULLY!" << std::endl;
         std::cout << "========================================" << std::endl;